@@ -4,6 +4,7 @@
 #include "RGBA16161616.hxx"
 #include "QRGBA.hxx"
 #include "ColorDetail.hxx"
+#include "Histogram.hxx"
 #include "Quantize.hxx"
 
 namespace Color
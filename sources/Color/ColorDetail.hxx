@@ -29,8 +29,8 @@ namespace Color::Detail
                 static_cast<VType>(std::abs(val1.a - val2.a))};
     }
 
-    template <Concept::RGBA Color>
-    size_t closestMatch(const Color &pixel, const std::vector<Color> &palette) noexcept
+    template <Concept::RGBA Color, typename Allocator>
+    size_t closestMatch(const Color &pixel, const std::vector<Color,Allocator> &palette) noexcept
     {
         using VType = decltype(Color::value);
 
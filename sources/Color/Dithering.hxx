@@ -16,14 +16,15 @@ namespace Color::Dithering
         FloydSteinberg
     };
 
-    template <Concept::RGBA Color>
-    std::vector<Color> apply(const std::vector<Color> &pixels, const std::vector<Color> &palette,
-                             const int64_t width, const int64_t height, const Algorithm alg)
-        noexcept(false)
+    // the dithered pixels come from the allocator of the given ones
+    template <Concept::RGBA Color, typename Allocator>
+    std::vector<Color,Allocator> apply(const std::vector<Color,Allocator> &pixels,
+                                       const std::vector<Color> &palette, const int64_t width,
+                                       const int64_t height, const Algorithm alg) noexcept(false)
     {
         const uint64_t psize = palette.size();
         const int32_t Max = std::numeric_limits<decltype(Color::r)>::max();
-        std::vector<Color> tpxls;
+        std::vector<Color,Allocator> tpxls(pixels.get_allocator());
 
         if (psize > 1)
             tpxls = pixels;
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "Common/Concepts.hxx"
+#include "Common/ThreadPool.hxx"
+
+namespace Color::Histogram
+{
+    //
+    // ColorTable - an open addressing hash table counting color values, linear probing on a power
+    //              of two amount of slots, it grows when three quarters of them are taken
+    //
+    // - a slot with a count of zero is free, so every value including zero can be counted
+    //
+    template <Common::Concept::UnsignedInteger Value>
+    class ColorTable {
+    public:
+        //--- public types and constants ---
+        struct Entry {
+            Value value;
+            uint64_t count;
+        };
+
+        //--- public constructors ---
+        ColorTable(const size_t capacity = 1024) noexcept(false)
+        : _slots(), _size(0), _shift(0)
+        {
+            implAllocate(std::bit_ceil(std::max<size_t>(capacity, 16)));
+        }
+
+        //--- public methods ---
+        size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        void add(const Value value, const uint64_t count = 1) noexcept(false)
+        {
+            const size_t mask = _slots.size() - 1;
+
+            for (size_t i = implHash(value); ; i = (i + 1) & mask)
+            {
+                Entry &slot = _slots[i];
+
+                if (!slot.count)
+                {
+                    slot = {value, count};
+                    if (++_size * 4 > _slots.size() * 3)
+                        implAllocate(_slots.size() * 2);
+                    return;
+                }
+
+                if (slot.value == value)
+                {
+                    slot.count += count;
+                    return;
+                }
+            }
+        }
+
+        // room for the given amount of values without growing on the way
+        void reserve(const size_t values) noexcept(false)
+        {
+            const size_t capacity = std::bit_ceil(values + values / 3 + 1);
+
+            if (capacity > _slots.size())
+                implAllocate(capacity);
+        }
+
+        // the slot a value starts probing at is fetched ahead, large tables miss the cache a lot
+        void prefetch(const Value value) const noexcept
+        {
+            __builtin_prefetch(_slots.data() + implHash(value), 1);
+        }
+
+        void merge(const ColorTable &rhs) noexcept(false)
+        {
+            for (const Entry &slot : rhs._slots)
+                if (slot.count)
+                    add(slot.value, slot.count);
+        }
+
+        std::vector<std::pair<Value,uint64_t>> counts() const noexcept(false)
+        {
+            std::vector<std::pair<Value,uint64_t>> result;
+
+            result.reserve(_size);
+            for (const Entry &slot : _slots)
+                if (slot.count)
+                    result.emplace_back(slot.value, slot.count);
+
+            return result;
+        }
+
+    protected:
+        //--- protected methods ---
+        size_t implHash(const Value value) const noexcept
+        {
+            // fibonacci hashing spreads the neighbouring colors of gradients over the table
+            return (static_cast<uint64_t>(value) * 0x9E3779B97F4A7C15ull) >> _shift;
+        }
+
+        void implAllocate(const size_t capacity) noexcept(false)
+        {
+            std::vector<Entry> old(capacity, Entry{0, 0});
+
+            old.swap(_slots);
+            _size = 0;
+            _shift = 64 - std::countr_zero(capacity);
+            for (const Entry &slot : old)
+                if (slot.count)
+                    add(slot.value, slot.count);
+        }
+
+    private:
+        //--- private properties ---
+        std::vector<Entry> _slots;
+        size_t _size;
+        int _shift;
+    };
+
+    //--- types of the results ---
+    template <Common::Concept::Class RGBA>
+    using Counts = std::vector<std::pair<decltype(RGBA::value),uint64_t>>;
+
+    // red, green, blue and alpha, one counter for every value of a channel
+    using Channels = std::array<std::vector<uint64_t>,4>;
+
+    //
+    // counts the colors of rows that are the given stride of pixels apart, every band of rows gets
+    // a table of its own and the tables are merged afterwards, runs of one color are counted
+    // before they reach a table, as most images have plenty of these
+    //
+    // - every table is sized up front from the colors of a sample of its rows, so images with a
+    //   color in almost every pixel do not rehash the table over and over again
+    // - the slot of the color some pixels ahead is prefetched while the current one is counted
+    //
+    template <Common::Concept::Class RGBA>
+    ColorTable<decltype(RGBA::value)> table(const RGBA *pixels, const int64_t width,
+                                            const int64_t height, const int64_t stride,
+                                            const int64_t threads = 1) noexcept(false)
+    {
+        using VType = decltype(RGBA::value);
+
+        if ((width < 1) || (height < 1))
+            return ColorTable<VType>();
+
+        const int64_t bands = std::clamp<int64_t>(threads, 1, height);
+        std::vector<ColorTable<VType>> tables(bands);
+
+        Common::ThreadPool::global().run(bands, [&](const int64_t band)
+        {
+            constexpr int64_t SampleStep = 16;
+            constexpr int64_t Ahead = 16;
+
+            ColorTable<VType> &table = tables[band];
+            const int64_t first = height * band / bands;
+            const int64_t last = height * (band + 1) / bands;
+            ColorTable<VType> sample;
+            int64_t sampled = 0;
+
+            for (int64_t y = first; y < last; y += SampleStep, sampled += width)
+                for (const RGBA *pixel = pixels + y * stride, *end = pixel + width; pixel < end;
+                     ++pixel)
+                    sample.add(pixel->value);
+            table.reserve(sample.size() * ((last - first) * width) / sampled);
+
+            VType current = pixels[first * stride].value;
+            uint64_t run = 0;
+
+            for (int64_t y = first; y < last; ++y)
+            {
+                const RGBA *row = pixels + y * stride;
+
+                for (const RGBA *pixel = row, *end = row + width; pixel < end; ++pixel)
+                {
+                    if (pixel + Ahead < end)
+                        table.prefetch(pixel[Ahead].value);
+                    if (pixel->value != current)
+                    {
+                        table.add(current, run);
+                        current = pixel->value;
+                        run = 0;
+                    }
+                    ++run;
+                }
+            }
+
+            if (run)
+                table.add(current, run);
+        });
+
+        // the biggest table takes in the others, it has the least new colors to learn
+        std::sort(tables.begin(), tables.end(), [](const auto &t1, const auto &t2)
+        {
+            return t1.size() > t2.size();
+        });
+        for (size_t i = 1; i < tables.size(); ++i)
+            tables.front().merge(tables[i]);
+
+        return std::move(tables.front());
+    }
+
+    template <Common::Concept::Class RGBA>
+    int64_t countColors(const RGBA *pixels, const int64_t width, const int64_t height,
+                        const int64_t stride, const int64_t threads = 1) noexcept(false)
+    {
+        return table(pixels, width, height, stride, threads).size();
+    }
+
+    // every used color with the amount of its pixels, sorted by the color value
+    template <Common::Concept::Class RGBA>
+    Counts<RGBA> colors(const RGBA *pixels, const int64_t width, const int64_t height,
+                        const int64_t stride, const int64_t threads = 1) noexcept(false)
+    {
+        Counts<RGBA> result = table(pixels, width, height, stride, threads).counts();
+
+        std::sort(result.begin(), result.end());
+
+        return result;
+    }
+
+    template <Common::Concept::Class RGBA>
+    Channels channels(const RGBA *pixels, const int64_t width, const int64_t height,
+                      const int64_t stride, const int64_t threads = 1) noexcept(false)
+    {
+        using CType = decltype(RGBA::r);
+
+        const size_t values = static_cast<size_t>(std::numeric_limits<CType>::max()) + 1;
+        const int64_t bands = std::clamp<int64_t>(threads, 1, std::max<int64_t>(height, 1));
+        std::vector<Channels> partial(bands);
+        Channels result;
+
+        for (auto &channel : result)
+            channel.assign(values, 0);
+
+        if ((width < 1) || (height < 1))
+            return result;
+
+        Common::ThreadPool::global().run(bands, [&](const int64_t band)
+        {
+            auto &[red, green, blue, alpha] = partial[band];
+
+            red.assign(values, 0);
+            green.assign(values, 0);
+            blue.assign(values, 0);
+            alpha.assign(values, 0);
+
+            for (int64_t y = height * band / bands; y < height * (band + 1) / bands; ++y)
+            {
+                for (const RGBA *pixel = pixels + y * stride, *end = pixel + width; pixel < end;
+                     ++pixel)
+                {
+                    ++red[pixel->r];
+                    ++green[pixel->g];
+                    ++blue[pixel->b];
+                    ++alpha[pixel->a];
+                }
+            }
+        });
+
+        for (auto &channels : partial)
+            for (size_t c = 0; c < result.size(); ++c)
+                for (size_t i = 0; i < values; ++i)
+                    result[c][i] += channels[c][i];
+
+        return result;
+    }
+}
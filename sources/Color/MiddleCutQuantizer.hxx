@@ -8,28 +8,23 @@
 #include "Common/Concepts.hxx"
 #include "Common/Tools.hxx"
 #include "ColorDetail.hxx"
+#include "Histogram.hxx"
 
 namespace Color::Quantize
 {
-    template <Common::Concept::Class RGBA>
-    bool middleCut(const int64_t width, const int64_t height, const int64_t colors,
-                   const std::vector<RGBA> &in_pixels, std::vector<RGBA> &out_pixels,
-                   std::vector<RGBA> &palette) noexcept(false)
+    // only builds the palette of at most the given amount of colors, an image with no more colors
+    // than that gets exactly its own colors
+    template <Common::Concept::Class RGBA, typename Allocator>
+    bool middleCutPalette(const int64_t width, const int64_t height, const int64_t colors,
+                          const RGBA *in_pixels, const int64_t in_stride,
+                          std::vector<RGBA,Allocator> &palette) noexcept(false)
     {
-        using VType = decltype(RGBA::value);
         using CType = decltype(RGBA::r);
 
-        if ((width < 1) || (height < 1))
-            return false;
-
-        if (in_pixels.size() != static_cast<size_t>(width * height))
-            return false;
-
-        if (in_pixels.size() <= static_cast<size_t>(colors))
+        if ((width < 1) || (height < 1) || (colors < 1))
             return false;
 
         std::vector<RGBA> tmp;
-        std::map<VType,size_t> tmp2;
         std::vector<std::vector<RGBA>> lists;
         size_t list_size = 0;
         CType lower_red = std::numeric_limits<CType>::max();
@@ -43,19 +38,30 @@ namespace Color::Quantize
         CType blue = 0;
         CType max = 0;
 
-        for (auto &pixel : in_pixels)
+        // the bounds of the used colors are the bounds of all pixels
+        const auto used = Histogram::colors(in_pixels, width, height, in_stride);
+
+        tmp.reserve(used.size());
+        for (auto &pair : used)
         {
-            lower_red = std::min(lower_red, pixel.r);
-            lower_green = std::min(lower_green, pixel.g);
-            lower_blue = std::min(lower_blue, pixel.b);
-            upper_red = std::max(upper_red, pixel.r);
-            upper_green = std::max(upper_green, pixel.g);
-            upper_blue = std::max(upper_blue, pixel.b);
-            ++tmp2[pixel.value];
+            const RGBA color(pair.first);
+
+            lower_red = std::min(lower_red, color.r);
+            lower_green = std::min(lower_green, color.g);
+            lower_blue = std::min(lower_blue, color.b);
+            upper_red = std::max(upper_red, color.r);
+            upper_green = std::max(upper_green, color.g);
+            upper_blue = std::max(upper_blue, color.b);
+            tmp.push_back(color);
+        }
+
+        palette.clear();
+        if (tmp.size() <= static_cast<size_t>(colors))
+        {
+            palette.assign(tmp.begin(), tmp.end());
+
+            return true;
         }
-        tmp.reserve(tmp2.size());
-        for (auto &pair : tmp2)
-            tmp.push_back(pair.first);
 
         red = upper_red - lower_red;
         green = upper_green - lower_green;
@@ -85,10 +91,91 @@ namespace Color::Quantize
         for (auto &list : lists)
             palette.push_back(list[list.size() / 2]);
 
-        out_pixels.resize(width * height);
-        for (size_t i = 0; i < in_pixels.size(); ++i)
-            out_pixels[i] = palette[Color::Detail::closestMatch(in_pixels[i], palette)];
+        return true;
+    }
+
+    // works on rows that are the given stride of pixels apart, so it also runs on a part of a
+    // bigger image, in_pixels and out_pixels may be the same rows
+    template <Common::Concept::Class RGBA, typename Allocator>
+    bool middleCut(const int64_t width, const int64_t height, const int64_t colors,
+                   const RGBA *in_pixels, const int64_t in_stride, RGBA *out_pixels,
+                   const int64_t out_stride, std::vector<RGBA,Allocator> &palette) noexcept(false)
+    {
+        if ((width * height) <= colors)
+            return false;
+
+        if (!middleCutPalette(width, height, colors, in_pixels, in_stride, palette))
+            return false;
+
+        for (int64_t y = 0; y < height; ++y)
+        {
+            const RGBA *in = in_pixels + y * in_stride;
+            RGBA *out = out_pixels + y * out_stride;
+
+            for (int64_t x = 0; x < width; ++x)
+                out[x] = palette[Color::Detail::closestMatch(in[x], palette)];
+        }
 
         return true;
     }
+
+    // hands out the position of every pixel in the palette instead of its color, so the colors
+    // have to fit into the index type, pixels of the same color are only matched once
+    template <Common::Concept::Class RGBA, Common::Concept::UnsignedInteger Index,
+              typename Allocator>
+    bool middleCutIndices(const int64_t width, const int64_t height, const int64_t colors,
+                          const RGBA *in_pixels, const int64_t in_stride, Index *out_indices,
+                          const int64_t out_stride, std::vector<RGBA,Allocator> &palette)
+        noexcept(false)
+    {
+        using VType = decltype(RGBA::value);
+
+        if (static_cast<uint64_t>(colors - 1) > std::numeric_limits<Index>::max())
+            return false;
+
+        if (!middleCutPalette(width, height, colors, in_pixels, in_stride, palette))
+            return false;
+
+        std::map<VType,Index> matches;
+
+        for (int64_t y = 0; y < height; ++y)
+        {
+            const RGBA *in = in_pixels + y * in_stride;
+            Index *out = out_indices + y * out_stride;
+
+            for (int64_t x = 0; x < width; ++x)
+            {
+                auto [it, added] = matches.try_emplace(in[x].value, 0);
+
+                if (added)
+                    it->second = static_cast<Index>(Color::Detail::closestMatch(in[x], palette));
+                out[x] = it->second;
+            }
+        }
+
+        return true;
+    }
+
+    // the vectors may use any allocator, so images with pixels of their own memory resource work
+    template <Common::Concept::Class RGBA, typename InAllocator, typename OutAllocator,
+              typename PaletteAllocator>
+    bool middleCut(const int64_t width, const int64_t height, const int64_t colors,
+                   const std::vector<RGBA,InAllocator> &in_pixels,
+                   std::vector<RGBA,OutAllocator> &out_pixels,
+                   std::vector<RGBA,PaletteAllocator> &palette) noexcept(false)
+    {
+        if ((width < 1) || (height < 1))
+            return false;
+
+        if (in_pixels.size() != static_cast<size_t>(width * height))
+            return false;
+
+        if (in_pixels.size() <= static_cast<size_t>(colors))
+            return false;
+
+        out_pixels.resize(width * height);
+
+        return middleCut(width, height, colors, in_pixels.data(), width, out_pixels.data(), width,
+                         palette);
+    }
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace Common
+{
+    //
+    // AlignedAllocator - allocator for the standard containers, that starts every allocation on a
+    //                    boundary of the given amount of bytes (a cache line by default), so SIMD
+    //                    code can use aligned loads and no two buffers share a cache line
+    //
+    template <typename T, size_t Alignment = 64>
+    class AlignedAllocator {
+    public:
+        //--- public types and constants ---
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        //--- public constructors ---
+        AlignedAllocator() noexcept = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept
+        {
+        }
+
+        //--- public operators ---
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept
+        {
+            return true;
+        }
+
+        //--- public methods ---
+        T *allocate(const size_t count) noexcept(false)
+        {
+            return static_cast<T *>(::operator new(count * sizeof (T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T *ptr, const size_t) noexcept
+        {
+            ::operator delete(ptr, std::align_val_t(Alignment));
+        }
+    };
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <thread>
+#include <sys/mman.h>
+#include "BufferPool.hxx"
+#include "ThreadPool.hxx"
+
+namespace Common
+{
+    //--- internal stuff ---
+
+    static inline size_t roundUp(const size_t value, const size_t multiple) noexcept
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    //--- public constructors ---
+
+    BufferPool::BufferPool(const size_t limit, const bool huge_pages) noexcept(false)
+    : _shards(std::max<int64_t>(ThreadPool::hardwareThreads(), 1)), _limit(limit), _cached(0),
+      _huge_pages(huge_pages)
+    {
+    }
+
+    BufferPool::~BufferPool() noexcept
+    {
+        release();
+    }
+
+    //--- public methods ---
+
+    size_t BufferPool::limit() const noexcept
+    {
+        return _limit;
+    }
+
+    void BufferPool::setLimit(const size_t limit) noexcept
+    {
+        // already kept blocks above the new limit stay until they are taken or released
+        _limit = limit;
+    }
+
+    bool BufferPool::hugePages() const noexcept
+    {
+        return _huge_pages;
+    }
+
+    size_t BufferPool::cached() const noexcept
+    {
+        return _cached;
+    }
+
+    void BufferPool::release() noexcept
+    {
+        for (auto &shard : _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            for (auto &[bytes, blocks] : shard.blocks)
+            {
+                for (void *ptr : blocks)
+                    implFree(ptr, bytes, Alignment);
+                _cached -= bytes * blocks.size();
+            }
+            shard.blocks.clear();
+        }
+    }
+
+    //--- static public methods ---
+
+    BufferPool &BufferPool::global() noexcept(false)
+    {
+        // never destroyed, images living in statics may still give back their pixels at exit
+        static BufferPool *pool = new BufferPool();
+
+        return *pool;
+    }
+
+    //--- protected methods ---
+
+    void *BufferPool::do_allocate(const size_t bytes, const size_t alignment) noexcept(false)
+    {
+        if ((bytes < MinSize) || (alignment > Alignment))
+            return ::operator new(bytes, std::align_val_t(std::max(alignment, Alignment)));
+
+        if (void *ptr = implTake(bytes))
+            return ptr;
+
+        try
+        {
+            return implAllocate(bytes, alignment);
+        }
+        catch (const std::bad_alloc &)
+        {
+            // whatever is kept for other sizes is better used for this one
+            release();
+            return implAllocate(bytes, alignment);
+        }
+    }
+
+    void BufferPool::do_deallocate(void *ptr, const size_t bytes, const size_t alignment) noexcept
+    {
+        if ((bytes < MinSize) || (alignment > Alignment))
+        {
+            ::operator delete(ptr, std::align_val_t(std::max(alignment, Alignment)));
+            return;
+        }
+
+        if ((_cached + bytes) <= _limit)
+        {
+            Shard &shard = implShard();
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            shard.blocks[bytes].push_back(ptr);
+            _cached += bytes;
+        }
+        else
+            implFree(ptr, bytes, alignment);
+    }
+
+    bool BufferPool::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+    {
+        return this == &other;
+    }
+
+    BufferPool::Shard &BufferPool::implShard() noexcept
+    {
+        return _shards[std::hash<std::thread::id>()(std::this_thread::get_id()) % _shards.size()];
+    }
+
+    void *BufferPool::implTake(const size_t bytes) noexcept
+    {
+        // the own shard first, then whatever the other threads gave back
+        const size_t first = &implShard() - _shards.data();
+
+        for (size_t i = 0; i < _shards.size(); ++i)
+        {
+            Shard &shard = _shards[(first + i) % _shards.size()];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            if (auto it = shard.blocks.find(bytes); it != shard.blocks.end())
+            {
+                void *ptr = it->second.back();
+
+                it->second.pop_back();
+                if (it->second.empty())
+                    shard.blocks.erase(it);
+                _cached -= bytes;
+
+                return ptr;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool BufferPool::implMapped(const size_t bytes, const size_t alignment) const noexcept
+    {
+        return _huge_pages && (bytes >= HugePageSize) && (alignment <= Alignment);
+    }
+
+    void *BufferPool::implAllocate(const size_t bytes, const size_t alignment) noexcept(false)
+    {
+        if (!implMapped(bytes, alignment))
+            return ::operator new(bytes, std::align_val_t(std::max(alignment, Alignment)));
+
+        // one huge page more than needed, so the block can start on a huge page boundary
+        const size_t size = roundUp(bytes, HugePageSize);
+        void *area = mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (area == MAP_FAILED)
+            throw std::bad_alloc();
+
+        char *begin = static_cast<char *>(area);
+        char *aligned = reinterpret_cast<char *>(roundUp(reinterpret_cast<size_t>(begin),
+                                                         HugePageSize));
+
+        if (aligned > begin)
+            munmap(begin, aligned - begin);
+        if ((aligned + size) < (begin + size + HugePageSize))
+            munmap(aligned + size, begin + HugePageSize - aligned);
+        madvise(aligned, size, MADV_HUGEPAGE);
+
+        return aligned;
+    }
+
+    void BufferPool::implFree(void *ptr, const size_t bytes, const size_t alignment) noexcept
+    {
+        if (implMapped(bytes, alignment))
+            munmap(ptr, roundUp(bytes, HugePageSize));
+        else
+            ::operator delete(ptr, std::align_val_t(std::max(alignment, Alignment)));
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace Common
+{
+    //
+    // BufferPool - memory resource for the big buffers of image processing, freed blocks are kept
+    //              and handed out again to the next request of the very same size, so a program
+    //              going through many images of one size stops asking the system for memory
+    //
+    // - every block starts on a 64 byte boundary, blocks below MinSize are not worth keeping and
+    //   come straight from the aligned global new
+    // - the free blocks are kept in one shard per hardware thread, a thread looks into its own
+    //   shard first, so threads recycling their own buffers do not wait for each other, blocks
+    //   freed by another thread are still found in the other shards
+    // - with huge pages blocks of at least HugePageSize are mapped on a huge page boundary and
+    //   marked for transparent huge pages, which saves the TLB a lot of work on big images
+    // - no more than limit bytes are kept, release() hands all kept blocks back to the system
+    //
+    class BufferPool : public std::pmr::memory_resource {
+    public:
+        //--- public types and constants ---
+        static constexpr size_t Alignment = 64;
+        static constexpr size_t MinSize = 64 * 1024;
+        static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+        static constexpr size_t DefaultLimit = 512 * 1024 * 1024;
+
+        //--- public constructors ---
+        BufferPool(const size_t limit = DefaultLimit, const bool huge_pages = false)
+            noexcept(false);
+        BufferPool(const BufferPool &rhs) = delete;
+        BufferPool(BufferPool &&rhs) = delete;
+        virtual ~BufferPool() noexcept;
+
+        //--- public operators ---
+        BufferPool &operator=(const BufferPool &rhs) = delete;
+        BufferPool &operator=(BufferPool &&rhs) = delete;
+
+        //--- public methods ---
+        size_t limit() const noexcept;
+        void setLimit(const size_t limit) noexcept;
+        bool hugePages() const noexcept;
+        size_t cached() const noexcept;
+        void release() noexcept;
+
+        //--- static public methods ---
+        static BufferPool &global() noexcept(false);
+
+    protected:
+        //--- protected types and constants ---
+        struct Shard {
+            std::mutex mutex;
+            std::map<size_t,std::vector<void *>> blocks;
+        };
+
+        //--- protected methods ---
+        virtual void *do_allocate(const size_t bytes, const size_t alignment) noexcept(false)
+            override;
+        virtual void do_deallocate(void *ptr, const size_t bytes, const size_t alignment) noexcept
+            override;
+        virtual bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+        Shard &implShard() noexcept;
+        void *implTake(const size_t bytes) noexcept;
+        bool implMapped(const size_t bytes, const size_t alignment) const noexcept;
+        void *implAllocate(const size_t bytes, const size_t alignment) noexcept(false);
+        void implFree(void *ptr, const size_t bytes, const size_t alignment) noexcept;
+
+    private:
+        //--- private properties ---
+        std::vector<Shard> _shards;
+        std::atomic<size_t> _limit;
+        std::atomic<size_t> _cached;
+        const bool _huge_pages;
+    };
+}
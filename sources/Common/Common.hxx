@@ -1,6 +1,9 @@
 #pragma once
 
+#include "AlignedAllocator.hxx"
 #include "Args.hxx"
+#include "BufferPool.hxx"
 #include "Concepts.hxx"
 #include "Endian.hxx"
+#include "ThreadPool.hxx"
 #include "Tools.hxx"
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include "ThreadPool.hxx"
+
+namespace Common
+{
+    //--- internal stuff ---
+
+    struct ThreadPool::Batch {
+        const Job &job;
+        const int64_t jobs;
+        std::atomic<int64_t> next;
+        std::atomic<int64_t> done;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::exception_ptr error;
+
+        Batch(const Job &jjob, const int64_t jjobs) noexcept
+        : job(jjob), jobs(jjobs), next(0), done(0), mutex(), cond(), error()
+        {
+        }
+    };
+
+    //--- public constructors ---
+
+    ThreadPool::ThreadPool(const int64_t workers) noexcept(false)
+    : _workers(), _queue(), _mutex(), _cond(), _stop(false)
+    {
+        // the calling thread is the one missing worker
+        const int64_t count = workers > 0 ? workers : hardwareThreads() - 1;
+
+        _workers.reserve(std::max<int64_t>(count, 0));
+        for (int64_t i = 0; i < count; ++i)
+            _workers.emplace_back(&ThreadPool::worker, this);
+    }
+
+    ThreadPool::~ThreadPool() noexcept
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _cond.notify_all();
+
+        for (auto &worker : _workers)
+            worker.join();
+    }
+
+    //--- public methods ---
+
+    int64_t ThreadPool::threads() const noexcept
+    {
+        return _workers.size() + 1;
+    }
+
+    void ThreadPool::run(const int64_t jobs, const Job &job) noexcept(false)
+    {
+        if (jobs < 1)
+            return;
+
+        if ((jobs == 1) || _workers.empty())
+        {
+            for (int64_t i = 0; i < jobs; ++i)
+                job(i);
+            return;
+        }
+
+        auto batch = std::make_shared<Batch>(job, jobs);
+
+        {
+            std::lock_guard lock(_mutex);
+            _queue.push_back(batch);
+        }
+        _cond.notify_all();
+
+        process(*batch);
+
+        {
+            std::lock_guard lock(_mutex);
+            if (auto it = std::find(_queue.begin(), _queue.end(), batch); it != _queue.end())
+                _queue.erase(it);
+        }
+
+        {
+            std::unique_lock lock(batch->mutex);
+            batch->cond.wait(lock, [&batch]{ return batch->done == batch->jobs; });
+        }
+
+        if (batch->error)
+            std::rethrow_exception(batch->error);
+    }
+
+    void ThreadPool::runBands(const int64_t size, const int64_t bands, const BandJob &job)
+        noexcept(false)
+    {
+        const int64_t count = std::clamp<int64_t>(bands, 1, std::max<int64_t>(size, 1));
+
+        run(count, [&](const int64_t band)
+        {
+            const int64_t begin = size * band / count;
+            const int64_t end = size * (band + 1) / count;
+
+            if (begin < end)
+                job(begin, end);
+        });
+    }
+
+    //--- static public methods ---
+
+    ThreadPool &ThreadPool::global() noexcept(false)
+    {
+        static ThreadPool pool;
+
+        return pool;
+    }
+
+    int64_t ThreadPool::hardwareThreads() noexcept
+    {
+        return std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    //--- protected methods ---
+
+    void ThreadPool::worker() noexcept
+    {
+        while (true)
+        {
+            std::shared_ptr<Batch> batch;
+
+            {
+                std::unique_lock lock(_mutex);
+
+                _cond.wait(lock, [this]{ return _stop || !_queue.empty(); });
+                if (_queue.empty())
+                    return;
+
+                batch = _queue.front();
+                if (batch->next >= batch->jobs)
+                {
+                    // every job is taken, the remaining ones are finished by others
+                    _queue.pop_front();
+                    continue;
+                }
+            }
+
+            process(*batch);
+        }
+    }
+
+    //--- static protected methods ---
+
+    void ThreadPool::process(Batch &batch) noexcept
+    {
+        for (int64_t index = batch.next++; index < batch.jobs; index = batch.next++)
+        {
+            try
+            {
+                batch.job(index);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(batch.mutex);
+
+                if (!batch.error)
+                    batch.error = std::current_exception();
+            }
+
+            if (++batch.done == batch.jobs)
+            {
+                std::lock_guard lock(batch.mutex);
+                batch.cond.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Common
+{
+    //
+    // ThreadPool - a fixed set of worker threads running batches of indexed jobs
+    //
+    // - the calling thread always works on its own batch, so a job is allowed to start another
+    //   batch on the same pool without dead locking it
+    // - exceptions thrown by a job are passed on to the caller of run()
+    //
+    class ThreadPool {
+    public:
+        //--- public types and constants ---
+        using Job = std::function<void (const int64_t)>;
+        using BandJob = std::function<void (const int64_t, const int64_t)>;
+
+        //--- public constructors ---
+        ThreadPool(const int64_t workers = 0) noexcept(false);
+        ThreadPool(const ThreadPool &rhs) = delete;
+        ThreadPool(ThreadPool &&rhs) = delete;
+        ~ThreadPool() noexcept;
+
+        //--- public operators ---
+        ThreadPool &operator=(const ThreadPool &rhs) = delete;
+        ThreadPool &operator=(ThreadPool &&rhs) = delete;
+
+        //--- public methods ---
+        int64_t threads() const noexcept;
+        void run(const int64_t jobs, const Job &job) noexcept(false);
+        void runBands(const int64_t size, const int64_t bands, const BandJob &job) noexcept(false);
+
+        //--- static public methods ---
+        static ThreadPool &global() noexcept(false);
+        static int64_t hardwareThreads() noexcept;
+
+    protected:
+        //--- protected types and constants ---
+        struct Batch;
+
+        //--- protected methods ---
+        void worker() noexcept;
+
+        //--- static protected methods ---
+        static void process(Batch &batch) noexcept;
+
+    private:
+        //--- private properties ---
+        std::vector<std::thread> _workers;
+        std::deque<std::shared_ptr<Batch>> _queue;
+        std::mutex _mutex;
+        std::condition_variable _cond;
+        bool _stop;
+    };
+}
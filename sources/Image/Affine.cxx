@@ -0,0 +1,156 @@
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+#include "Affine.hxx"
+
+namespace Image
+{
+    //--- internal stuff ---
+
+    static const double Epsilon = 1e-12;
+
+    // the transform around a center is the one around the origin with the center moved there and
+    // back again
+    static Affine around(const Affine &affine, const Affine::V2d &center) noexcept
+    {
+        return Affine::translation(center) * affine * Affine::translation(-center);
+    }
+
+    //--- public constructors ---
+
+    Affine::Affine() noexcept
+    : _matrix{1, 0, 0, 0, 1, 0}
+    {
+    }
+
+    Affine::Affine(const double a, const double b, const double c, const double d, const double e,
+                   const double f) noexcept
+    : _matrix{a, b, c, d, e, f}
+    {
+    }
+
+    Affine::Affine(const Affine &rhs) noexcept
+    : _matrix(rhs._matrix)
+    {
+    }
+
+    Affine::Affine(Affine &&rhs) noexcept
+    : _matrix(std::move(rhs._matrix))
+    {
+    }
+
+    Affine::~Affine() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    Affine &Affine::operator=(const Affine &rhs) noexcept
+    {
+        _matrix = rhs._matrix;
+
+        return *this;
+    }
+
+    Affine &Affine::operator=(Affine &&rhs) noexcept
+    {
+        _matrix = std::move(rhs._matrix);
+
+        return *this;
+    }
+
+    bool Affine::operator==(const Affine &rhs) const noexcept
+    {
+        return _matrix == rhs._matrix;
+    }
+
+    bool Affine::operator!=(const Affine &rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    Affine Affine::operator*(const Affine &rhs) const noexcept
+    {
+        const auto &[a, b, c, d, e, f] = _matrix;
+        const auto &[ra, rb, rc, rd, re, rf] = rhs._matrix;
+
+        return {a * ra + b * rd, a * rb + b * re, a * rc + b * rf + c,
+                d * ra + e * rd, d * rb + e * re, d * rc + e * rf + f};
+    }
+
+    //--- public methods ---
+
+    const Affine::Matrix &Affine::matrix() const noexcept
+    {
+        return _matrix;
+    }
+
+    double Affine::determinant() const noexcept
+    {
+        return _matrix[0] * _matrix[4] - _matrix[1] * _matrix[3];
+    }
+
+    bool Affine::invertible() const noexcept
+    {
+        return std::abs(determinant()) > Epsilon;
+    }
+
+    Affine Affine::inverse() const noexcept(false)
+    {
+        if (!invertible())
+            throw std::domain_error("affine transform is not invertible");
+
+        const auto &[a, b, c, d, e, f] = _matrix;
+        const double det = determinant();
+
+        return {e / det, -b / det, (b * f - c * e) / det,
+                -d / det, a / det, (c * d - a * f) / det};
+    }
+
+    Affine::V2d Affine::map(const V2d &position) const noexcept
+    {
+        return {_matrix[0] * position.x + _matrix[1] * position.y + _matrix[2],
+                _matrix[3] * position.x + _matrix[4] * position.y + _matrix[5]};
+    }
+
+    Affine::V2d Affine::mapDirection(const V2d &direction) const noexcept
+    {
+        // a direction has no position, so the translation does not apply
+        return {_matrix[0] * direction.x + _matrix[1] * direction.y,
+                _matrix[3] * direction.x + _matrix[4] * direction.y};
+    }
+
+    //--- static public methods ---
+
+    Affine Affine::translation(const V2d &offset) noexcept
+    {
+        return {1, 0, offset.x, 0, 1, offset.y};
+    }
+
+    Affine Affine::scale(const double x, const double y, const V2d &center) noexcept
+    {
+        return around({x, 0, 0, 0, y, 0}, center);
+    }
+
+    Affine Affine::shear(const double x, const double y, const V2d &center) noexcept
+    {
+        return around({1, x, 0, y, 1, 0}, center);
+    }
+
+    Affine Affine::rotation(const double degrees, const V2d &center) noexcept
+    {
+        const double radians = degrees * std::numbers::pi / 180;
+        double cosine = std::cos(radians);
+        double sine = std::sin(radians);
+
+        // quarter turns are exact, so they move pixels just like rotate90() and friends
+        if (std::fmod(degrees, 90) == 0)
+        {
+            cosine = std::round(cosine);
+            sine = std::round(sine);
+        }
+
+        return around({cosine, -sine, 0, sine, cosine, 0}, center);
+    }
+}
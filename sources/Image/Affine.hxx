@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include "Math/Vector2.hxx"
+
+namespace Image
+{
+    //
+    // Affine - a 2x3 matrix that maps a position (x, y) to (a * x + b * y + c, d * x + e * y + f),
+    //          the matrix is stored row by row as {a, b, c, d, e, f}
+    //
+    // - positions are continuous with y pointing down like the rows of an image, pixel (x, y)
+    //   covers the square from (x, y) to (x + 1, y + 1) and its center is at (x + .5, y + .5)
+    // - positive angles turn clockwise on the screen, just like Base::rotate90()
+    // - a * b is the transform that applies b first and a afterwards
+    //
+    class Affine {
+    public:
+        //--- public types and constants ---
+        using V2d = Math::Vector2<double>;
+        using Matrix = std::array<double,6>;
+
+        //--- public constructors ---
+        Affine() noexcept;
+        Affine(const double a, const double b, const double c, const double d, const double e,
+               const double f) noexcept;
+        Affine(const Affine &rhs) noexcept;
+        Affine(Affine &&rhs) noexcept;
+        ~Affine() noexcept;
+
+        //--- public operators ---
+        Affine &operator=(const Affine &rhs) noexcept;
+        Affine &operator=(Affine &&rhs) noexcept;
+        bool operator==(const Affine &rhs) const noexcept;
+        bool operator!=(const Affine &rhs) const noexcept;
+        Affine operator*(const Affine &rhs) const noexcept;
+
+        //--- public methods ---
+        const Matrix &matrix() const noexcept;
+        double determinant() const noexcept;
+        bool invertible() const noexcept;
+        Affine inverse() const noexcept(false);
+        V2d map(const V2d &position) const noexcept;
+        V2d mapDirection(const V2d &direction) const noexcept;
+
+        //--- static public methods ---
+        static Affine translation(const V2d &offset) noexcept;
+        static Affine scale(const double x, const double y, const V2d &center = V2d()) noexcept;
+        static Affine shear(const double x, const double y, const V2d &center = V2d()) noexcept;
+        static Affine rotation(const double degrees, const V2d &center = V2d()) noexcept;
+
+    private:
+        //--- private properties ---
+        Matrix _matrix;
+    };
+}
@@ -1,50 +1,87 @@
 #include <algorithm>
-#include <map>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
 #include <tuple>
 #include <utility>
-#include "Color/MiddleCutQuantizer.hxx"
+#include "Color/Histogram.hxx"
+#include "Common/ThreadPool.hxx"
 #include "Common/Tools.hxx"
-#include "Math/Vector2.hxx"
 #include "Base.hxx"
+#include "DrawDetail.hxx"
+#include "FilterDetail.hxx"
+#include "PixelDetail.hxx"
+#include "RotateDetail.hxx"
+#include "TileDetail.hxx"
 
 namespace Image
 {
     //--- internal stuff ---
 
     namespace T = Common::Tools;
-    using V2d = Math::Vector2<double>;
 
-    constexpr inline std::tuple<double,double,double,double>
-    boundingBox(const V2d &p1, const V2d &p2, const V2d &p3)
+    // no clip rectangle, everything of the image may be drawn
+    static constexpr Base::Rect Unclipped = {0, 0, std::numeric_limits<int64_t>::max(),
+                                          std::numeric_limits<int64_t>::max()};
+
+    // the clip rectangle of an image the way the drawing algorithms take it
+    static Detail::Clip toClip(const Base::Rect &rect) noexcept
+    {
+        return {rect.x, rect.y, rect.x + rect.width, rect.y + rect.height};
+    }
+
+    // the bounding box of a display list command, both corners included
+    static std::tuple<int64_t,int64_t,int64_t,int64_t> bounds(const DisplayList::Command &command)
+        noexcept
     {
-        return {T::min(p1.x, p2.x, p3.x), T::min(p1.y, p2.y, p3.y),
-                T::max(p1.x, p2.x, p3.x), T::max(p1.y, p2.y, p3.y)};
+        if ((command.primitive == DisplayList::Primitive::Circle) ||
+          (command.primitive == DisplayList::Primitive::Ellipse))
+            return {command.x1 - std::abs(command.x2), command.y1 - std::abs(command.y2),
+                    command.x1 + std::abs(command.x2), command.y1 + std::abs(command.y2)};
+
+        return {T::min(command.x1, command.x2, command.x3),
+                T::min(command.y1, command.y2, command.y3),
+                T::max(command.x1, command.x2, command.x3),
+                T::max(command.y1, command.y2, command.y3)};
     }
 
     //--- public constructors ---
 
     Base::Base() noexcept
-    : _data(), _width(0), _height(0)
+    : _data(), _width(0), _height(0), _threads(1), _layout(Layout::Linear),
+      _clip(Unclipped), _resource(std::pmr::get_default_resource())
     {
     }
 
-    Base::Base(const int64_t width, const int64_t height, const RGBA color) noexcept(false)
-    : _data(width * height, color), _width(width), _height(height)
+    Base::Base(const int64_t width, const int64_t height, const RGBA color, const Layout layout)
+        noexcept(false)
+    : _data(), _width(width), _height(height), _threads(1), _layout(layout),
+      _clip(Unclipped), _resource(std::pmr::get_default_resource())
     {
+        _data = std::make_shared<Pixels>(width * height, color, _resource);
     }
 
-    Base::Base(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false)
-    : _data(pixels), _width(width), _height(height)
+    Base::Base(const Pixels &pixels, const int64_t width, const int64_t height,
+               const Layout layout) noexcept(false)
+    : _data(), _width(width), _height(height), _threads(1), _layout(Layout::Linear),
+      _clip(Unclipped), _resource(std::pmr::get_default_resource())
     {
+        _data = std::make_shared<Pixels>(pixels, _resource);
+        setLayout(layout);
     }
 
     Base::Base(const Base &rhs) noexcept(false)
-    : _data(rhs._data), _width(rhs._width), _height(rhs._height)
+    : _data(rhs._data), _width(rhs._width), _height(rhs._height), _threads(rhs._threads),
+      _layout(rhs._layout), _clip(rhs._clip), _resource(rhs._resource)
     {
     }
 
     Base::Base(Base &&rhs) noexcept
-    : _data(std::move(rhs._data)), _width(std::move(rhs._width)), _height(std::move(rhs._height))
+    : _data(std::move(rhs._data)), _width(std::move(rhs._width)), _height(std::move(rhs._height)),
+      _threads(std::move(rhs._threads)), _layout(std::move(rhs._layout)),
+      _clip(std::move(rhs._clip)), _resource(std::move(rhs._resource))
     {
     }
 
@@ -61,6 +98,10 @@ namespace Image
             _data = rhs._data;
             _width = rhs._width;
             _height = rhs._height;
+            _threads = rhs._threads;
+            _layout = rhs._layout;
+            _clip = rhs._clip;
+            _resource = rhs._resource;
         }
 
         return *this;
@@ -73,6 +114,10 @@ namespace Image
             _data = std::move(rhs._data);
             _width = std::move(rhs._width);
             _height = std::move(rhs._height);
+            _threads = std::move(rhs._threads);
+            _layout = std::move(rhs._layout);
+            _clip = std::move(rhs._clip);
+            _resource = std::move(rhs._resource);
         }
 
         return *this;
@@ -80,9 +125,19 @@ namespace Image
 
     bool Base::operator==(const Base &rhs) const noexcept
     {
-        return _data == rhs._data &&
-               _width == rhs._width &&
-               _height == rhs._height;
+        if ((_width != rhs._width) || (_height != rhs._height))
+            return false;
+
+        if (_layout == rhs._layout)
+            return (_data == rhs._data) || (implData() == rhs.implData());
+
+        // the same image stored differently
+        for (int64_t y = 0; y < _height; ++y)
+            for (int64_t x = 0; x < _width; ++x)
+                if (implPixel(x, y) != rhs.implPixel(x, y))
+                    return false;
+
+        return true;
     }
 
     bool Base::operator!=(const Base &rhs) const noexcept
@@ -102,141 +157,459 @@ namespace Image
         return _height;
     }
 
-    const Base::Pixels &Base::pixels() const noexcept
+    int64_t Base::threads() const noexcept
     {
-        return _data;
+        return _threads;
     }
 
-    int64_t Base::usedColors() const noexcept(false)
+    void Base::setThreads(const int64_t threads) noexcept
+    {
+        // anything below 1 means "use every core available"
+        _threads = threads > 0 ? threads : Common::ThreadPool::hardwareThreads();
+    }
+
+    Layout Base::layout() const noexcept
+    {
+        return _layout;
+    }
+
+    void Base::setLayout(const Layout layout) noexcept(false)
+    {
+        if (layout == _layout)
+            return;
+
+        const Pixels &data = implData();
+        Pixels pixels(data.size(), _resource);
+
+        if (layout == Layout::Tiled)
+            Detail::toTiles(data.data(), pixels.data(), _width, _height, _threads);
+        else
+            Detail::fromTiles(data.data(), pixels.data(), _width, _height, _threads);
+
+        // the rearranged pixels are a new buffer anyway, so the old one stays with its sharers
+        _data = std::make_shared<Pixels>(std::move(pixels));
+        _layout = layout;
+    }
+
+    std::pmr::memory_resource *Base::memoryResource() const noexcept
+    {
+        return _resource;
+    }
+
+    void Base::setMemoryResource(std::pmr::memory_resource *resource) noexcept(false)
+    {
+        _resource = resource ? resource : std::pmr::get_default_resource();
+
+        // the pixels move over right away, nobody expects them to stay with the old resource
+        if (_data && (_data->get_allocator().resource() != _resource))
+            _data = std::make_shared<Pixels>(*_data, _resource);
+    }
+
+    const Base::Pixels &Base::pixels() const noexcept(false)
+    {
+        // everyone using these expects them row by row
+        if (_layout != Layout::Linear)
+            throw std::logic_error("pixels() needs the linear layout");
+
+        return implData();
+    }
+
+    ImageView Base::view() const noexcept(false)
+    {
+        return view(0, 0, _width, _height);
+    }
+
+    ImageView Base::view(const int64_t x, const int64_t y, const int64_t width,
+                         const int64_t height) const noexcept(false)
+    {
+        // a view is a plain rectangle of rows, which tiles are not
+        if (_layout != Layout::Linear)
+            throw std::logic_error("views need the linear layout");
+
+        return ImageView(implData().data(), _width, _height, _width).view(x, y, width, height);
+    }
+
+    MutableImageView Base::mutableView() noexcept(false)
+    {
+        return mutableView(0, 0, _width, _height);
+    }
+
+    MutableImageView Base::mutableView(const int64_t x, const int64_t y, const int64_t width,
+                                       const int64_t height) noexcept(false)
     {
-        std::map<uint64_t, uint64_t> color_map;
+        if (_layout != Layout::Linear)
+            throw std::logic_error("views need the linear layout");
+
+        // whoever asks for a mutable view is about to write
+        return MutableImageView(implOwnData().data(), _width, _height, _width).view(x, y, width,
+                                                                                    height);
+    }
 
-        for (auto &pixel : _data)
-            ++color_map[pixel.value];
+    void Base::forEachTile(const TileJob &job) noexcept(false)
+    {
+        const int64_t columns = (_width + TileSize - 1) / TileSize;
+        const int64_t rows = (_height + TileSize - 1) / TileSize;
+
+        // the tiles are handed out for writing, so the pixels have to be our own before the jobs
+        // run in parallel
+        implOwnData();
+        Common::ThreadPool::global().runBands(columns * rows, _threads,
+        [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t tile = begin; tile < end; ++tile)
+                job(implTile(tile % columns, tile / columns));
+        });
+    }
 
-        return color_map.size();
+    int64_t Base::usedColors() const noexcept(false)
+    {
+        // the layout does not matter for counting, the tiles hold the same amount of pixels, so
+        // they are just looked at as rows of the width of the image
+        return Color::Histogram::countColors(implData().data(), _width, _height, _width, _threads);
     }
 
     void Base::flipVertical() noexcept(false)
     {
-        for (int64_t row = 0; row < _height; ++row)
-            std::reverse(_data.begin() + (row * _width), _data.begin() + (row * _width + _width));
+        implLinear([&]()
+        {
+            Detail::flipVertical(implOwnData().data(), _width, _height, _width, _threads);
+        });
     }
 
     void Base::flipHorizontal() noexcept(false)
     {
-        for (int64_t row = 0; row < _height; ++row)
-            std::reverse(_data.begin() + (row * _width), _data.begin() + (row * _width + _width));
-        std::reverse(_data.begin(), _data.end());
+        implLinear([&]()
+        {
+            Detail::flipHorizontal(implOwnData().data(), _width, _height, _width, _threads);
+        });
+    }
+
+    void Base::rotate90() noexcept(false)
+    {
+        implTranspose(false, true);
     }
 
-    bool Base::filter(const Filter filter) noexcept(false)
+    void Base::rotate180() noexcept(false)
     {
-        if ((_width > 2) && (_height > 2))
+        implLinear([&]()
         {
-            const Pixels pixels = implFilter(_data, _width, _height, filter);
+            Detail::rotate180(implOwnData().data(), _width, _height, _width);
+        });
+    }
 
-            implReplace(pixels, _width, _height);
+    void Base::rotate270() noexcept(false)
+    {
+        implTranspose(true, false);
+    }
+
+    void Base::transpose() noexcept(false)
+    {
+        implTranspose(false, false);
+    }
+
+    bool Base::filter(const Filter filter, const int64_t radius) noexcept(false)
+    {
+        const bool kernel3x3 = (filter != Filter::BoxBlur) && (filter != Filter::GaussianBlur);
+        bool result = false;
+
+        if (kernel3x3 && (_width > 2) && (_height > 2))
+        {
+            implFilter(filter);
 
             return true;
         }
 
-        return false;
+        if (!kernel3x3 && (_width > 0) && (_height > 0) && (radius > 0))
+        {
+            implLinear([&]()
+            {
+                result = mutableView().filter(filter, radius, _threads);
+            });
+        }
+
+        return result;
     }
 
-    bool Base::reduceColors(const int64_t colors, const Quantizer quantizer) noexcept(false)
+    bool Base::convolve(const Kernel &kernel, const Border border) noexcept(false)
     {
-        Pixels out_pixels;
-        Pixels palette;
         bool result = false;
 
-        switch (quantizer)
+        if ((_width > 0) && (_height > 0))
         {
-            case Quantizer::MiddleCut:
-                result = Color::Quantize::middleCut<RGBA>(_width, _height, colors, _data,
-                                                          out_pixels, palette);
+            implLinear([&]()
+            {
+                result = mutableView().convolve(kernel, border, _threads);
+            });
         }
 
-        if (result)
-            implReplace(out_pixels, _width, _height);
+        return result;
+    }
+
+    bool Base::reduceColors(const int64_t colors, const Quantizer quantizer) noexcept(false)
+    {
+        bool result = false;
+
+        // the palette is applied in place
+        implLinear([&]()
+        {
+            result = mutableView().reduceColors(colors, quantizer);
+        });
+
+        return result;
+    }
+
+    bool Base::warp(const Affine &affine, const int64_t width, const int64_t height,
+                    const Scaler scaler, const RGBA background) noexcept(false)
+    {
+        bool result = false;
+
+        if ((width < 1) || (height < 1))
+            return false;
+
+        implLinear([&]()
+        {
+            Pixels pixels(width * height, _resource);
+            const MutableImageView target(pixels.data(), width, height, width);
+
+            result = target.warp(view(), affine, scaler, background, _threads);
+            if (result)
+                implReplace(std::move(pixels), width, height);
+        });
 
         return result;
     }
 
+    bool Base::rotate(const double degrees, const Scaler scaler, const RGBA background)
+        noexcept(false)
+    {
+        const Affine::V2d center(_width / 2.0, _height / 2.0);
+
+        return warp(Affine::rotation(degrees, center), _width, _height, scaler, background);
+    }
+
+    Pyramid Base::buildPyramid() const noexcept(false)
+    {
+        if (_layout == Layout::Linear)
+            return Pyramid(implData(), _width, _height, _threads);
+
+        Pixels pixels(implData().size(), _resource);
+
+        Detail::fromTiles(implData().data(), pixels.data(), _width, _height, _threads);
+
+        return Pyramid(pixels, _width, _height, _threads);
+    }
+
+    Planar Base::toPlanar() const noexcept(false)
+    {
+        if (_layout == Layout::Linear)
+            return Planar(implData().data(), _width, _height, _threads);
+
+        Pixels pixels(implData().size(), _resource);
+
+        Detail::fromTiles(implData().data(), pixels.data(), _width, _height, _threads);
+
+        return Planar(pixels, _width, _height, _threads);
+    }
+
+    bool Base::fromPlanar(const Planar &planar) noexcept(false)
+    {
+        if (!planar.width() || !planar.height())
+            return false;
+
+        implReplace(planar.pixels(_threads), planar.width(), planar.height());
+
+        return true;
+    }
+
     Base::RGBA Base::pixel(const int64_t x, const int64_t y) const noexcept(false)
     {
-        if (T::inRange(x, 0, width()) && T::inRange(y, 0, height()))
+        if (T::inRange(x, 0, width(), true, false) && T::inRange(y, 0, height(), true, false))
             return implPixel(x, y);
         else
             throw "POOF for now";
     }
 
-    bool Base::setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept
+    Base::Rect Base::clip() const noexcept
     {
-        if (T::inRange(x, 0, width()) && T::inRange(y, 0, height()))
-        {
-            implSetPixel(x, y, color);
-            return true;
-        }
+        const int64_t x1 = std::max<int64_t>(_clip.x, 0);
+        const int64_t y1 = std::max<int64_t>(_clip.y, 0);
+        const int64_t x2 = std::min(_clip.x + _clip.width, _width);
+        const int64_t y2 = std::min(_clip.y + _clip.height, _height);
+
+        return {x1, y1, std::max<int64_t>(x2 - x1, 0), std::max<int64_t>(y2 - y1, 0)};
+    }
+
+    bool Base::setClip(const int64_t x, const int64_t y, const int64_t width,
+                       const int64_t height) noexcept
+    {
+        if (!Detail::validRect(x, y, width, height))
+            return false;
+
+        _clip = {x, y, width, height};
+
+        return true;
+    }
+
+    void Base::resetClip() noexcept
+    {
+        _clip = Unclipped;
+    }
+
+    bool Base::setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept(false)
+    {
+        if (!Detail::touches(toClip(clip()), x, y, x, y))
+            return false;
+
+        implSetPixel(x, y, color);
 
-        return false;
+        return true;
     }
 
     bool Base::setLine(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
-                       const RGBA color) noexcept
+                       const RGBA color) noexcept(false)
     {
-        if (T::inRange(x1, 0, width()) && T::inRange(y1, 0, height()) &&
-          T::inRange(x2, 0, width()) && T::inRange(y2, 0, height()))
-        {
-            implSetLine(x1, y1, x2, y2, color);
-            return true;
-        }
+        if (!Detail::acceptsLine(toClip(clip()), x1, y1, x2, y2))
+            return false;
+
+        implSetLine(x1, y1, x2, y2, color);
 
-        return false;
+        return true;
     }
 
     bool Base::setTriangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
                            const int64_t x3, const int64_t y3, const RGBA color, const bool fill)
-        noexcept
+        noexcept(false)
     {
-        if (T::inRange(x1, 0, width()) && T::inRange(y1, 0, height()) &&
-          T::inRange(x2, 0, width()) && T::inRange(y2, 0, height()) &&
-          T::inRange(x3, 0, width()) && T::inRange(y3, 0, height()))
-        {
-            implSetTriangle(x1, y1, x2, y2, x3, y3, color, fill);
-            return true;
-        }
+        if (!Detail::acceptsTriangle(toClip(clip()), x1, y1, x2, y2, x3, y3))
+            return false;
 
-        return false;
+        implSetTriangle(x1, y1, x2, y2, x3, y3, color, fill);
+
+        return true;
     }
 
     bool Base::setRectangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
-                            const RGBA color, const bool fill) noexcept
+                            const RGBA color, const bool fill) noexcept(false)
     {
-        if (T::inRange(x1, 0, width()) && T::inRange(y1, 0, height()) &&
-          T::inRange(x2, 0, width()) && T::inRange(y2, 0, height()))
-        {
-            implSetRectangle(x1, y1, x2, y2, color, fill);
-            return true;
-        }
+        if (!Detail::acceptsRectangle(toClip(clip()), x1, y1, x2, y2))
+            return false;
 
-        return false;
+        implSetRectangle(x1, y1, x2, y2, color, fill);
+
+        return true;
     }
 
     bool Base::setCircle(const int64_t x, const int64_t y, const int64_t radius, const RGBA color,
-                         const bool fill) noexcept
+                         const bool fill) noexcept(false)
+    {
+        return setEllipse(x, y, radius, radius, color, fill);
+    }
+
+    bool Base::setEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                          const int64_t radius_y, const RGBA color, const bool fill)
+        noexcept(false)
+    {
+        if (!Detail::acceptsEllipse(toClip(clip()), x, y, radius_x, radius_y))
+            return false;
+
+        implSetEllipse(x, y, std::abs(radius_x), std::abs(radius_y), color, fill);
+
+        return true;
+    }
+
+    bool Base::setSmoothLine(const double x1, const double y1, const double x2, const double y2,
+                             const RGBA color) noexcept(false)
+    {
+        if (!Detail::acceptsSmoothLine(toClip(clip()), x1, y1, x2, y2))
+            return false;
+
+        implSetSmoothLine(x1, y1, x2, y2, color);
+
+        return true;
+    }
+
+    bool Base::setSmoothPolygon(const std::vector<Affine::V2d> &points, const RGBA color)
+        noexcept(false)
     {
-        const int64_t rad = std::abs(radius);
+        if (!Detail::acceptsSmoothPolygon(toClip(clip()), points))
+            return false;
+
+        implSetSmoothPolygon(points, color);
+
+        return true;
+    }
 
-        if (T::inRange(x, 0, width()) && T::inRange(y, 0, height()) &&
-          T::inRange(x + rad, 0, width()) && T::inRange(x - rad, 0, width()) &&
-          T::inRange(y + rad, 0, height()) && T::inRange(y - rad, 0, height()))
+    void Base::draw(const DisplayList &list) noexcept(false)
+    {
+        const int64_t columns = (_width + TileSize - 1) / TileSize;
+        const int64_t rows = (_height + TileSize - 1) / TileSize;
+        const Detail::Clip clip = toClip(this->clip());
+        const auto &commands = list.commands();
+        std::vector<std::vector<size_t>> bins(columns * rows);
+
+        // every command goes to the tiles its clipped bounding box touches, a line only to those
+        // it passes, one pixel around a tile is enough to catch all the pixels of its Bresenham
+        // line
+        for (size_t i = 0; i < commands.size(); ++i)
         {
-            implSetCircle(x, y, radius, color, fill);
-            return true;
+            const DisplayList::Command &command = commands[i];
+
+            if (!implAccepts(command))
+                continue;
+
+            const auto [min_x, min_y, max_x, max_y] = bounds(command);
+            const int64_t x1 = std::max(min_x, clip.x1);
+            const int64_t y1 = std::max(min_y, clip.y1);
+            const int64_t x2 = std::min(max_x, clip.x2 - 1);
+            const int64_t y2 = std::min(max_y, clip.y2 - 1);
+            const int64_t dx = command.x2 - command.x1;
+            const int64_t dy = command.y2 - command.y1;
+
+            for (int64_t row = y1 / TileSize; row <= y2 / TileSize; ++row)
+            {
+                for (int64_t column = x1 / TileSize; column <= x2 / TileSize; ++column)
+                {
+                    if (command.primitive == DisplayList::Primitive::Line)
+                    {
+                        const int64_t left = column * TileSize - 1 - command.x1;
+                        const int64_t top = row * TileSize - 1 - command.y1;
+                        const int64_t right = left + TileSize + 1;
+                        const int64_t bottom = top + TileSize + 1;
+                        const auto [low, high] = std::minmax({dx * top - dy * left,
+                                                              dx * top - dy * right,
+                                                              dx * bottom - dy * left,
+                                                              dx * bottom - dy * right});
+
+                        if ((low > 0) || (high < 0))
+                            continue;
+                    }
+
+                    bins[row * columns + column].push_back(i);
+                }
+            }
         }
 
-        return false;
+        std::vector<int64_t> busy;
+
+        for (size_t i = 0; i < bins.size(); ++i)
+            if (!bins[i].empty())
+                busy.push_back(i);
+
+        // the tiles are handed out one by one, some of them have a lot more to draw than others
+        std::atomic<size_t> next(0);
+
+        implOwnData();
+        Common::ThreadPool::global().run(std::min<int64_t>(_threads, busy.size()),
+                                         [&](const int64_t)
+        {
+            for (size_t i = next++; i < busy.size(); i = next++)
+            {
+                const Tile tile = implTile(busy[i] % columns, busy[i] / columns);
+
+                for (const size_t command : bins[busy[i]])
+                    implDraw(commands[command], tile);
+            }
+        });
     }
 
     XImage *Base::cloneXImage(Display *display, Visual *visual) const noexcept
@@ -259,13 +632,18 @@ namespace Image
             {
                 size_t pos = 0;
 
-                for (auto &pixel : _data)
+                for (int64_t y = 0; y < _height; ++y)
                 {
-                    // XImage is bgra, also convert 16bit channel depth to 8bit
-                    raw[pos++] = pixel.bh;
-                    raw[pos++] = pixel.gh;
-                    raw[pos++] = pixel.rh;
-                    raw[pos++] = pixel.ah;
+                    for (int64_t x = 0; x < _width; ++x)
+                    {
+                        const RGBA pixel = implPixel(x, y);
+
+                        // XImage is bgra, also convert 16bit channel depth to 8bit
+                        raw[pos++] = pixel.bh;
+                        raw[pos++] = pixel.gh;
+                        raw[pos++] = pixel.rh;
+                        raw[pos++] = pixel.ah;
+                    }
                 }
 
                 return XCreateImage(display, visual, 24, ZPixmap, 0, raw, _width, _height, 32, 0);
@@ -277,388 +655,485 @@ namespace Image
 
     //--- protected methods ---
 
-    Base::RGBA Base::implPixel(const int64_t x, const int64_t y) const noexcept
+    int64_t Base::implIndex(const int64_t x, const int64_t y) const noexcept
     {
-        return _data[y * _width + x];
+        if (_layout == Layout::Tiled)
+            return Detail::tileIndex(x, y, _width, _height);
+
+        return y * _width + x;
     }
 
-    void Base::implSetPixel(const int64_t x, const int64_t y, const RGBA color) noexcept
+    Base::Tile Base::implTile(const int64_t column, const int64_t row) noexcept(false)
     {
-        _data[y * _width + x] = color;
+        const int64_t x = column * TileSize;
+        const int64_t y = row * TileSize;
+        const int64_t width = std::min(TileSize, _width - x);
+        const int64_t height = std::min(TileSize, _height - y);
+
+        // the callers made the pixels their own before, so this does not copy any more
+        RGBA *pixels = implOwnData().data() + implIndex(x, y);
+
+        if (_layout == Layout::Tiled)
+            return {x, y, width, height, width, pixels};
+
+        return {x, y, width, height, _width, pixels};
     }
 
-    void Base::implSetLine(int64_t x1, int64_t y1, int64_t x2, int64_t y2, const RGBA color)
-        noexcept
+    void Base::implLinear(const std::function<void ()> &job) noexcept(false)
     {
-        if ((x1 != x2) || (y1 != y2))
+        // everything not written for tiles gets to see the linear layout for the time being, which
+        // costs a tiled image two extra passes over the pixels
+        const Layout layout = _layout;
+
+        setLayout(Layout::Linear);
+        try
+        {
+            job();
+        }
+        catch (...)
         {
-            const int64_t delta_x = std::abs(x2 - x1);
-            const int64_t delta_y = -std::abs(y2 - y1);
-            const int64_t switch_x = x1 < x2 ? 1 : -1;
-            const int64_t switch_y = y1 < y2 ? 1 : -1;
-            int64_t error_val = delta_x + delta_y;
-            int64_t error2_val = 0;
+            setLayout(layout);
+            throw;
+        }
+        setLayout(layout);
+    }
 
-            while (true)
-            {
-                _data[y1 * _width + x1] = color;
-                if ((x1 == x2) && (y1 == y2))
-                    break;
+    Base::RGBA Base::implPixel(const int64_t x, const int64_t y) const noexcept
+    {
+        return implData()[implIndex(x, y)];
+    }
 
-                error2_val = 2 * error_val;
-                if (error2_val > delta_y)
-                {
-                    error_val += delta_y;
-                    x1 += switch_x;
-                }
-                if (error2_val < delta_x)
-                {
-                    error_val += delta_x;
-                    y1 += switch_y;
-                }
-            }
-        }
-        else
-            _data[y1 * _width + x1] = color;
+    void Base::implSetPixel(const int64_t x, const int64_t y, const RGBA color) noexcept(false)
+    {
+        implOwnData()[implIndex(x, y)] = color;
     }
 
-    void Base::implSetTriangle(const int64_t x1, const int64_t y1, const int64_t x2,
-                               const int64_t y2, const int64_t x3, const int64_t y3,
-                               const RGBA color, const bool fill) noexcept
+    void Base::implSetSpan(const int64_t x1, const int64_t x2, const int64_t y, const RGBA color)
+        noexcept(false)
     {
-        if (fill)
+        Pixels &data = implOwnData();
+
+        // a tiled row is only contiguous within each tile
+        for (int64_t x = x1; x <= x2;)
         {
-            const V2d p1(x1, y1);
-            const V2d p2(x2, y2);
-            const V2d p3(x3, y3);
-            const V2d p12(p2.x - p1.x, p2.y - p1.y);
-            const V2d p13(p3.x - p1.x, p3.y - p1.y);
-            const auto [minx, miny, maxx, maxy] = boundingBox(p1, p2, p3);
-            const auto cross_tmp = Math::crossProduct(p12, p13);
+            const int64_t last = _layout == Layout::Tiled ? std::min(x2, x | (TileSize - 1)) : x2;
 
-            for (int64_t y = miny; y <= maxy; ++y)
-            {
-                for (int64_t x = minx; x <= maxx; ++x)
-                {
-                    const V2d v(x - p1.x, y - p1.y);
-                    const double s = Math::crossProduct(v, p13) / cross_tmp;
-                    const double t = Math::crossProduct(p12, v) / cross_tmp;
+            std::fill_n(data.begin() + implIndex(x, y), last - x + 1, color);
+            x = last + 1;
+        }
+    }
 
-                    if ((s >= 0) && (t >= 0) && ((s + t) <= 1))
-                        _data[y * _width + x] = color;
-                }
-            }
+    void Base::implBlendSpan(const int64_t x1, const int64_t x2, const int64_t y, const RGBA color,
+                             const uint32_t coverage) noexcept(false)
+    {
+        const uint32_t alpha = (coverage * color.a + Detail::Opaque / 2) / Detail::Opaque;
+
+        if (alpha == Detail::Opaque)
+        {
+            implSetSpan(x1, x2, y, color);
+            return;
         }
-        else
+
+        Pixels &data = implOwnData();
+
+        for (int64_t x = x1; x <= x2;)
         {
-            implSetLine(x1, y1, x2, y2, color);
-            implSetLine(x1, y1, x3, y3, color);
-            implSetLine(x2, y2, x3, y3, color);
+            const int64_t last = _layout == Layout::Tiled ? std::min(x2, x | (TileSize - 1)) : x2;
+            RGBA *pixels = data.data() + implIndex(x, y);
+
+            for (int64_t i = 0; i <= last - x; ++i)
+                pixels[i] = Detail::blend(pixels[i], color, alpha);
+            x = last + 1;
         }
     }
 
-    void Base::implSetRectangle(const int64_t x1, const int64_t y1, const int64_t x2,
-                                const int64_t y2, const RGBA color, const bool fill) noexcept
+    void Base::implSetLine(int64_t x1, int64_t y1, int64_t x2, int64_t y2, const RGBA color)
+        noexcept(false)
     {
-        const auto [xx1, xx2] = T::minMax(x1, x2);
-        const auto [yy1, yy2] = T::minMax(y1, y2);
+        // the shapes are drawn through callbacks that must not throw, so the pixels become our
+        // own before, this is the only place that allocates
+        implOwnData();
+        Detail::drawLine(x1, y1, x2, y2, [&](const int64_t x, const int64_t y)
+        {
+            implSetPixel(x, y, color);
+        },
+        toClip(clip()));
+    }
 
-        if (fill)
+    void Base::implSetTriangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                               const int64_t y2, const int64_t x3, const int64_t y3,
+                               const RGBA color, const bool fill) noexcept(false)
+    {
+        implOwnData();
+        Detail::drawTriangle(x1, y1, x2, y2, x3, y3, fill, [&](const int64_t x, const int64_t y)
         {
-            int64_t ypos = 0;
+            implSetPixel(x, y, color);
+        },
+        [&](const int64_t first, const int64_t last, const int64_t y)
+        {
+            implSetSpan(first, last, y, color);
+        },
+        toClip(clip()));
+    }
 
-            for (int64_t y = yy1; y < yy2; ++y)
-            {
-                ypos = y * _width;
-                std::fill(_data.begin() + ypos + xx1, _data.begin() + ypos + xx2 + 1, color);
-            }
-        }
-        else
+    void Base::implSetRectangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                                const int64_t y2, const RGBA color, const bool fill)
+        noexcept(false)
+    {
+        implOwnData();
+        Detail::drawRectangle(x1, y1, x2, y2, fill, [&](const int64_t x, const int64_t y)
+        {
+            implSetPixel(x, y, color);
+        },
+        [&](const int64_t first, const int64_t last, const int64_t y)
         {
-            int64_t ypos = yy1 * _width;
+            implSetSpan(first, last, y, color);
+        },
+        toClip(clip()));
+    }
 
-            std::fill(_data.begin() + ypos + xx1, _data.begin() + ypos + xx2 + 1, color);
-            for (int64_t y = yy1; y <= yy2; ++y)
-            {
-                ypos = y * _width;
-                _data[ypos + xx1] = color;
-                _data[ypos + xx2] = color;
-            }
-            ypos = yy2 * _width;
-            std::fill(_data.begin() + ypos + xx1, _data.begin() + ypos + xx2 + 1, color);
-        }
+    void Base::implSetEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                              const int64_t radius_y, const RGBA color, const bool fill)
+        noexcept(false)
+    {
+        implOwnData();
+        Detail::drawEllipse(x, y, radius_x, radius_y, fill,
+                            [&](const int64_t first, const int64_t last, const int64_t yy)
+        {
+            implSetSpan(first, last, yy, color);
+        },
+        toClip(clip()));
     }
 
-    void Base::implSetCircle(const int64_t x, const int64_t y, const int64_t radius,
-                             const RGBA color, const bool fill) noexcept
+    void Base::implSetSmoothLine(const double x1, const double y1, const double x2,
+                                 const double y2, const RGBA color) noexcept(false)
     {
-        const int64_t rad = std::abs(radius);
+        implOwnData();
+        Detail::drawSmoothLine(x1, y1, x2, y2, [&](const int64_t x, const int64_t y,
+                                                   const uint32_t coverage)
+        {
+            implBlendSpan(x, x, y, color, coverage);
+        },
+        toClip(clip()));
+    }
 
-        if (((x + rad) > _width) || ((y + rad) > _height) || ((x - rad) < 0) || ((y - rad) < 0))
-            return;
+    void Base::implSetSmoothPolygon(const std::vector<Affine::V2d> &points, const RGBA color)
+        noexcept(false)
+    {
+        implOwnData();
+        Detail::fillSmoothPolygon(points, [&](const int64_t first, const int64_t last,
+                                              const int64_t y, const uint32_t coverage)
+        {
+            implBlendSpan(first, last, y, color, coverage);
+        },
+        toClip(clip()));
+    }
+
+    bool Base::implAccepts(const DisplayList::Command &command) const noexcept
+    {
+        // the checks of the drawing methods
+        const Detail::Clip clip = toClip(this->clip());
 
-        if (radius != 0)
+        switch (command.primitive)
         {
-            const int64_t ypos = y * _width;
-            int64_t delta_ypos = 0;
-            int64_t f = 1 - rad;
-            int64_t delta_x = 0;
-            int64_t delta_y = -2 * rad;
-            int64_t xx = 0;
-            int64_t yy = rad;
+            case DisplayList::Primitive::Line:
+                return Detail::acceptsLine(clip, command.x1, command.y1, command.x2, command.y2);
 
-            _data[ypos + x + rad] = color;
-            _data[ypos + x - rad] = color;
-            if (!fill)
-            {
-                _data[ypos + (rad * _width) + x] = color;
-                _data[ypos - (rad * _width) + x] = color;
-            }
-            else
-                implSetLine(x - rad, y, x + rad, y, color);
+            case DisplayList::Primitive::Triangle:
+                return Detail::acceptsTriangle(clip, command.x1, command.y1, command.x2,
+                                               command.y2, command.x3, command.y3);
 
-            if (fill)
-            {
-                while (xx < yy)
-                {
-                    if (f >= 0)
-                    {
-                        --yy;
-                        delta_y += 2;
-                        f += delta_y;
-                    }
-                    ++xx;
-                    delta_x += 2;
-                    f += delta_x + 1;
-
-                    implSetLine(x - xx, y + yy, x + xx, y + yy, color);
-                    implSetLine(x - xx, y - yy, x + xx, y - yy, color);
-                    implSetLine(x - yy, y + xx, x + yy, y + xx, color);
-                    implSetLine(x - yy, y - xx, x + yy, y - xx, color);
-                }
-            }
-            else
+            case DisplayList::Primitive::Circle:
+            case DisplayList::Primitive::Ellipse:
+                return Detail::acceptsEllipse(clip, command.x1, command.y1, command.x2,
+                                              command.y2);
+
+            default:
             {
-                while (xx < yy)
-                {
-                    if (f >= 0)
-                    {
-                        --yy;
-                        delta_y += 2;
-                        f += delta_y;
-                    }
-                    ++xx;
-                    delta_x += 2;
-                    f += delta_x + 1;
-
-                    delta_ypos = yy * _width;
-                    _data[ypos + delta_ypos + x + xx] = color;
-                    _data[ypos + delta_ypos + x - xx] = color;
-                    _data[ypos - delta_ypos + x + xx] = color;
-                    _data[ypos - delta_ypos + x - xx] = color;
-                    delta_ypos = ypos + (xx * _width);
-                    _data[delta_ypos + x + yy] = color;
-                    _data[delta_ypos + x - yy] = color;
-                    delta_ypos = ypos - (xx * _width);
-                    _data[delta_ypos + x + yy] = color;
-                    _data[delta_ypos + x - yy] = color;
-                }
+                const auto [x1, y1, x2, y2] = bounds(command);
+
+                return Detail::touches(clip, x1, y1, x2, y2);
             }
         }
-        else
-            _data[y * _width + x] = color;
-    }
-
-    Base::Pixels Base::implFilter(const Pixels &pixels, const int64_t width, const int64_t height,
-                                  const Filter filter) const noexcept(false)
-    {
-        Pixels result(width * height, RGBA::Black);
-        std::vector<int64_t> indices = {-(width + 1), -width, -(width - 1),
-                                        -1 , 0, 1,
-                                        width - 1, width, width + 1};
-        std::vector<float> kernel;
-        RGBA pixel;
-        int64_t pos = 0;
-        int64_t int_r = 0;
-        int64_t int_g = 0;
-        int64_t int_b = 0;
-        float factor = .0;
-        float red = .0;
-        float green = .0;
-        float blue = .0;
-
-        switch (filter)
-        {
-            case Filter::Smooth:
-                kernel = {1, 1, 1,
-                          1, 2, 1,
-                          1, 1, 1};
+    }
+
+    void Base::implDraw(const DisplayList::Command &command, const Tile &tile) noexcept
+    {
+        // the part of the clip rectangle in the tile, nothing outside of it is written
+        const Detail::Clip image = toClip(clip());
+        const Detail::Clip clip = {std::max(image.x1, tile.x), std::max(image.y1, tile.y),
+                                   std::min(image.x2, tile.x + tile.width),
+                                   std::min(image.y2, tile.y + tile.height)};
+        const RGBA color = command.color;
+        auto plot = [&](const int64_t x, const int64_t y)
+        {
+            tile.pixels[(y - tile.y) * tile.stride + x - tile.x] = color;
+        };
+        auto span = [&](const int64_t x1, const int64_t x2, const int64_t y)
+        {
+            std::fill_n(tile.pixels + (y - tile.y) * tile.stride + x1 - tile.x, x2 - x1 + 1,
+                        color);
+        };
+
+        switch (command.primitive)
+        {
+            case DisplayList::Primitive::Pixel:
+                if (Detail::touches(clip, command.x1, command.y1, command.x1, command.y1))
+                    plot(command.x1, command.y1);
                 break;
 
-            case Filter::Sharpen:
-                kernel = {-1, -1, -1,
-                          -1, 9, -1,
-                          -1, -1, -1};
+            case DisplayList::Primitive::Line:
+                Detail::drawLine(command.x1, command.y1, command.x2, command.y2, plot, clip);
                 break;
 
-            case Filter::Edge:
-                kernel = {-1, -1, -1,
-                          -1, 8, -1,
-                          -1, -1, -1};
+            case DisplayList::Primitive::Triangle:
+                Detail::drawTriangle(command.x1, command.y1, command.x2, command.y2, command.x3,
+                                     command.y3, command.fill, plot, span, clip);
                 break;
 
-            case Filter::Blur:
-                kernel = {0, 0, 1,
-                          0, 0, 0,
-                          1, 0, 0};
+            case DisplayList::Primitive::Rectangle:
+                Detail::drawRectangle(command.x1, command.y1, command.x2, command.y2,
+                                      command.fill, plot, span, clip);
                 break;
 
-            case Filter::Raised:
-                kernel = {0, 0, -2,
-                          0, 2, 0,
-                          1, 0, 0};
+            case DisplayList::Primitive::Circle:
+            case DisplayList::Primitive::Ellipse:
+                Detail::drawEllipse(command.x1, command.y1, command.x2, command.y2, command.fill,
+                                    span, clip);
                 break;
         }
+    }
 
-        for (auto k : kernel)
-            factor += k;
+    void Base::implFilter(const Filter filter) noexcept(false)
+    {
+        if (_layout == Layout::Tiled)
+            return implFilterTiles(filter);
 
-        if (factor == .0)
-            factor = 1.0;
+        Detail::filter(filter, implOwnData().data(), _width, _height, _width, _threads);
+    }
 
-        for (int64_t y = 1; y < (height - 1); ++y)
+    void Base::implFilterTiles(const Filter filter) noexcept(false)
+    {
+        const int64_t columns = (_width + TileSize - 1) / TileSize;
+        const int64_t rows = (_height + TileSize - 1) / TileSize;
+        const int64_t bands = std::clamp<int64_t>(_threads, 1, rows);
+        RGBA *pixels = implOwnData().data();
+        Pixels edges(bands * 2 * _width, _resource);
+        auto &pool = Common::ThreadPool::global();
+
+        // the image row y from x - 1 to x + width, clamped to the image, as a padded tile row
+        auto gather = [&](RGBA *line, const RGBA *row, const int64_t x, const int64_t width)
         {
-            for (int64_t x = 1; x < (width - 1); ++x)
-            {
-                red = .0;
-                green = .0;
-                blue = .0;
-                pos = y * width + x;
+            line[0] = row[std::max<int64_t>(x - 1, 0)];
+            std::copy_n(row + x, width, line + 1);
+            line[width + 1] = row[std::min(x + width, _width - 1)];
+        };
+
+        // the tiles are filtered in place with a halo of one pixel read from their neighbours,
+        // a band goes through its tile rows from top to bottom and every tile row from left to
+        // right, so the neighbours below and to the right are still untouched, the ones above and
+        // to the left keep copies of their original edges, only the rows just outside of a band
+        // belong to other bands (or the border) and are saved before anyone writes
+        pool.run(bands, [&](const int64_t band)
+        {
+            const int64_t first = std::max<int64_t>(rows * band / bands * TileSize - 1, 0);
+            const int64_t last = std::min(rows * (band + 1) / bands * TileSize, _height - 1);
 
-                for (size_t k = 0; k < kernel.size(); ++k)
-                {
-                    pixel = pixels[pos + indices[k]];
-                    red += pixel.r * kernel[k];
-                    green += pixel.g * kernel[k];
-                    blue += pixel.b * kernel[k];
-                }
+            for (int64_t x = 0; x < _width; x += TileSize)
+            {
+                const int64_t count = std::min(TileSize, _width - x);
 
-                int_r = red / factor;
-                int_g = green / factor;
-                int_b = blue / factor;
-
-                // clamping min and max values (internal rgba data is 16bit per channel)
-                if (int_r > 0xFFFF)
-                    int_r = 0xFFFF;
-                else if (int_r < 0)
-                    int_r = 0;
-
-                if (int_g > 0xFFFF)
-                    int_g = 0xFFFF;
-                else if (int_g < 0)
-                    int_g = 0;
-
-                if (int_b > 0xFFFF)
-                    int_b = 0xFFFF;
-                else if (int_b < 0)
-                    int_b = 0;
-
-                result[pos].r = int_r;
-                result[pos].g = int_g;
-                result[pos].b = int_b;
-                result[pos].a = pixels[pos].a;
+                std::copy_n(pixels + implIndex(x, first), count,
+                            edges.begin() + band * 2 * _width + x);
+                std::copy_n(pixels + implIndex(x, last), count,
+                            edges.begin() + (band * 2 + 1) * _width + x);
             }
-        }
-
-        return result;
-    }
-
-    bool Base::implResize(const int64_t width, const int64_t height, const Scaler scaler)
-        noexcept(false)
-    {
-        if ((width < 3) || (height < 3)) // scaling that low is useless
-            return false;
-
-        const int64_t min_width = std::min(_width, width);
-        const int64_t min_height = std::min(_height, height);
-        // to stay with integer math I need a little trick here, hope noone ever tries to
-        // scale beyond 2^47 pixels :D
-        const int64_t column_ratio = ((_width - 1) << 16) / width;
-        const int64_t row_ratio = ((_height - 1) << 16) / height;
-        Pixels pixels(width * height, RGBA::Black);
+        });
 
-        switch (scaler)
+        pool.run(bands, [&](const int64_t band)
         {
-            case Scaler::FastBillinear:
+            const int64_t begin = rows * band / bands;
+            const int64_t end = rows * (band + 1) / bands;
+            const RGBA *below_end = edges.data() + (band * 2 + 1) * _width;
+            Pixels above(edges.begin() + band * 2 * _width, edges.begin() + (band * 2 + 1) * _width,
+                         _resource);
+            Pixels next_above(_width, _resource);
+            Pixels left(TileSize, _resource);
+            Pixels next_left(TileSize, _resource);
+            Pixels ring(3 * (TileSize + 2), _resource);
+
+            for (int64_t row = begin; row < end; ++row)
             {
-                for (int64_t row = 0; row < height; ++row)
+                for (int64_t column = 0; column < columns; ++column)
                 {
-                    const int64_t p_row = (row * row_ratio) >> 16;
-                    const int64_t pos = p_row * _width;
+                    const Tile tile = implTile(column, row);
+                    const int64_t padded = tile.width + 2;
+                    const bool right = tile.x + tile.width < _width;
+                    const Tile next = right ? implTile(column + 1, row) : tile;
 
-                    for (int64_t column = 0; column < width; ++column)
+                    // the tile row y from the tile itself and the columns next to it
+                    auto build = [&](RGBA *line, const int64_t y)
                     {
-                        const int64_t p_column = (column * column_ratio) >> 16;
-                        const RGBA p1 = _data[pos + p_column];
-                        const RGBA p2 = _data[pos + p_column + 1];
-                        const RGBA p3 = _data[pos + p_column + _width];
-                        const RGBA p4 = _data[pos + p_column + _width + 1];
-
-                        pixels[row * width + column].set((p1.r + p2.r + p3.r + p4.r) >> 2,
-                                                         (p1.g + p2.g + p3.g + p4.g) >> 2,
-                                                         (p1.b + p2.b + p3.b + p4.b) >> 2,
-                                                         (p1.a + p2.a + p3.a + p4.a) >> 2);
-                    }
-                }
+                        const RGBA *source = tile.pixels + y * tile.stride;
 
-                break;
-            }
+                        line[0] = tile.x > 0 ? left[y] : source[0];
+                        std::copy_n(source, tile.width, line + 1);
+                        line[padded - 1] = right ? next.pixels[y * next.stride]
+                                                 : source[tile.width - 1];
+                    };
 
-            case Scaler::Nearest:
-            {
-                for (int64_t row = 0; row < height; ++row)
-                {
-                    const int64_t p_row = (row * row_ratio) >> 16;
-                    const int64_t pos1 = row * width;
-                    const int64_t pos2 = p_row * _width;
+                    // the first row of the tile below, the band below may have written it already
+                    auto build_below = [&](RGBA *line)
+                    {
+                        const int64_t y = tile.y + tile.height;
 
-                    for (int64_t column = 0; column < width; ++column)
+                        if ((row + 1 == end) || (y == _height))
+                            return gather(line, below_end, tile.x, tile.width);
+
+                        line[0] = pixels[implIndex(std::max<int64_t>(tile.x - 1, 0), y)];
+                        std::copy_n(pixels + implIndex(tile.x, y), tile.width, line + 1);
+                        line[padded - 1] = pixels[implIndex(std::min(tile.x + tile.width,
+                                                                     _width - 1), y)];
+                    };
+
+                    // what the tiles to the right and below still need of this one
+                    for (int64_t y = 0; y < tile.height; ++y)
+                        next_left[y] = tile.pixels[y * tile.stride + tile.width - 1];
+                    std::copy_n(tile.pixels + (tile.height - 1) * tile.stride, tile.width,
+                                next_above.begin() + tile.x);
+
+                    RGBA *lines[3] = {ring.data(), ring.data() + padded, ring.data() + 2 * padded};
+
+                    gather(lines[0], above.data(), tile.x, tile.width);
+                    build(lines[1], 0);
+                    for (int64_t y = 0; y < tile.height; ++y)
                     {
-                        const int64_t p_column = (column * column_ratio) >> 16;
-                        pixels[pos1 + column] = _data[pos2 + p_column];
+                        RGBA *dst = tile.pixels + y * tile.stride;
+
+                        if (y + 1 < tile.height)
+                            build(lines[2], y + 1);
+                        else
+                            build_below(lines[2]);
+
+                        if ((tile.y + y == 0) || (tile.y + y == _height - 1))
+                            std::fill_n(dst, tile.width, RGBA::Black);
+                        else
+                        {
+                            // only out[1] to out[padded - 2] are written, which is exactly the
+                            // tile row, dst - 1 itself is never touched
+                            Detail::filterRow(filter, lines[0], lines[1], lines[2], dst - 1,
+                                              padded);
+                            if (tile.x == 0)
+                                dst[0] = RGBA::Black;
+                            if (!right)
+                                dst[tile.width - 1] = RGBA::Black;
+                        }
+                        std::rotate(lines, lines + 1, lines + 3);
                     }
+                    std::swap(left, next_left);
                 }
-
-                break;
+                std::swap(above, next_above);
             }
+        });
+    }
 
-            case Scaler::Keep:
-                for (int64_t row = 0; row < min_height; ++row)
-                    for (int64_t column = 0; column < min_width; ++column)
-                        pixels[row * width + column] = _data[row * _width + column];
-                break;
+    bool Base::implResize(const int64_t width, const int64_t height, const Scaler scaler)
+        noexcept(false)
+    {
+        if ((width < 3) || (height < 3)) // scaling that low is useless
+            return false;
 
-            case Scaler::Clear:
-            default:
-                break;
+        if (_layout != Layout::Linear)
+        {
+            bool result = false;
+
+            implLinear([&]()
+            {
+                result = implResize(width, height, scaler);
+            });
+
+            return result;
         }
 
-        implReplace(pixels, width, height);
+        Pixels pixels(width * height, RGBA::Black, _resource);
+
+        MutableImageView(pixels.data(), width, height, width).resample(view(), scaler, _threads);
+        implReplace(std::move(pixels), width, height);
 
         return true;
     }
 
-    void Base::implReplace(const Pixels &pixels, const int64_t width, const int64_t height) noexcept
+    void Base::implTranspose(const bool mirror_rows, const bool mirror_columns) noexcept(false)
     {
-        _data = pixels;
-        _width = width;
-        _height = height;
+        implLinear([&]()
+        {
+            Pixels pixels(_width * _height, _resource);
+
+            Detail::transpose(implData().data(), _width, _height, _width, pixels.data(), _height,
+                              mirror_rows, mirror_columns, _threads);
+            implReplace(std::move(pixels), _height, _width);
+        });
     }
 
-    void Base::implReplace(Pixels &&pixels, const int64_t width, const int64_t height) noexcept
+    void Base::implReplace(const Pixels &pixels, const int64_t width, const int64_t height)
+        noexcept(false)
+    {
+        implReplace(Pixels(pixels, _resource), width, height);
+    }
+
+    void Base::implReplace(Pixels &&pixels, const int64_t width, const int64_t height)
+        noexcept(false)
     {
-        _data = std::move(pixels);
+        const Layout layout = _layout;
+
+        // the new pixels come row by row, but the layout stays
+        _data = std::make_shared<Pixels>(std::move(pixels));
         _width = width;
         _height = height;
+        _layout = Layout::Linear;
+        setLayout(layout);
+    }
+
+    void Base::implShare(const Base &rhs) noexcept
+    {
+        // the pixels of any other image, whatever format it is, without copying them
+        _data = rhs._data;
+        _width = rhs._width;
+        _height = rhs._height;
+        _layout = rhs._layout;
+    }
+
+    const Base::Pixels &Base::implData() const noexcept
+    {
+        static const Pixels none;
+
+        return _data ? *_data : none;
+    }
+
+    std::shared_ptr<const Base::Pixels> Base::implRows() const noexcept(false)
+    {
+        // the writers want the pixels row by row, a tiled image hands out a linear copy of them
+        if (!_data || (_layout == Layout::Linear))
+            return _data ? _data : std::make_shared<const Pixels>();
+
+        auto rows = std::make_shared<Pixels>(_data->size(), _resource);
+
+        Detail::fromTiles(_data->data(), rows->data(), _width, _height, _threads);
+
+        return rows;
+    }
+
+    Base::Pixels &Base::implOwnData() noexcept(false)
+    {
+        // the first change of shared pixels makes a copy of its own, when nobody else holds them
+        // any more the fence keeps the writes here behind the last reads of the former sharers
+        if (!_data)
+            _data = std::make_shared<Pixels>(_resource);
+        else if (_data.use_count() > 1)
+            _data = std::make_shared<Pixels>(*_data, _resource);
+        else
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+        return *_data;
     }
 }
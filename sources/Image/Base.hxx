@@ -1,11 +1,20 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <X11/Xlib.h>
 #include "Color/Color.hxx"
 #include "Common/Concepts.hxx"
+#include "Affine.hxx"
+#include "DisplayList.hxx"
+#include "ImageView.hxx"
+#include "Kernel.hxx"
+#include "Planar.hxx"
+#include "Pyramid.hxx"
 
 namespace Image
 {
@@ -15,14 +24,31 @@ namespace Image
         Sharpen,
         Edge,
         Blur,
-        Raised
+        Raised,
+        BoxBlur,
+        GaussianBlur
+    };
+
+    enum class Border : int16_t {
+        Clamp,
+        Wrap,
+        Mirror
     };
 
     enum class Scaler : int16_t {
         Clear,
         Keep,
         Nearest,
-        FastBillinear
+        FastBillinear,
+        Bilinear,
+        Bicubic,
+        Lanczos3,
+        Area
+    };
+
+    enum class Layout : int16_t {
+        Linear, // row by row
+        Tiled   // in squares of TileSize pixels, so vertical neighbours stay close in memory
     };
 
     enum class Quantizer : int16_t {
@@ -33,16 +59,51 @@ namespace Image
     // Base Image class - provides all the pixel manipulation methods, an interface every derived
     //                    class has to follow and holds the actual image data
     //
+    // - copies share the pixels until one of them changes them, every buffer comes from the memory
+    //   resource of the image, a mutable view taken before copying still writes into the shared
+    //   buffer, so take views after copying
+    // - drawing is clipped to the clip rectangle, shapes missing it or reaching too far out (see
+    //   Detail::GuardBand and Detail::MaxRadius) are refused, the smooth ones blend by coverage
+    // - the rotations turn clockwise, warp() and rotate() know Nearest and the bilinear scalers
+    // - pixel access, drawing and the 3x3 filters work on tiles, the rest goes through implLinear()
+    //
     class Base {
     public:
         //--- public types and constants ---
         using RGBA = Color::RGBA16161616;
-        using Pixels = std::vector<RGBA>;
+        using Pixels = std::pmr::vector<RGBA>;
+
+        static constexpr int64_t TileSize = 64;
+
+        //
+        // Tile - a rectangle of at most TileSize x TileSize pixels whose rows are stride pixels
+        //        apart, in the linear layout that is the width of the image
+        //
+        struct Tile {
+            int64_t x;
+            int64_t y;
+            int64_t width;
+            int64_t height;
+            int64_t stride;
+            RGBA *pixels;
+        };
+
+        using TileJob = std::function<void (const Tile &)>;
+
+        // Rect - a rectangle of pixels, (x, y) is its top left corner
+        struct Rect {
+            int64_t x;
+            int64_t y;
+            int64_t width;
+            int64_t height;
+        };
 
         //--- public constructors ---
         Base() noexcept;
-        Base(const int64_t width, const int64_t height, const RGBA color) noexcept(false);
-        Base(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        Base(const int64_t width, const int64_t height, const RGBA color,
+             const Layout layout = Layout::Linear) noexcept(false);
+        Base(const Pixels &pixels, const int64_t width, const int64_t height,
+             const Layout layout = Layout::Linear) noexcept(false);
         Base(const Base &rhs) noexcept(false);
         Base(Base &&rhs) noexcept;
         virtual ~Base() noexcept;
@@ -56,23 +117,60 @@ namespace Image
         //--- public methods ---
         int64_t width() const noexcept;
         int64_t height() const noexcept;
-        const Pixels &pixels() const noexcept;
+        int64_t threads() const noexcept;
+        void setThreads(const int64_t threads = 0) noexcept;
+        Layout layout() const noexcept;
+        void setLayout(const Layout layout) noexcept(false);
+        std::pmr::memory_resource *memoryResource() const noexcept;
+        void setMemoryResource(std::pmr::memory_resource *resource) noexcept(false);
+        const Pixels &pixels() const noexcept(false);
+        ImageView view() const noexcept(false);
+        ImageView view(const int64_t x, const int64_t y, const int64_t width,
+                       const int64_t height) const noexcept(false);
+        MutableImageView mutableView() noexcept(false);
+        MutableImageView mutableView(const int64_t x, const int64_t y, const int64_t width,
+                                     const int64_t height) noexcept(false);
+        void forEachTile(const TileJob &job) noexcept(false);
         int64_t usedColors() const noexcept(false);
         void flipVertical() noexcept(false);
         void flipHorizontal() noexcept(false);
-        bool filter(const Filter filter) noexcept(false);
+        void rotate90() noexcept(false);
+        void rotate180() noexcept(false);
+        void rotate270() noexcept(false);
+        void transpose() noexcept(false);
+        bool filter(const Filter filter, const int64_t radius = 1) noexcept(false);
+        bool convolve(const Kernel &kernel, const Border border = Border::Clamp) noexcept(false);
         bool reduceColors(const int64_t colors, const Quantizer quantizer) noexcept(false);
+        bool warp(const Affine &affine, const int64_t width, const int64_t height,
+                  const Scaler scaler = Scaler::Bilinear,
+                  const RGBA background = RGBA(RGBA::Black)) noexcept(false);
+        bool rotate(const double degrees, const Scaler scaler = Scaler::Bilinear,
+                    const RGBA background = RGBA(RGBA::Black)) noexcept(false);
+        Pyramid buildPyramid() const noexcept(false);
+        Planar toPlanar() const noexcept(false);
+        bool fromPlanar(const Planar &planar) noexcept(false);
         RGBA pixel(const int64_t x, const int64_t y) const noexcept(false);
-        bool setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept;
+        Rect clip() const noexcept;
+        bool setClip(const int64_t x, const int64_t y, const int64_t width, const int64_t height)
+            noexcept;
+        void resetClip() noexcept;
+        bool setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept(false);
         bool setLine(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
-                     const RGBA color) noexcept;
+                     const RGBA color) noexcept(false);
         bool setTriangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
                          const int64_t x3, const int64_t y3, const RGBA color, const bool fill)
-            noexcept;
+            noexcept(false);
         bool setRectangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
-                          const RGBA color, const bool fill) noexcept;
+                          const RGBA color, const bool fill) noexcept(false);
         bool setCircle(const int64_t x, const int64_t y, const int64_t radius, const RGBA color,
-                       const bool fill) noexcept;
+                       const bool fill) noexcept(false);
+        bool setEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                        const int64_t radius_y, const RGBA color, const bool fill) noexcept(false);
+        bool setSmoothLine(const double x1, const double y1, const double x2, const double y2,
+                           const RGBA color) noexcept(false);
+        bool setSmoothPolygon(const std::vector<Affine::V2d> &points, const RGBA color)
+            noexcept(false);
+        void draw(const DisplayList &list) noexcept(false);
         XImage *cloneXImage(Display *display, Visual *visual) const noexcept;
 
         virtual bool valid() const noexcept(false) = 0;
@@ -83,27 +181,53 @@ namespace Image
 
     protected:
         //--- protected methods ---
+        int64_t implIndex(const int64_t x, const int64_t y) const noexcept;
+        Tile implTile(const int64_t column, const int64_t row) noexcept(false);
+        void implLinear(const std::function<void ()> &job) noexcept(false);
         RGBA implPixel(const int64_t x, const int64_t y) const noexcept;
-        void implSetPixel(const int64_t x, const int64_t y, const RGBA color) noexcept;
-        void implSetLine(int64_t x1, int64_t y1, int64_t x2, int64_t y2, const RGBA color) noexcept;
+        void implSetPixel(const int64_t x, const int64_t y, const RGBA color) noexcept(false);
+        void implSetSpan(const int64_t x1, const int64_t x2, const int64_t y, const RGBA color)
+            noexcept(false);
+        void implBlendSpan(const int64_t x1, const int64_t x2, const int64_t y, const RGBA color,
+                           const uint32_t coverage) noexcept(false);
+        void implSetLine(int64_t x1, int64_t y1, int64_t x2, int64_t y2, const RGBA color)
+            noexcept(false);
         void implSetTriangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
                              const int64_t x3, const int64_t y3, const RGBA color, const bool fill)
-            noexcept;
+            noexcept(false);
         void implSetRectangle(const int64_t x1, const int64_t y1, const int64_t x2,
-                              const int64_t y2, const RGBA color, const bool fill) noexcept;
-        void implSetCircle(const int64_t x, const int64_t y, const int64_t radius, const RGBA color,
-                           const bool fill) noexcept;
-        Pixels implFilter(const Pixels &pixels, const int64_t width, const int64_t height,
-                          const Filter filter) const noexcept(false);
+                              const int64_t y2, const RGBA color, const bool fill) noexcept(false);
+        void implSetEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                            const int64_t radius_y, const RGBA color, const bool fill)
+            noexcept(false);
+        void implSetSmoothLine(const double x1, const double y1, const double x2, const double y2,
+                               const RGBA color) noexcept(false);
+        void implSetSmoothPolygon(const std::vector<Affine::V2d> &points, const RGBA color)
+            noexcept(false);
+        bool implAccepts(const DisplayList::Command &command) const noexcept;
+        void implDraw(const DisplayList::Command &command, const Tile &tile) noexcept;
+        void implFilter(const Filter filter) noexcept(false);
+        void implFilterTiles(const Filter filter) noexcept(false);
         bool implResize(const int64_t width, const int64_t height, const Scaler scaler)
             noexcept(false);
-        void implReplace(const Pixels &pixels, const int64_t width, const int64_t height) noexcept;
-        void implReplace(Pixels &&pixels, const int64_t width, const int64_t height) noexcept;
+        void implTranspose(const bool mirror_rows, const bool mirror_columns) noexcept(false);
+        void implReplace(const Pixels &pixels, const int64_t width, const int64_t height)
+            noexcept(false);
+        void implReplace(Pixels &&pixels, const int64_t width, const int64_t height)
+            noexcept(false);
+        void implShare(const Base &rhs) noexcept;
+        const Pixels &implData() const noexcept;
+        std::shared_ptr<const Pixels> implRows() const noexcept(false);
+        Pixels &implOwnData() noexcept(false);
 
     private:
         //--- private properties ---
-        Pixels _data;
+        std::shared_ptr<Pixels> _data;
         int64_t _width;
         int64_t _height;
+        int64_t _threads;
+        Layout _layout;
+        Rect _clip;
+        std::pmr::memory_resource *_resource;
     };
 }
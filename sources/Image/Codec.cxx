@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <stdexcept>
+#include "Codec.hxx"
+#include "Compact.hxx"
+#include "Farbfeld.hxx"
+#include "Indexed.hxx"
+#include "PPM.hxx"
+#include "Simple00.hxx"
+#include "Simple01.hxx"
+#include "Simple02.hxx"
+#include "Targa.hxx"
+
+namespace Image::Codecs
+{
+    //--- internal stuff ---
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<Codec> codecs;
+    };
+
+    static inline std::string lower(std::string str) noexcept(false)
+    {
+        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+
+        return str;
+    }
+
+    static bool flag(const CodecOptions &options, const std::string &key, const bool standard)
+        noexcept(false)
+    {
+        const auto it = options.find(key);
+
+        if (it == options.end())
+            return standard;
+
+        const std::string value = lower(it->second);
+
+        if ((value == "yes") || (value == "true") || (value == "1"))
+            return true;
+        if ((value == "no") || (value == "false") || (value == "0"))
+            return false;
+
+        throw std::invalid_argument("option '" + key + "' has to be yes or no");
+    }
+
+    static void configurePPM(PPM &image, const CodecOptions &options) noexcept(false)
+    {
+        image.setBinaryMode(flag(options, "binary", image.binaryMode()));
+        image.setWideMode(flag(options, "wide", image.wideMode()));
+        if (const auto it = options.find("comment"); it != options.end())
+            image.setComment(it->second);
+    }
+
+    static void configureTarga(Targa &image, const CodecOptions &options) noexcept(false)
+    {
+        using IT = Targa::ImageType;
+
+        static const std::map<std::string,IT> types = {
+            {"truecolor", IT::Truecolor}, {"mapped", IT::Mapped}, {"mono", IT::Mono},
+            {"truecolor-rle", IT::TruecolorRLE}, {"mapped-rle", IT::MappedRLE},
+            {"mono-rle", IT::MonoRLE}
+        };
+
+        if (const auto it = options.find("type"); it != options.end())
+        {
+            const auto type = types.find(lower(it->second));
+
+            if (type == types.end())
+                throw std::invalid_argument("unknown targa type '" + it->second + "'");
+
+            image.setImageType(type->second);
+        }
+    }
+
+    // the format classes are the codecs, converting into one of them only shares the pixels
+    template <typename Format>
+    static Codec builtin(const std::string &name, const std::vector<std::string> &extensions,
+                         void (*configure)(Format &, const CodecOptions &) = nullptr)
+        noexcept(false)
+    {
+        Codec codec = {name, extensions,
+        [](const std::string &filename)
+        {
+            return Format::identify(filename);
+        },
+        [](const std::string &filename, std::pmr::memory_resource *resource)
+            -> std::unique_ptr<Base>
+        {
+            auto image = std::make_unique<Format>();
+
+            image->setMemoryResource(resource);
+
+            if (!image->load(filename))
+                return nullptr;
+
+            return image;
+        },
+        [configure](const Base &image, const std::string &filename, const CodecOptions &options)
+        {
+            Format out(image);
+
+            // the writers go through the pixels row by row
+            out.setLayout(Layout::Linear);
+            if (configure)
+                configure(out, options);
+
+            return out.save(filename);
+        }, nullptr, nullptr, nullptr};
+
+        // only the formats able to load 8 bit data as it is offer it
+        if constexpr (requires (Format format, Compact &image) { format.loadCompact("", image); })
+        {
+            codec.decodeCompact = [](const std::string &filename, Compact &image)
+            {
+                return Format().loadCompact(filename, image);
+            };
+        }
+
+        // the same for the formats able to keep palette indices
+        if constexpr (requires (Format format, Indexed<uint8_t> &image)
+                      { format.loadIndexed("", image); format.saveIndexed("", image); })
+        {
+            codec.decodeIndexed = [](const std::string &filename, Indexed<uint8_t> &image)
+            {
+                return Format().loadIndexed(filename, image);
+            };
+            codec.encodeIndexed = [configure](const Indexed<uint8_t> &image,
+                                              const std::string &filename,
+                                              const CodecOptions &options)
+            {
+                Format out;
+
+                if (configure)
+                    configure(out, options);
+
+                return out.saveIndexed(filename, image);
+            };
+        }
+
+        return codec;
+    }
+
+    static Registry &registry() noexcept(false)
+    {
+        static Registry instance = {{}, {
+            builtin<Farbfeld>("farbfeld", {".ff", ".farbfeld"}),
+            builtin<PPM>("ppm", {".ppm"}, configurePPM),
+            builtin<Simple00>("simple00", {".sp0", ".simple00"}),
+            builtin<Simple01>("simple01", {".sp1", ".simple01"}),
+            builtin<Simple02>("simple02", {".sp2", ".simple02"}),
+            builtin<Targa>("targa", {".tga", ".targa"}, configureTarga)
+        }};
+
+        return instance;
+    }
+
+    //--- public functions ---
+
+    void add(const Codec &codec) noexcept(false)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto it = std::find_if(reg.codecs.begin(), reg.codecs.end(), [&](const Codec &entry)
+        {
+            return entry.name == codec.name;
+        });
+
+        if (it != reg.codecs.end())
+            *it = codec;
+        else
+            reg.codecs.push_back(codec);
+    }
+
+    std::vector<std::string> names() noexcept(false)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        std::vector<std::string> result;
+
+        for (auto &codec : reg.codecs)
+            result.push_back(codec.name);
+
+        return result;
+    }
+
+    std::optional<Codec> byName(const std::string &name) noexcept(false)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        for (auto &codec : reg.codecs)
+            if (codec.name == name)
+                return codec;
+
+        return std::nullopt;
+    }
+
+    std::optional<Codec> byContent(const std::string &filename) noexcept(false)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        for (auto &codec : reg.codecs)
+            if (codec.identify && codec.identify(filename))
+                return codec;
+
+        return std::nullopt;
+    }
+
+    std::optional<Codec> byExtension(const std::string &filename) noexcept(false)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        const std::string name = lower(filename);
+
+        for (auto &codec : reg.codecs)
+            for (auto &extension : codec.extensions)
+                if (name.ends_with(lower(extension)))
+                    return codec;
+
+        return std::nullopt;
+    }
+}
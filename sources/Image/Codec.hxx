@@ -0,0 +1,74 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Base.hxx"
+
+namespace Image
+{
+    //--- base types and constants ---
+    // defined in Compact.hxx
+    class Compact;
+    // defined in Indexed.hxx
+    template <typename Index>
+    class Indexed;
+
+    using CodecOptions = std::map<std::string,std::string>;
+
+    //
+    // Codec - everything needed to read and write one file format, the decoder hands out the image
+    //         in the class of its format and the encoder writes any image, as images share their
+    //         pixels on copies neither of both ever copies a pixel
+    //
+    // - the encoder options are key/value pairs, every encoder picks the keys it knows and ignores
+    //   all others, so one set of options works for any format, but a value it does not understand
+    //   makes it throw std::invalid_argument
+    // - the decoder takes the pixels from the given memory resource, the default one for nullptr
+    // - a codec that knows 8 bit data offers decodeCompact() too, it fills a Compact image without
+    //   going over 16 bit, for all others Compact demotes what decode() hands out
+    // - a codec that stores palette indices offers decodeIndexed() and encodeIndexed() too, they
+    //   keep the indices of an 8 bit Indexed image, all others quantize or expand it
+    // - known keys: "binary", "wide" (yes/no) and "comment" for PPM, "type" (truecolor, mapped,
+    //   mono, truecolor-rle, mapped-rle, mono-rle) for Targa
+    //
+    struct Codec {
+        using Identifier = std::function<bool (const std::string &filename)>;
+        using Decoder = std::function<std::unique_ptr<Base> (const std::string &filename,
+                                                             std::pmr::memory_resource *resource)>;
+        using Encoder = std::function<bool (const Base &image, const std::string &filename,
+                                            const CodecOptions &options)>;
+        using CompactDecoder = std::function<bool (const std::string &filename, Compact &image)>;
+        using IndexedDecoder = std::function<bool (const std::string &filename,
+                                                   Indexed<uint8_t> &image)>;
+        using IndexedEncoder = std::function<bool (const Indexed<uint8_t> &image,
+                                                   const std::string &filename,
+                                                   const CodecOptions &options)>;
+
+        std::string name;
+        std::vector<std::string> extensions;
+        Identifier identify;
+        Decoder decode;
+        Encoder encode;
+        CompactDecoder decodeCompact;
+        IndexedDecoder decodeIndexed;
+        IndexedEncoder encodeIndexed;
+    };
+
+    //
+    // Codecs - the registry of all codecs, the built in formats are always there and more can be
+    //          added at runtime, a codec with the name of a registered one replaces it
+    //
+    namespace Codecs
+    {
+        void add(const Codec &codec) noexcept(false);
+        std::vector<std::string> names() noexcept(false);
+        std::optional<Codec> byName(const std::string &name) noexcept(false);
+        std::optional<Codec> byContent(const std::string &filename) noexcept(false);
+        std::optional<Codec> byExtension(const std::string &filename) noexcept(false);
+    }
+}
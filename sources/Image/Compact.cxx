@@ -0,0 +1,440 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include "Common/ThreadPool.hxx"
+#include "Common/Tools.hxx"
+#include "Compact.hxx"
+#include "DrawDetail.hxx"
+#include "PixelDetail.hxx"
+#include "RotateDetail.hxx"
+
+namespace Image
+{
+    //--- internal stuff ---
+
+    namespace T = Common::Tools;
+
+    //--- public constructors ---
+
+    Compact::Compact() noexcept
+    : _data(), _width(0), _height(0), _resource(std::pmr::get_default_resource())
+    {
+    }
+
+    Compact::Compact(const std::string &filename) noexcept(false)
+    : Compact()
+    {
+        load(filename);
+    }
+
+    Compact::Compact(const int64_t width, const int64_t height, const RGBA color) noexcept(false)
+    : _data(), _width(width), _height(height), _resource(std::pmr::get_default_resource())
+    {
+        if ((width < 0) || (height < 0))
+            throw std::invalid_argument("image with a negative size");
+
+        _data = std::make_shared<Pixels>(width * height, color, _resource);
+    }
+
+    Compact::Compact(const Pixels &pixels, const int64_t width, const int64_t height)
+        noexcept(false)
+    : Compact(Pixels(pixels, std::pmr::get_default_resource()), width, height)
+    {
+    }
+
+    Compact::Compact(Pixels &&pixels, const int64_t width, const int64_t height) noexcept(false)
+    : _data(), _width(width), _height(height), _resource(pixels.get_allocator().resource())
+    {
+        if ((width < 0) || (height < 0) ||
+          (static_cast<uint64_t>(width * height) != static_cast<uint64_t>(pixels.size())))
+            throw std::invalid_argument("pixels do not match the size of the image");
+
+        _data = std::make_shared<Pixels>(std::move(pixels));
+    }
+
+    Compact::Compact(const Base &image, const int64_t threads) noexcept(false)
+    : Compact()
+    {
+        Picture linear(image);
+
+        // only a tiled image gets a linear copy here, a linear one is just shared
+        linear.setLayout(Layout::Linear);
+        _resource = image.memoryResource();
+        _width = linear.width();
+        _height = linear.height();
+        _data = std::make_shared<Pixels>(_width * _height, _resource);
+
+        const Base::RGBA *in = linear.pixels().data();
+        RGBA *out = _data->data();
+
+        Common::ThreadPool::global().runBands(_height, threads,
+            [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t i = begin * _width; i < end * _width; ++i)
+                out[i] = in[i].toRGBA8888();
+        });
+    }
+
+    Compact::Compact(const Compact &rhs) noexcept
+    : _data(rhs._data), _width(rhs._width), _height(rhs._height), _resource(rhs._resource)
+    {
+    }
+
+    Compact::Compact(Compact &&rhs) noexcept
+    : _data(std::move(rhs._data)), _width(std::move(rhs._width)),
+      _height(std::move(rhs._height)), _resource(std::move(rhs._resource))
+    {
+    }
+
+    Compact::~Compact() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    Compact &Compact::operator=(const Compact &rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _data = rhs._data;
+            _width = rhs._width;
+            _height = rhs._height;
+            _resource = rhs._resource;
+        }
+
+        return *this;
+    }
+
+    Compact &Compact::operator=(Compact &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _data = std::move(rhs._data);
+            _width = std::move(rhs._width);
+            _height = std::move(rhs._height);
+            _resource = std::move(rhs._resource);
+        }
+
+        return *this;
+    }
+
+    bool Compact::operator==(const Compact &rhs) const noexcept
+    {
+        return (_width == rhs._width) && (_height == rhs._height) &&
+               ((_data == rhs._data) || (pixels() == rhs.pixels()));
+    }
+
+    bool Compact::operator!=(const Compact &rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    //--- public methods ---
+
+    int64_t Compact::width() const noexcept
+    {
+        return _width;
+    }
+
+    int64_t Compact::height() const noexcept
+    {
+        return _height;
+    }
+
+    std::pmr::memory_resource *Compact::memoryResource() const noexcept
+    {
+        return _resource;
+    }
+
+    void Compact::setMemoryResource(std::pmr::memory_resource *resource) noexcept(false)
+    {
+        _resource = resource ? resource : std::pmr::get_default_resource();
+
+        if (_data && (_data->get_allocator().resource() != _resource))
+            _data = std::make_shared<Pixels>(*_data, _resource);
+    }
+
+    const Compact::Pixels &Compact::pixels() const noexcept
+    {
+        static const Pixels none;
+
+        return _data ? *_data : none;
+    }
+
+    Compact::RGBA Compact::pixel(const int64_t x, const int64_t y) const noexcept(false)
+    {
+        if (!implContains(x, y))
+            throw std::out_of_range("pixel outside of the image");
+
+        return (*_data)[y * _width + x];
+    }
+
+    bool Compact::setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept(false)
+    {
+        if (!implContains(x, y))
+            return false;
+
+        implOwnData()[y * _width + x] = color;
+
+        return true;
+    }
+
+    bool Compact::setLine(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                          const RGBA color) noexcept(false)
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsLine(clip, x1, y1, x2, y2))
+            return false;
+
+        RGBA *data = implOwnData().data();
+
+        Detail::drawLine(x1, y1, x2, y2, [&](const int64_t x, const int64_t y)
+        {
+            data[y * _width + x] = color;
+        },
+        clip);
+
+        return true;
+    }
+
+    bool Compact::setTriangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                              const int64_t y2, const int64_t x3, const int64_t y3,
+                              const RGBA color, const bool fill) noexcept(false)
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsTriangle(clip, x1, y1, x2, y2, x3, y3))
+            return false;
+
+        RGBA *data = implOwnData().data();
+
+        Detail::drawTriangle(x1, y1, x2, y2, x3, y3, fill, [&](const int64_t x, const int64_t y)
+        {
+            data[y * _width + x] = color;
+        },
+        [&](const int64_t first, const int64_t last, const int64_t y)
+        {
+            std::fill(data + y * _width + first, data + y * _width + last + 1, color);
+        },
+        clip);
+
+        return true;
+    }
+
+    bool Compact::setRectangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                               const int64_t y2, const RGBA color, const bool fill)
+        noexcept(false)
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsRectangle(clip, x1, y1, x2, y2))
+            return false;
+
+        RGBA *data = implOwnData().data();
+
+        Detail::drawRectangle(x1, y1, x2, y2, fill, [&](const int64_t x, const int64_t y)
+        {
+            data[y * _width + x] = color;
+        },
+        [&](const int64_t first, const int64_t last, const int64_t y)
+        {
+            std::fill(data + y * _width + first, data + y * _width + last + 1, color);
+        },
+        clip);
+
+        return true;
+    }
+
+    bool Compact::setCircle(const int64_t x, const int64_t y, const int64_t radius,
+                            const RGBA color, const bool fill) noexcept(false)
+    {
+        return setEllipse(x, y, radius, radius, color, fill);
+    }
+
+    bool Compact::setEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                             const int64_t radius_y, const RGBA color, const bool fill)
+        noexcept(false)
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsEllipse(clip, x, y, radius_x, radius_y))
+            return false;
+
+        const int64_t rx = std::abs(radius_x);
+        const int64_t ry = std::abs(radius_y);
+
+        RGBA *data = implOwnData().data();
+
+        Detail::drawEllipse(x, y, rx, ry, fill,
+                            [&](const int64_t first, const int64_t last, const int64_t yy)
+        {
+            std::fill(data + yy * _width + first, data + yy * _width + last + 1, color);
+        },
+        clip);
+
+        return true;
+    }
+
+    void Compact::flipVertical(const int64_t threads) noexcept(false)
+    {
+        Detail::flipVertical(implOwnData().data(), _width, _height, _width, threads);
+    }
+
+    void Compact::flipHorizontal(const int64_t threads) noexcept(false)
+    {
+        Detail::flipHorizontal(implOwnData().data(), _width, _height, _width, threads);
+    }
+
+    void Compact::rotate90(const int64_t threads) noexcept(false)
+    {
+        implTranspose(false, true, threads);
+    }
+
+    void Compact::rotate180() noexcept(false)
+    {
+        Detail::rotate180(implOwnData().data(), _width, _height, _width);
+    }
+
+    void Compact::rotate270(const int64_t threads) noexcept(false)
+    {
+        implTranspose(true, false, threads);
+    }
+
+    void Compact::transpose(const int64_t threads) noexcept(false)
+    {
+        implTranspose(false, false, threads);
+    }
+
+    bool Compact::resize(const int64_t width, const int64_t height, const Scaler scaler)
+        noexcept(false)
+    {
+        if ((width < 1) || (height < 1))
+            return false;
+
+        if ((scaler != Scaler::Nearest) && (scaler != Scaler::Keep) && (scaler != Scaler::Clear))
+        {
+            // the filtering scalers need the precision of 16 bit
+            Picture picture = promote();
+
+            if (!picture.resize(width, height, scaler))
+                return false;
+
+            *this = Compact(picture);
+
+            return true;
+        }
+
+        Pixels pixels(width * height, RGBA(RGBA::Black), _resource);
+        const RGBA *data = this->pixels().data();
+
+        switch (scaler)
+        {
+            case Scaler::Nearest:
+                if ((_width < 1) || (_height < 1))
+                    return false;
+
+                Detail::nearest(data, _width, _height, _width, pixels.data(), width, height,
+                                width);
+                break;
+
+            case Scaler::Keep:
+                Detail::keep(data, _width, _height, _width, pixels.data(), width, height, width,
+                             RGBA(RGBA::Black));
+                break;
+
+            case Scaler::Clear:
+            default:
+                break;
+        }
+
+        _data = std::make_shared<Pixels>(std::move(pixels));
+        _width = width;
+        _height = height;
+
+        return true;
+    }
+
+    Picture Compact::promote(const int64_t threads) const noexcept(false)
+    {
+        Picture::Pixels promoted(_width * _height, _resource);
+        const RGBA *in = pixels().data();
+        Base::RGBA *out = promoted.data();
+
+        Common::ThreadPool::global().runBands(_height, threads,
+            [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t i = begin * _width; i < end * _width; ++i)
+                out[i] = in[i].toRGBA16161616();
+        });
+
+        Picture picture(std::move(promoted), _width, _height);
+
+        // the pixels are already in the resource, so this only sets it for later buffers
+        picture.setMemoryResource(_resource);
+
+        return picture;
+    }
+
+    bool Compact::save(const std::string &filename, const CodecOptions &options) const
+        noexcept(false)
+    {
+        Picture picture = promote();
+
+        picture.setOptions(options);
+
+        return picture.save(filename);
+    }
+
+    bool Compact::load(const std::string &filename) noexcept(false)
+    {
+        if (const auto codec = Codecs::byContent(filename))
+        {
+            // codecs without 8 bit support decode to 16 bit, that is demoted afterwards
+            if (codec->decodeCompact)
+                return codec->decodeCompact(filename, *this);
+
+            if (const auto image = codec->decode(filename, _resource))
+            {
+                *this = Compact(*image);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //--- protected methods ---
+
+    bool Compact::implContains(const int64_t x, const int64_t y) const noexcept
+    {
+        return T::inRange(x, 0, _width, true, false) && T::inRange(y, 0, _height, true, false);
+    }
+
+    Compact::Pixels &Compact::implOwnData() noexcept(false)
+    {
+        // the same copy on write as Base
+        if (!_data)
+            _data = std::make_shared<Pixels>(_resource);
+        else if (_data.use_count() > 1)
+            _data = std::make_shared<Pixels>(*_data, _resource);
+        else
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+        return *_data;
+    }
+
+    void Compact::implTranspose(const bool mirror_rows, const bool mirror_columns,
+                                const int64_t threads) noexcept(false)
+    {
+        Pixels pixels(_width * _height, _resource);
+
+        Detail::transpose(this->pixels().data(), _width, _height, _width, pixels.data(), _height,
+                          mirror_rows, mirror_columns, threads);
+        _data = std::make_shared<Pixels>(std::move(pixels));
+        std::swap(_width, _height);
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "Color/RGBA8888.hxx"
+#include "Base.hxx"
+#include "Codec.hxx"
+#include "Picture.hxx"
+
+namespace Image
+{
+    //
+    // Compact - an image with 8 bit channels, half the memory and bandwidth of Base for everything
+    //           coming from 8 bit sources anyway, the codecs that know 8 bit data load it without a
+    //           detour over 16 bit and the image is only promoted when a 16 bit algorithm is needed
+    //
+    // - promoting shifts the channels into the high byte and demoting drops the low byte again, so
+    //   8 bit pixels come back unchanged from a trip through a Picture
+    // - drawing, flips, rotations and nearest/keep scaling run on the 8 bit pixels, they are the same
+    //   templates Base uses, any other scaler and saving go through a promoted copy
+    // - the pixels are shared between copies and come from the memory resource of the image just
+    //   like the ones of Base
+    //
+    class Compact {
+    public:
+        //--- public types and constants ---
+        using RGBA = Color::RGBA8888;
+        using Pixels = std::pmr::vector<RGBA>;
+
+        //--- public constructors ---
+        Compact() noexcept;
+        Compact(const std::string &filename) noexcept(false);
+        Compact(const int64_t width, const int64_t height, const RGBA color = RGBA::Black)
+            noexcept(false);
+        Compact(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        Compact(Pixels &&pixels, const int64_t width, const int64_t height) noexcept(false);
+        explicit Compact(const Base &image, const int64_t threads = 1) noexcept(false);
+        Compact(const Compact &rhs) noexcept;
+        Compact(Compact &&rhs) noexcept;
+        ~Compact() noexcept;
+
+        //--- public operators ---
+        Compact &operator=(const Compact &rhs) noexcept;
+        Compact &operator=(Compact &&rhs) noexcept;
+        bool operator==(const Compact &rhs) const noexcept;
+        bool operator!=(const Compact &rhs) const noexcept;
+
+        //--- public methods ---
+        int64_t width() const noexcept;
+        int64_t height() const noexcept;
+        std::pmr::memory_resource *memoryResource() const noexcept;
+        void setMemoryResource(std::pmr::memory_resource *resource) noexcept(false);
+        const Pixels &pixels() const noexcept;
+        RGBA pixel(const int64_t x, const int64_t y) const noexcept(false);
+        bool setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept(false);
+        bool setLine(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                     const RGBA color) noexcept(false);
+        bool setTriangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                         const int64_t x3, const int64_t y3, const RGBA color, const bool fill)
+            noexcept(false);
+        bool setRectangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                          const RGBA color, const bool fill) noexcept(false);
+        bool setCircle(const int64_t x, const int64_t y, const int64_t radius, const RGBA color,
+                       const bool fill) noexcept(false);
+        bool setEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                        const int64_t radius_y, const RGBA color, const bool fill) noexcept(false);
+        void flipVertical(const int64_t threads = 1) noexcept(false);
+        void flipHorizontal(const int64_t threads = 1) noexcept(false);
+        void rotate90(const int64_t threads = 1) noexcept(false);
+        void rotate180() noexcept(false);
+        void rotate270(const int64_t threads = 1) noexcept(false);
+        void transpose(const int64_t threads = 1) noexcept(false);
+        bool resize(const int64_t width, const int64_t height, const Scaler scaler)
+            noexcept(false);
+        Picture promote(const int64_t threads = 1) const noexcept(false);
+        bool save(const std::string &filename, const CodecOptions &options = {}) const
+            noexcept(false);
+        bool load(const std::string &filename) noexcept(false);
+
+    protected:
+        //--- protected methods ---
+        bool implContains(const int64_t x, const int64_t y) const noexcept;
+        Pixels &implOwnData() noexcept(false);
+        void implTranspose(const bool mirror_rows, const bool mirror_columns,
+                           const int64_t threads) noexcept(false);
+
+    private:
+        //--- private properties ---
+        std::shared_ptr<Pixels> _data;
+        int64_t _width;
+        int64_t _height;
+        std::pmr::memory_resource *_resource;
+    };
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "Common/ThreadPool.hxx"
+#include "ConvolveDetail.hxx"
+
+namespace Image::Detail
+{
+    //--- internal stuff ---
+
+    using Row = std::vector<float>;
+    using Rows = std::map<int64_t,Row>;
+
+    //
+    // RowPreparer - turns a source row into the float row the vertical part of the convolution
+    //               works on, this is the horizontal pass for separable kernels or just a copy
+    //               padded by the kernel radius on both sides for all other kernels
+    //
+    class RowPreparer {
+    public:
+        //--- public constructors ---
+        RowPreparer(const RGBA *pixels, const int64_t width, const int64_t stride,
+                    const Kernel &kernel, const Border border) noexcept(false)
+        : _pixels(pixels), _kernel(kernel), _padded((width + kernel.size() - 1) * 4),
+          _width(width), _stride(stride), _border(border)
+        {
+        }
+
+        RowPreparer(const RowPreparer &rhs) = delete;
+        RowPreparer(RowPreparer &&rhs) = delete;
+
+        ~RowPreparer() noexcept
+        {
+        }
+
+        //--- public operators ---
+        RowPreparer &operator=(const RowPreparer &rhs) = delete;
+        RowPreparer &operator=(RowPreparer &&rhs) = delete;
+
+        //--- public methods ---
+        int64_t rowSize() const noexcept
+        {
+            return _kernel.separable() ? _width * 4 : _padded.size();
+        }
+
+        void prepare(const int64_t y, Row &out) noexcept(false)
+        {
+            const int64_t radius = _kernel.radius();
+            const RGBA *src = _pixels + y * _stride;
+            Row &padded = _kernel.separable() ? _padded : out;
+
+            padded.resize(_padded.size());
+            for (int64_t i = 0, end = _width + 2 * radius; i < end; ++i)
+            {
+                const RGBA pixel = src[borderIndex(i - radius, _width, _border)];
+
+                padded[i * 4] = pixel.r;
+                padded[i * 4 + 1] = pixel.g;
+                padded[i * 4 + 2] = pixel.b;
+                padded[i * 4 + 3] = pixel.a;
+            }
+
+            if (_kernel.separable())
+            {
+                const auto &weights = _kernel.row();
+
+                out.assign(_width * 4, 0);
+                for (int64_t k = 0; k < _kernel.size(); ++k)
+                {
+                    const float weight = weights[k];
+                    const float *in = padded.data() + k * 4;
+
+                    if (weight != 0)
+                        for (int64_t i = 0, end = _width * 4; i < end; ++i)
+                            out[i] += weight * in[i];
+                }
+            }
+        }
+
+    private:
+        //--- private properties ---
+        const RGBA *_pixels;
+        const Kernel &_kernel;
+        Row _padded;
+        const int64_t _width;
+        const int64_t _stride;
+        const Border _border;
+    };
+
+    inline uint16_t toChannel(const float val) noexcept
+    {
+        return std::clamp(val, .0f, 65535.0f) + .5f;
+    }
+
+    //--- public functions ---
+
+    int64_t borderIndex(const int64_t pos, const int64_t size, const Border border) noexcept
+    {
+        if ((pos >= 0) && (pos < size))
+            return pos;
+
+        switch (border)
+        {
+            case Border::Wrap:
+                return ((pos % size) + size) % size;
+
+            case Border::Mirror:
+            {
+                // reflects without repeating the edge pixel, so the period is 2 * (size - 1)
+                if (size == 1)
+                    return 0;
+
+                const int64_t period = 2 * (size - 1);
+                const int64_t mod = ((pos % period) + period) % period;
+
+                return mod < size ? mod : period - mod;
+            }
+
+            case Border::Clamp:
+            default:
+                return std::clamp<int64_t>(pos, 0, size - 1);
+        }
+    }
+
+    void convolve(RGBA *pixels, const int64_t width, const int64_t height, const int64_t stride,
+                  const Kernel &kernel, const Border border, const int64_t threads)
+        noexcept(false)
+    {
+        const int64_t size = kernel.size();
+        const int64_t radius = kernel.radius();
+        const int64_t bands = std::clamp<int64_t>(threads, 1, height);
+        auto &pool = Common::ThreadPool::global();
+        std::vector<Rows> foreign(bands);
+
+        // every band works top down in place and keeps the prepared rows of the last kernel size
+        // source rows in a ring, but rows owned by other bands or referenced from outside of the
+        // kernel window (wrapping, tiny images) would already be overwritten by then, so these
+        // "foreign" rows are prepared for all bands before anyone starts writing
+        pool.run(bands, [&](const int64_t band)
+        {
+            const int64_t begin = height * band / bands;
+            const int64_t end = height * (band + 1) / bands;
+            RowPreparer preparer(pixels, width, stride, kernel, border);
+
+            for (int64_t y = begin; y < end; ++y)
+            {
+                for (int64_t k = 0; k < size; ++k)
+                {
+                    const int64_t src = borderIndex(y + k - radius, height, border);
+
+                    if (((src < begin) || (src >= end) || (std::abs(src - y) > radius)) &&
+                      !foreign[band].contains(src))
+                        preparer.prepare(src, foreign[band][src]);
+                }
+            }
+        });
+
+        pool.run(bands, [&](const int64_t band)
+        {
+            const int64_t begin = height * band / bands;
+            const int64_t end = height * (band + 1) / bands;
+            const Rows &rows = foreign[band];
+            RowPreparer preparer(pixels, width, stride, kernel, border);
+            std::vector<Row> ring(size, Row(preparer.rowSize()));
+            Row sum(width * 4);
+            int64_t next = begin;
+
+            for (int64_t y = begin; y < end; ++y)
+            {
+                for (; (next < end) && (next <= (y + radius)); ++next)
+                    preparer.prepare(next, ring[next % size]);
+
+                std::fill(sum.begin(), sum.end(), 0);
+                for (int64_t k = 0; k < size; ++k)
+                {
+                    const int64_t src = borderIndex(y + k - radius, height, border);
+                    const auto it = rows.find(src);
+                    const float *in = it != rows.end() ? it->second.data() : ring[src % size].data();
+
+                    if (kernel.separable())
+                    {
+                        const float weight = kernel.column()[k];
+
+                        if (weight != 0)
+                            for (int64_t i = 0, iend = width * 4; i < iend; ++i)
+                                sum[i] += weight * in[i];
+                    }
+                    else
+                    {
+                        for (int64_t j = 0; j < size; ++j)
+                        {
+                            const float weight = kernel.weight(j, k);
+                            const float *shifted = in + j * 4;
+
+                            if (weight != 0)
+                                for (int64_t i = 0, iend = width * 4; i < iend; ++i)
+                                    sum[i] += weight * shifted[i];
+                        }
+                    }
+                }
+
+                RGBA *out = pixels + y * stride;
+
+                for (int64_t x = 0; x < width; ++x)
+                    out[x].set(toChannel(sum[x * 4]), toChannel(sum[x * 4 + 1]),
+                               toChannel(sum[x * 4 + 2]), toChannel(sum[x * 4 + 3]));
+            }
+        });
+    }
+}
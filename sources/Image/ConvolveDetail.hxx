@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include "Base.hxx"
+
+namespace Image::Detail
+{
+    using RGBA = Base::RGBA;
+
+    // maps a position outside of [0, size) back into it
+    int64_t borderIndex(const int64_t pos, const int64_t size, const Border border) noexcept;
+
+    // convolves all four channels in place, only O(kernel size * width) rows are held per thread,
+    // the rows of the image are stride pixels apart
+    void convolve(RGBA *pixels, const int64_t width, const int64_t height, const int64_t stride,
+                  const Kernel &kernel, const Border border, const int64_t threads)
+        noexcept(false);
+}
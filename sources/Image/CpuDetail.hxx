@@ -0,0 +1,14 @@
+#pragma once
+
+namespace Image::Detail
+{
+#if defined __x86_64__
+    // whether the code paths built for AVX2 may run on this CPU, asked only once
+    inline bool hasAvx2() noexcept
+    {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+
+        return avx2;
+    }
+#endif
+}
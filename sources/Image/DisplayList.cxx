@@ -0,0 +1,102 @@
+#include <utility>
+#include "DisplayList.hxx"
+
+namespace Image
+{
+    //--- public constructors ---
+
+    DisplayList::DisplayList() noexcept
+    : _commands()
+    {
+    }
+
+    DisplayList::DisplayList(const DisplayList &rhs) noexcept(false)
+    : _commands(rhs._commands)
+    {
+    }
+
+    DisplayList::DisplayList(DisplayList &&rhs) noexcept
+    : _commands(std::move(rhs._commands))
+    {
+    }
+
+    DisplayList::~DisplayList() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    DisplayList &DisplayList::operator=(const DisplayList &rhs) noexcept(false)
+    {
+        _commands = rhs._commands;
+
+        return *this;
+    }
+
+    DisplayList &DisplayList::operator=(DisplayList &&rhs) noexcept
+    {
+        _commands = std::move(rhs._commands);
+
+        return *this;
+    }
+
+    //--- public methods ---
+
+    bool DisplayList::empty() const noexcept
+    {
+        return _commands.empty();
+    }
+
+    int64_t DisplayList::size() const noexcept
+    {
+        return _commands.size();
+    }
+
+    const std::vector<DisplayList::Command> &DisplayList::commands() const noexcept
+    {
+        return _commands;
+    }
+
+    void DisplayList::clear() noexcept
+    {
+        _commands.clear();
+    }
+
+    void DisplayList::setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept(false)
+    {
+        _commands.push_back({Primitive::Pixel, false, x, y, x, y, x, y, color});
+    }
+
+    void DisplayList::setLine(const int64_t x1, const int64_t y1, const int64_t x2,
+                              const int64_t y2, const RGBA color) noexcept(false)
+    {
+        _commands.push_back({Primitive::Line, false, x1, y1, x2, y2, x2, y2, color});
+    }
+
+    void DisplayList::setTriangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                                  const int64_t y2, const int64_t x3, const int64_t y3,
+                                  const RGBA color, const bool fill) noexcept(false)
+    {
+        _commands.push_back({Primitive::Triangle, fill, x1, y1, x2, y2, x3, y3, color});
+    }
+
+    void DisplayList::setRectangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                                   const int64_t y2, const RGBA color, const bool fill)
+        noexcept(false)
+    {
+        _commands.push_back({Primitive::Rectangle, fill, x1, y1, x2, y2, x2, y2, color});
+    }
+
+    void DisplayList::setCircle(const int64_t x, const int64_t y, const int64_t radius,
+                                const RGBA color, const bool fill) noexcept(false)
+    {
+        _commands.push_back({Primitive::Circle, fill, x, y, radius, radius, x, y, color});
+    }
+
+    void DisplayList::setEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                                 const int64_t radius_y, const RGBA color, const bool fill)
+        noexcept(false)
+    {
+        _commands.push_back({Primitive::Ellipse, fill, x, y, radius_x, radius_y, x, y, color});
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Color/RGBA16161616.hxx"
+
+namespace Image
+{
+    //
+    // DisplayList - drawing commands recorded for later, Base::draw() renders all of them at once
+    //
+    // - the commands take the arguments of the drawing methods of Base with the same names and
+    //   are checked against the image when they are drawn, a command the image would refuse
+    //   draws nothing
+    // - every command goes to the tiles of the image it touches and the tiles are drawn in
+    //   parallel, within a tile the commands keep the order they were recorded in, so the result
+    //   is the same as drawing them one after the other
+    //
+    class DisplayList {
+    public:
+        //--- public types and constants ---
+        using RGBA = Color::RGBA16161616;
+
+        enum class Primitive : int16_t {
+            Pixel,
+            Line,
+            Triangle,
+            Rectangle,
+            Circle,
+            Ellipse
+        };
+
+        // a circle or an ellipse has its center in x1, y1 and its radii in x2, y2
+        struct Command {
+            Primitive primitive;
+            bool fill;
+            int64_t x1;
+            int64_t y1;
+            int64_t x2;
+            int64_t y2;
+            int64_t x3;
+            int64_t y3;
+            RGBA color;
+        };
+
+        //--- public constructors ---
+        DisplayList() noexcept;
+        DisplayList(const DisplayList &rhs) noexcept(false);
+        DisplayList(DisplayList &&rhs) noexcept;
+        ~DisplayList() noexcept;
+
+        //--- public operators ---
+        DisplayList &operator=(const DisplayList &rhs) noexcept(false);
+        DisplayList &operator=(DisplayList &&rhs) noexcept;
+
+        //--- public methods ---
+        bool empty() const noexcept;
+        int64_t size() const noexcept;
+        const std::vector<Command> &commands() const noexcept;
+        void clear() noexcept;
+        void setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept(false);
+        void setLine(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                     const RGBA color) noexcept(false);
+        void setTriangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                         const int64_t x3, const int64_t y3, const RGBA color, const bool fill)
+            noexcept(false);
+        void setRectangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                          const RGBA color, const bool fill) noexcept(false);
+        void setCircle(const int64_t x, const int64_t y, const int64_t radius, const RGBA color,
+                       const bool fill) noexcept(false);
+        void setEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                        const int64_t radius_y, const RGBA color, const bool fill) noexcept(false);
+
+    private:
+        //--- private properties ---
+        std::vector<Command> _commands;
+    };
+}
@@ -0,0 +1,785 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "Common/Tools.hxx"
+#include "Math/Vector2.hxx"
+
+namespace Image::Detail
+{
+    //
+    // the drawing algorithms, shared by Base, Compact and MutableImageView, they only decide which
+    // pixels are set and leave the storage to the caller, plot(x, y) sets a single pixel and
+    // span(x1, x2, y) the pixels from x1 to x2 (both included) of a row, every shape is clipped
+    // to its clip rectangle and neither calls plot() nor span() for anything outside of it
+    //
+
+    // the pixels from (x1, y1) up to but excluding (x2, y2) that may be drawn
+    struct Clip {
+        int64_t x1;
+        int64_t y1;
+        int64_t x2;
+        int64_t y2;
+    };
+
+    constexpr Clip NoClip = {std::numeric_limits<int64_t>::min(),
+                             std::numeric_limits<int64_t>::min(),
+                             std::numeric_limits<int64_t>::max(),
+                             std::numeric_limits<int64_t>::max()};
+
+    // whether a rectangle of width x height pixels at (x, y) has no negative size and ends within
+    // (right, bottom), checked without overflowing for any values
+    inline bool validRect(const int64_t x, const int64_t y, const int64_t width,
+                          const int64_t height,
+                          const int64_t right = std::numeric_limits<int64_t>::max(),
+                          const int64_t bottom = std::numeric_limits<int64_t>::max()) noexcept
+    {
+        return (width >= 0) && (height >= 0) && (x <= right - width) && (y <= bottom - height);
+    }
+
+    // lines and triangles are rasterized without cutting them at the clip rectangle first, their
+    // coordinates have to stay within the guard band, so the edge functions and the error terms
+    // can not overflow
+    constexpr int64_t GuardBand = 1 << 24;
+
+    inline bool inGuardBand(const std::initializer_list<int64_t> coordinates) noexcept
+    {
+        return std::all_of(coordinates.begin(), coordinates.end(), [](const int64_t value)
+        {
+            return (value >= -GuardBand) && (value <= GuardBand);
+        });
+    }
+
+    // whether a shape with the bounding box from (x1, y1) to (x2, y2) (both included) may touch
+    // the clip rectangle
+    inline bool touches(const Clip &clip, const int64_t x1, const int64_t y1, const int64_t x2,
+                        const int64_t y2) noexcept
+    {
+        return (x2 >= clip.x1) && (x1 < clip.x2) && (y2 >= clip.y1) && (y1 < clip.y2);
+    }
+
+    template <typename Span>
+    inline void clipSpan(const int64_t x1, const int64_t x2, const int64_t y, const Clip &clip,
+                         Span span) noexcept
+    {
+        const int64_t first = std::max(x1, clip.x1);
+        const int64_t last = std::min(x2, clip.x2 - 1);
+
+        if ((y >= clip.y1) && (y < clip.y2) && (first <= last))
+            span(first, last, y);
+    }
+
+    //
+    // a line steps along its longer (major) axis one pixel at a time, the pixel on the shorter
+    // axis after i steps is floor((2 * minor * i + major - 1) / (2 * major)), which is the same
+    // Bresenham line as the usual error stepping from one end to the other
+    //
+    // - the steps inside of the clip rectangle are an interval, its ends come straight from the
+    //   formula (like Liang-Barsky does with the parameters of a line), so only the visible part
+    //   is stepped and it has exactly the pixels the whole line has there
+    //
+    template <typename Plot>
+    inline void drawLine(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                         Plot plot, const Clip &clip = NoClip) noexcept
+    {
+        // the clip rectangle within the bounding box, so nothing below can overflow
+        const int64_t left = std::max(std::min(x1, x2), clip.x1);
+        const int64_t top = std::max(std::min(y1, y2), clip.y1);
+        const int64_t right = std::min(std::max(x1, x2), clip.x2 - 1);
+        const int64_t bottom = std::min(std::max(y1, y2), clip.y2 - 1);
+
+        if ((left > right) || (top > bottom))
+            return;
+
+        const bool steep = std::abs(y2 - y1) > std::abs(x2 - x1);
+        const int64_t major = steep ? std::abs(y2 - y1) : std::abs(x2 - x1);
+        const int64_t minor = steep ? std::abs(x2 - x1) : std::abs(y2 - y1);
+        const int64_t step_x = x1 < x2 ? 1 : -1;
+        const int64_t step_y = y1 < y2 ? 1 : -1;
+
+        // the clipped range of the offsets from the start, along each axis
+        const int64_t from_x = step_x > 0 ? left - x1 : x1 - right;
+        const int64_t to_x = step_x > 0 ? right - x1 : x1 - left;
+        const int64_t from_y = step_y > 0 ? top - y1 : y1 - bottom;
+        const int64_t to_y = step_y > 0 ? bottom - y1 : y1 - top;
+        const int64_t from_minor = steep ? from_x : from_y;
+        const int64_t to_minor = steep ? to_x : to_y;
+        int64_t first = steep ? from_y : from_x;
+        int64_t last = steep ? to_y : to_x;
+
+        if (minor > 0)
+        {
+            if (from_minor > 0)
+                first = std::max(first, (2 * major * from_minor - major + 2 * minor) /
+                                        (2 * minor));
+            last = std::min(last, (2 * major * to_minor + major) / (2 * minor));
+        }
+
+        if (first > last)
+            return;
+
+        // the error term is what the division above leaves, it stays in [0, 2 * major)
+        int64_t offset = major ? (2 * minor * first + major - 1) / (2 * major) : 0;
+        int64_t error = 2 * minor * first + major - 1 - 2 * major * offset;
+
+        for (int64_t i = first; i <= last; ++i)
+        {
+            if (steep)
+                plot(x1 + step_x * offset, y1 + step_y * i);
+            else
+                plot(x1 + step_x * i, y1 + step_y * offset);
+
+            error += 2 * minor;
+            if (error >= 2 * major)
+            {
+                error -= 2 * major;
+                ++offset;
+            }
+        }
+    }
+
+    //
+    // TriangleEdge - the edge function of an edge from a to b, it is positive on the inner side of
+    //                a clockwise (on the screen) triangle and steps by step_x to the next pixel
+    //                and by step_y to the next row
+    //
+    // - positions are doubled, so the centers of the pixels the function is sampled at are whole
+    //   numbers and everything stays exact
+    // - the top-left fill rule decides about pixels on the edge, they belong to a triangle when
+    //   the edge is a top edge (horizontal, above the inside) or a left edge, the bias takes one
+    //   from the function of any other edge, so "inside" is always a value >= 0
+    //
+    struct TriangleEdge {
+        int64_t step_x;
+        int64_t step_y;
+        int64_t origin;
+
+        TriangleEdge(const int64_t ax, const int64_t ay, const int64_t bx, const int64_t by,
+                     const int64_t x, const int64_t y) noexcept
+        : step_x(-2 * (by - ay)), step_y(2 * (bx - ax)), origin(0)
+        {
+            const bool top_left = (by < ay) || ((by == ay) && (bx > ax));
+
+            origin = (bx - ax) * (2 * (y - ay) + 1) - (by - ay) * (2 * (x - ax) + 1) -
+                     (top_left ? 0 : 1);
+        }
+    };
+
+    // the size of the blocks that are rejected or filled as a whole
+    constexpr int64_t TriangleBlock = 8;
+
+    // the bounding boxes up to this size are filled row by row, they have too few whole blocks
+    constexpr int64_t SmallTriangle = 4 * TriangleBlock;
+
+    // a / b rounded towards negative infinity, b is positive
+    inline int64_t floorDiv(const int64_t a, const int64_t b) noexcept
+    {
+        return a >= 0 ? a / b : -((b - 1 - a) / b);
+    }
+
+    //
+    // a filled triangle is rasterized with the edge functions of its three edges, stepped
+    // incrementally in blocks of 8x8 pixels, a block outside of one edge is skipped, a block
+    // inside of all three is taken as a whole and only the others are tested pixel by pixel
+    //
+    // - a pixel is set when its center is inside, on the edges the top-left rule decides, so
+    //   triangles sharing an edge never share a pixel and leave no gap between them
+    // - the triangle is convex, every row is one run of pixels and ends up as one span
+    // - a bounding box of at most SpanLimit pixels in both directions skips the blocks, every
+    //   edge function is linear in x, so where it turns negative bounds the span of a row
+    //
+    template <int64_t SpanLimit = SmallTriangle, typename Span>
+    inline void fillTriangle(const int64_t x1, const int64_t y1, int64_t x2, int64_t y2,
+                             int64_t x3, int64_t y3, Span span, const Clip &clip = NoClip)
+        noexcept
+    {
+        namespace T = Common::Tools;
+
+        const int64_t area = (x2 - x1) * (y3 - y1) - (y2 - y1) * (x3 - x1);
+
+        if (area == 0)
+            return;
+        if (area < 0)
+        {
+            std::swap(x2, x3);
+            std::swap(y2, y3);
+        }
+
+        // the pixels whose centers may be inside, as far as they are not clipped
+        const int64_t min_x = std::max(T::min(x1, x2, x3), clip.x1);
+        const int64_t min_y = std::max(T::min(y1, y2, y3), clip.y1);
+        const int64_t max_x = std::min(T::max(x1, x2, x3), clip.x2);
+        const int64_t max_y = std::min(T::max(y1, y2, y3), clip.y2);
+        const TriangleEdge edges[3] = {{x1, y1, x2, y2, min_x, min_y},
+                                       {x2, y2, x3, y3, min_x, min_y},
+                                       {x3, y3, x1, y1, min_x, min_y}};
+        constexpr int64_t Last = TriangleBlock - 1;
+
+        if (((max_x - min_x) <= SpanLimit) && ((max_y - min_y) <= SpanLimit))
+        {
+            for (int64_t y = min_y; y < max_y; ++y)
+            {
+                int64_t first = min_x;
+                int64_t last = max_x - 1;
+
+                for (int64_t e = 0; (e < 3) && (first <= last); ++e)
+                {
+                    const int64_t row = edges[e].origin + (y - min_y) * edges[e].step_y;
+                    const int64_t step = edges[e].step_x;
+
+                    if (step > 0)
+                        first = std::max(first, min_x - floorDiv(row, step));
+                    else if (step < 0)
+                        last = std::min(last, min_x + floorDiv(row, -step));
+                    else if (row < 0)
+                        last = first - 1;
+                }
+
+                if (first <= last)
+                    span(first, last, y);
+            }
+
+            return;
+        }
+
+        for (int64_t by = min_y; by < max_y; by += TriangleBlock)
+        {
+            const int64_t rows = std::min(TriangleBlock, max_y - by);
+            int64_t first[TriangleBlock];
+            int64_t last[TriangleBlock];
+            int64_t block[3];
+
+            std::fill_n(first, rows, max_x);
+            std::fill_n(last, rows, min_x - 1);
+            for (int64_t e = 0; e < 3; ++e)
+                block[e] = edges[e].origin + (by - min_y) * edges[e].step_y;
+
+            for (int64_t bx = min_x; bx < max_x; bx += TriangleBlock)
+            {
+                const int64_t columns = std::min(TriangleBlock, max_x - bx);
+                bool outside = false;
+                bool inside = true;
+
+                // the edge functions are linear, so the corners decide about the whole block
+                for (int64_t e = 0; e < 3; ++e)
+                {
+                    const int64_t right = Last * edges[e].step_x;
+                    const int64_t bottom = Last * edges[e].step_y;
+                    const int64_t low = block[e] + std::min<int64_t>(right, 0) +
+                                        std::min<int64_t>(bottom, 0);
+                    const int64_t high = block[e] + std::max<int64_t>(right, 0) +
+                                         std::max<int64_t>(bottom, 0);
+
+                    outside |= high < 0;
+                    inside &= low >= 0;
+                }
+
+                if (inside)
+                {
+                    for (int64_t y = 0; y < rows; ++y)
+                    {
+                        first[y] = std::min(first[y], bx);
+                        last[y] = bx + columns - 1;
+                    }
+                }
+                else if (!outside)
+                {
+                    for (int64_t y = 0; y < rows; ++y)
+                    {
+                        int64_t w0 = block[0] + y * edges[0].step_y;
+                        int64_t w1 = block[1] + y * edges[1].step_y;
+                        int64_t w2 = block[2] + y * edges[2].step_y;
+
+                        for (int64_t x = bx; x < bx + columns; ++x)
+                        {
+                            if ((w0 | w1 | w2) >= 0)
+                            {
+                                first[y] = std::min(first[y], x);
+                                last[y] = x;
+                            }
+                            w0 += edges[0].step_x;
+                            w1 += edges[1].step_x;
+                            w2 += edges[2].step_x;
+                        }
+                    }
+                }
+
+                for (int64_t e = 0; e < 3; ++e)
+                    block[e] += TriangleBlock * edges[e].step_x;
+            }
+
+            for (int64_t y = 0; y < rows; ++y)
+                if (first[y] <= last[y])
+                    span(first[y], last[y], by + y);
+        }
+    }
+
+    template <typename Plot, typename Span>
+    inline void drawTriangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                             const int64_t y2, const int64_t x3, const int64_t y3,
+                             const bool fill, Plot plot, Span span, const Clip &clip = NoClip)
+        noexcept
+    {
+        if (fill)
+            fillTriangle(x1, y1, x2, y2, x3, y3, span, clip);
+        else
+        {
+            drawLine(x1, y1, x2, y2, plot, clip);
+            drawLine(x1, y1, x3, y3, plot, clip);
+            drawLine(x2, y2, x3, y3, plot, clip);
+        }
+    }
+
+    template <typename Plot, typename Span>
+    inline void drawRectangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                              const int64_t y2, const bool fill, Plot plot, Span span,
+                              const Clip &clip = NoClip) noexcept
+    {
+        const auto [xx1, xx2] = Common::Tools::minMax(x1, x2);
+        const auto [yy1, yy2] = Common::Tools::minMax(y1, y2);
+
+        if (fill)
+        {
+            for (int64_t y = std::max(yy1, clip.y1); y < std::min(yy2, clip.y2); ++y)
+                clipSpan(xx1, xx2, y, clip, span);
+        }
+        else
+        {
+            clipSpan(xx1, xx2, yy1, clip, span);
+            for (int64_t y = std::max(yy1, clip.y1); y <= std::min(yy2, clip.y2 - 1); ++y)
+            {
+                if ((xx1 >= clip.x1) && (xx1 < clip.x2))
+                    plot(xx1, y);
+                if ((xx2 >= clip.x1) && (xx2 < clip.x2))
+                    plot(xx2, y);
+            }
+            clipSpan(xx1, xx2, yy2, clip, span);
+        }
+    }
+
+    // the largest radius of an ellipse, so the squares of its squared size still fit
+    constexpr int64_t MaxRadius = 1 << 14;
+
+    //
+    // an ellipse is rasterized row by row, the half width of a row shrinks from the middle row
+    // to the top and bottom ones, so all of them are found in one pass over the rows
+    //
+    // - a pixel belongs to the ellipse when its center is inside of the ellipse with the radii
+    //   grown by half a pixel, so it is exactly 2 * radius + 1 pixels wide and high
+    // - filled, every row is a single span, the outline of a row is the part that the next row
+    //   further out does not cover but at least its outermost pixels, one span at the top and
+    //   bottom and two on the sides, so no pixel is written twice and the outline has no gaps
+    // - the radii must not exceed MaxRadius
+    //
+    template <typename Span>
+    inline void drawEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                            const int64_t radius_y, const bool fill, Span span,
+                            const Clip &clip = NoClip) noexcept
+    {
+        const int64_t rx = std::abs(radius_x);
+        const int64_t ry = std::abs(radius_y);
+        const int64_t width2 = (2 * rx + 1) * (2 * rx + 1);
+        const int64_t height2 = (2 * ry + 1) * (2 * ry + 1);
+        const int64_t limit = width2 * height2;
+
+        // the half width of row dy, starting from that of the row before
+        auto half = [&](int64_t dx, const int64_t dy)
+        {
+            while ((dx > 0) && (4 * dx * dx * height2 + 4 * dy * dy * width2 > limit))
+                --dx;
+
+            return dx;
+        };
+
+        int64_t outer = half(rx, 0);
+
+        for (int64_t dy = 0; dy <= ry; ++dy)
+        {
+            const int64_t next = dy < ry ? half(outer, dy + 1) : -1;
+            const int64_t first = std::min(next + 1, outer);
+
+            for (const int64_t yy : {y + dy, y - dy})
+            {
+                if (fill || (first == 0))
+                    clipSpan(x - outer, x + outer, yy, clip, span);
+                else
+                {
+                    clipSpan(x - outer, x - first, yy, clip, span);
+                    clipSpan(x + first, x + outer, yy, clip, span);
+                }
+
+                // the middle row only once
+                if (dy == 0)
+                    break;
+            }
+            outer = next;
+        }
+    }
+
+    //
+    // the anti-aliased shapes have coordinates in pixels, pixel (x, y) covers the square from
+    // (x, y) to (x + 1, y + 1), so its center is at (x + 0.5, y + 0.5), instead of setting
+    // pixels they hand out how much of a pixel is covered, from 0 to Opaque, blend(x, y, coverage)
+    // for a single pixel and blendSpan(x1, x2, y, coverage) for the pixels from x1 to x2 (both
+    // included) of a row, nothing is handed out for pixels they do not cover at all
+    //
+    constexpr uint32_t Opaque = 65535;
+
+    inline bool inGuardBand(const double value) noexcept
+    {
+        // false for NaN as well
+        return std::abs(value) <= GuardBand;
+    }
+
+    // a color over a pixel with the given alpha (0 to Opaque) in integers, the color channels
+    // are mixed and the alpha channels add up like one layer over another
+    template <typename Pixel>
+    inline Pixel blend(const Pixel pixel, const Pixel color, const uint32_t alpha) noexcept
+    {
+        using Channel = decltype(pixel.r);
+
+        constexpr uint64_t Max = std::numeric_limits<Channel>::max();
+        const uint64_t inverse = Opaque - alpha;
+
+        auto mix = [&](const uint64_t below, const uint64_t above)
+        {
+            return static_cast<Channel>((below * inverse + above * alpha + Opaque / 2) / Opaque);
+        };
+
+        return Pixel(mix(pixel.r, color.r), mix(pixel.g, color.g), mix(pixel.b, color.b),
+                     mix(pixel.a, Max));
+    }
+
+    //
+    // Xiaolin Wu's line, it steps along its major axis and covers the two pixels on the minor
+    // axis next to the exact position of the line by how close their centers are to it
+    //
+    // - the ends only cover the part of the end pixels the line reaches into
+    // - only the steps within the clip rectangle are taken
+    //
+    template <typename Blend>
+    inline void drawSmoothLine(double x1, double y1, double x2, double y2, Blend blend,
+                               const Clip &clip = NoClip) noexcept
+    {
+        const bool steep = std::abs(y2 - y1) > std::abs(x2 - x1);
+
+        // pixel centers on whole numbers
+        x1 -= 0.5;
+        y1 -= 0.5;
+        x2 -= 0.5;
+        y2 -= 0.5;
+        if (steep)
+        {
+            std::swap(x1, y1);
+            std::swap(x2, y2);
+        }
+        if (x1 > x2)
+        {
+            std::swap(x1, x2);
+            std::swap(y1, y2);
+        }
+
+        const double gradient = x2 > x1 ? (y2 - y1) / (x2 - x1) : 1.0;
+
+        auto plot = [&](const int64_t major, const int64_t minor, const double coverage)
+        {
+            const int64_t x = steep ? minor : major;
+            const int64_t y = steep ? major : minor;
+            const uint32_t value = static_cast<uint32_t>(std::lround(coverage * Opaque));
+
+            if ((value > 0) && (x >= clip.x1) && (x < clip.x2) && (y >= clip.y1) && (y < clip.y2))
+                blend(x, y, value);
+        };
+
+        auto step = [&](const int64_t major, const double minor, const double coverage)
+        {
+            const double row = std::floor(minor);
+
+            plot(major, static_cast<int64_t>(row), (1.0 - (minor - row)) * coverage);
+            plot(major, static_cast<int64_t>(row) + 1, (minor - row) * coverage);
+        };
+
+        auto end = [&](const double x, const double y, const double reach)
+        {
+            const double major = std::floor(x + 0.5);
+
+            step(static_cast<int64_t>(major), y + gradient * (major - x), reach);
+
+            return static_cast<int64_t>(major);
+        };
+
+        const int64_t first = end(x1, y1, 1.0 - (x1 + 0.5 - std::floor(x1 + 0.5)));
+        const int64_t last = end(x2, y2, x2 + 0.5 - std::floor(x2 + 0.5));
+        const int64_t from = std::max(first + 1, steep ? clip.y1 : clip.x1);
+        const int64_t to = std::min(last - 1, (steep ? clip.y2 : clip.x2) - 1);
+
+        for (int64_t major = from; major <= to; ++major)
+            step(major, y1 + gradient * (static_cast<double>(major) - x1), 1.0);
+    }
+
+    //
+    // a polygon is rasterized by accumulating signed areas like font rasterizers do, every edge
+    // adds the area it covers to the left of it in its rows to a buffer of cells, downwards
+    // edges add and upwards ones subtract, so the coverage of a pixel is the sum of all the cells
+    // up to it, which a single sweep over each row finds
+    //
+    // - nothing depends on the order of the edges, the work is the length of the edges and the
+    //   pixels of the bounding box, not the number of edges times the rows
+    // - overlapping parts are covered once (the non-zero rule), the polygon is closed from the
+    //   last point back to the first one, within a pixel the areas add up before that, so where
+    //   a polygon crosses itself the pixels are only close
+    // - the parts of the edges left or right of the clip rectangle are moved onto it, they still
+    //   cover the rows they pass but nothing of them is outside of the clip rectangle any more
+    // - equal coverage next to each other is handed out as one span, so the inside of a polygon
+    //   costs no more than a filled rectangle
+    // - the coordinates have to stay within the guard band
+    //
+    template <typename BlendSpan>
+    inline void fillSmoothPolygon(const std::vector<Math::Vector2<double>> &points,
+                                  BlendSpan blendSpan, const Clip &clip = NoClip) noexcept(false)
+    {
+        if (points.size() < 3)
+            return;
+
+        double min_x = points[0].x;
+        double min_y = points[0].y;
+        double max_x = points[0].x;
+        double max_y = points[0].y;
+
+        for (const Math::Vector2<double> &point : points)
+        {
+            min_x = std::min(min_x, point.x);
+            min_y = std::min(min_y, point.y);
+            max_x = std::max(max_x, point.x);
+            max_y = std::max(max_y, point.y);
+        }
+
+        const int64_t left = std::max(static_cast<int64_t>(std::floor(min_x)), clip.x1);
+        const int64_t top = std::max(static_cast<int64_t>(std::floor(min_y)), clip.y1);
+        const int64_t right = std::min(static_cast<int64_t>(std::ceil(max_x)), clip.x2);
+        const int64_t bottom = std::min(static_cast<int64_t>(std::ceil(max_y)), clip.y2);
+
+        if ((left >= right) || (top >= bottom))
+            return;
+
+        // two more cells per row, for what the edges on its right end leave
+        const int64_t width = right - left;
+        const int64_t height = bottom - top;
+        const int64_t stride = width + 2;
+        std::vector<float> cells(stride * height, 0.0f);
+
+        // an edge from (x1, y1) to (x2, y2) relative to the buffer, 0 <= x <= width
+        auto accumulate = [&](const double x1, const double y1, const double x2, const double y2)
+        {
+            if (y1 == y2)
+                return;
+
+            const float direction = y1 < y2 ? 1.0f : -1.0f;
+            const double from_x = y1 < y2 ? x1 : x2;
+            const double from_y = std::min(y1, y2);
+            const double to_y = std::max(y1, y2);
+            const double slope = ((y1 < y2 ? x2 : x1) - from_x) / (to_y - from_y);
+            const int64_t first = std::max(static_cast<int64_t>(std::floor(from_y)), int64_t(0));
+            const int64_t last = std::min(static_cast<int64_t>(std::ceil(to_y)), height);
+            double x = from_x + slope * std::max(-from_y, 0.0);
+
+            for (int64_t y = first; y < last; ++y)
+            {
+                float *row = cells.data() + y * stride;
+                const double dy = std::min(y + 1.0, to_y) - std::max(static_cast<double>(y),
+                                                                     from_y);
+                const double next_x = std::clamp(x + slope * dy, 0.0, static_cast<double>(width));
+                const float d = static_cast<float>(dy) * direction;
+                const double low = std::min(x, next_x);
+                const double high = std::max(x, next_x);
+                const double low_floor = std::floor(low);
+                const double high_ceil = std::ceil(high);
+                const int64_t x0_index = static_cast<int64_t>(low_floor);
+                const int64_t x1_index = static_cast<int64_t>(high_ceil);
+
+                if (x1_index <= x0_index + 1)
+                {
+                    // within a single cell, the area right of the edge goes to the next one
+                    const float middle = static_cast<float>(0.5 * (x + next_x) - low_floor);
+
+                    row[x0_index] += d - d * middle;
+                    row[x0_index + 1] += d * middle;
+                }
+                else
+                {
+                    // over several cells, a triangle in the first and last one and equal parts
+                    // in between
+                    const double scale = 1.0 / (high - low);
+                    const double x0_part = low - low_floor;
+                    const double x1_part = high - high_ceil + 1.0;
+                    const double first_area = 0.5 * scale * (1.0 - x0_part) * (1.0 - x0_part);
+                    const double last_area = 0.5 * scale * x1_part * x1_part;
+
+                    row[x0_index] += d * static_cast<float>(first_area);
+                    if (x1_index == x0_index + 2)
+                        row[x0_index + 1] += d * static_cast<float>(1.0 - first_area - last_area);
+                    else
+                    {
+                        const double second_area = scale * (1.5 - x0_part);
+
+                        row[x0_index + 1] += d * static_cast<float>(second_area - first_area);
+                        for (int64_t i = x0_index + 2; i < x1_index - 1; ++i)
+                            row[i] += d * static_cast<float>(scale);
+
+                        const double before_last = second_area + (x1_index - x0_index - 3) *
+                                                   scale;
+
+                        row[x1_index - 1] += d * static_cast<float>(1.0 - before_last -
+                                                                    last_area);
+                    }
+                    row[x1_index] += d * static_cast<float>(last_area);
+                }
+                x = next_x;
+            }
+        };
+
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            const Math::Vector2<double> &from = points[i];
+            const Math::Vector2<double> &to = points[(i + 1) % points.size()];
+            const double x1 = from.x - left;
+            const double y1 = from.y - top;
+            const double x2 = to.x - left;
+            const double y2 = to.y - top;
+
+            // cut where the edge crosses the left and right side, the parts outside go onto them
+            double cuts[4] = {0.0};
+            int64_t count = 1;
+
+            for (const double side : {0.0, static_cast<double>(width)})
+            {
+                const double t = (side - x1) / (x2 - x1);
+
+                if ((t > 0.0) && (t < 1.0))
+                    cuts[count++] = t;
+            }
+            std::sort(cuts + 1, cuts + count);
+            cuts[count] = 1.0;
+            for (int64_t j = 0; j < count; ++j)
+                accumulate(std::clamp(x1 + (x2 - x1) * cuts[j], 0.0, static_cast<double>(width)),
+                           y1 + (y2 - y1) * cuts[j],
+                           std::clamp(x1 + (x2 - x1) * cuts[j + 1], 0.0,
+                                      static_cast<double>(width)),
+                           y1 + (y2 - y1) * cuts[j + 1]);
+        }
+
+        // one sweep over every row, runs of equal coverage at once
+        for (int64_t y = 0; y < height; ++y)
+        {
+            const float *row = cells.data() + y * stride;
+            float sum = 0.0f;
+            int64_t start = 0;
+            uint32_t coverage = 0;
+
+            for (int64_t x = 0; x < width; ++x)
+            {
+                sum += row[x];
+
+                const uint32_t value = static_cast<uint32_t>(std::lround(std::min(std::abs(sum),
+                                                                                  1.0f) * Opaque));
+
+                if (value != coverage)
+                {
+                    if (coverage > 0)
+                        blendSpan(left + start, left + x - 1, top + y, coverage);
+                    start = x;
+                    coverage = value;
+                }
+            }
+            if (coverage > 0)
+                blendSpan(left + start, left + width - 1, top + y, coverage);
+        }
+    }
+
+    //
+    // what the drawing methods check before they draw anything, a shape is refused when its
+    // bounding box misses the clip rectangle or its points are outside of the guard band, the
+    // center of an ellipse as well, its radii may have either sign but not exceed MaxRadius
+    //
+    inline bool acceptsLine(const Clip &clip, const int64_t x1, const int64_t y1, const int64_t x2,
+                            const int64_t y2) noexcept
+    {
+        namespace T = Common::Tools;
+
+        return inGuardBand({x1, y1, x2, y2}) &&
+               touches(clip, T::min(x1, x2), T::min(y1, y2), T::max(x1, x2), T::max(y1, y2));
+    }
+
+    inline bool acceptsTriangle(const Clip &clip, const int64_t x1, const int64_t y1,
+                                const int64_t x2, const int64_t y2, const int64_t x3,
+                                const int64_t y3) noexcept
+    {
+        namespace T = Common::Tools;
+
+        return inGuardBand({x1, y1, x2, y2, x3, y3}) &&
+               touches(clip, T::min(x1, x2, x3), T::min(y1, y2, y3), T::max(x1, x2, x3),
+                       T::max(y1, y2, y3));
+    }
+
+    inline bool acceptsRectangle(const Clip &clip, const int64_t x1, const int64_t y1,
+                                 const int64_t x2, const int64_t y2) noexcept
+    {
+        namespace T = Common::Tools;
+
+        return touches(clip, T::min(x1, x2), T::min(y1, y2), T::max(x1, x2), T::max(y1, y2));
+    }
+
+    inline bool acceptsEllipse(const Clip &clip, const int64_t x, const int64_t y,
+                               const int64_t radius_x, const int64_t radius_y) noexcept
+    {
+        if (!inGuardBand({x, y}) || (radius_x < -MaxRadius) || (radius_x > MaxRadius) ||
+          (radius_y < -MaxRadius) || (radius_y > MaxRadius))
+            return false;
+
+        const int64_t rx = std::abs(radius_x);
+        const int64_t ry = std::abs(radius_y);
+
+        return touches(clip, x - rx, y - ry, x + rx, y + ry);
+    }
+
+    inline bool acceptsSmoothLine(const Clip &clip, const double x1, const double y1,
+                                  const double x2, const double y2) noexcept
+    {
+        namespace T = Common::Tools;
+
+        return inGuardBand(x1) && inGuardBand(y1) && inGuardBand(x2) && inGuardBand(y2) &&
+               touches(clip, std::floor(T::min(x1, x2) - 0.5), std::floor(T::min(y1, y2) - 0.5),
+                       std::floor(T::max(x1, x2) + 0.5), std::floor(T::max(y1, y2) + 0.5));
+    }
+
+    // a polygon needs three points at least
+    inline bool acceptsSmoothPolygon(const Clip &clip,
+                                     const std::vector<Math::Vector2<double>> &points) noexcept
+    {
+        namespace T = Common::Tools;
+
+        if (points.size() < 3)
+            return false;
+
+        Math::Vector2<double> low = points[0];
+        Math::Vector2<double> high = points[0];
+
+        for (const Math::Vector2<double> &point : points)
+        {
+            if (!inGuardBand(point.x) || !inGuardBand(point.y))
+                return false;
+
+            low = Math::Vector2<double>(T::min(low.x, point.x), T::min(low.y, point.y));
+            high = Math::Vector2<double>(T::max(high.x, point.x), T::max(high.y, point.y));
+        }
+
+        return touches(clip, std::floor(low.x), std::floor(low.y), std::floor(high.x),
+                       std::floor(high.y));
+    }
+}
@@ -22,6 +22,7 @@ namespace Image
         Farbfeld(const int64_t width, const int64_t height, const RGBA color = RGBA::Black)
             noexcept(false);
         Farbfeld(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        explicit Farbfeld(const Base &image) noexcept(false);
         Farbfeld(const Farbfeld &rhs) noexcept(false);
         Farbfeld(Farbfeld &&rhs) noexcept;
         virtual ~Farbfeld() noexcept;
@@ -0,0 +1,567 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <iterator>
+#if defined __x86_64__
+#include <immintrin.h>
+#endif
+#include "Common/ThreadPool.hxx"
+#include "CpuDetail.hxx"
+#include "FilterDetail.hxx"
+
+namespace Image::Detail
+{
+    //--- internal stuff ---
+
+    //
+    // Kernel - compile time 3x3 kernel, the divisor is the sum of the weights (or 1 if that is 0),
+    //          matching the normalization the float version of Base::implFilter used
+    //
+    template <int32_t ...W>
+    struct Kernel {
+        static_assert (sizeof... (W) == 9, "compile error: 3x3 kernels only");
+
+        static constexpr std::array<int32_t,9> Weights = {W...};
+        static constexpr int32_t Sum = (W + ...);
+        static constexpr int32_t Divisor = Sum == 0 ? 1 : Sum;
+        static constexpr bool PowerOfTwo = (Divisor > 0) && !(Divisor & (Divisor - 1));
+        static constexpr int32_t Shift = std::countr_zero(static_cast<uint32_t>(Divisor));
+    };
+
+    using SmoothKernel = Kernel<1, 1, 1, 1, 2, 1, 1, 1, 1>;
+    using SharpenKernel = Kernel<-1, -1, -1, -1, 9, -1, -1, -1, -1>;
+    using EdgeKernel = Kernel<-1, -1, -1, -1, 8, -1, -1, -1, -1>;
+    using BlurKernel = Kernel<0, 0, 1, 0, 0, 0, 1, 0, 0>;
+    using RaisedKernel = Kernel<0, 0, -2, 0, 2, 0, 1, 0, 0>;
+
+    // the sums of all kernels fit easily into 24 bits, so integer math gives exactly the same
+    // results as the former float accumulation, including the truncation of the division
+    template <typename K>
+    static inline int32_t scalarChannel(const int32_t (&values)[9]) noexcept
+    {
+        int32_t sum = 0;
+
+        for (size_t k = 0; k < 9; ++k)
+            sum += values[k] * K::Weights[k];
+
+        return std::clamp(sum / K::Divisor, 0, 0xFFFF);
+    }
+
+    template <typename K>
+    static inline void scalarRow(const RGBA *above, const RGBA *row, const RGBA *below, RGBA *out,
+                                 const int64_t begin, const int64_t end) noexcept
+    {
+        int32_t red[9];
+        int32_t green[9];
+        int32_t blue[9];
+
+        for (int64_t x = begin; x < end; ++x)
+        {
+            const RGBA *rows[3] = {above + x - 1, row + x - 1, below + x - 1};
+
+            for (size_t k = 0; k < 9; ++k)
+            {
+                const RGBA &pixel = rows[k / 3][k % 3];
+
+                red[k] = pixel.r;
+                green[k] = pixel.g;
+                blue[k] = pixel.b;
+            }
+
+            out[x].set(scalarChannel<K>(red), scalarChannel<K>(green), scalarChannel<K>(blue),
+                       row[x].a);
+        }
+    }
+
+#if defined __x86_64__
+    //
+    // SSE2 path - one pixel per iteration, all four channels in 32 bit lanes
+    //
+    template <int32_t F>
+    static inline __m128i sse2Mul(const __m128i val) noexcept
+    {
+        if constexpr (F == 1)
+            return val;
+        else if constexpr (F % 2 == 0)
+            return _mm_slli_epi32(sse2Mul<F / 2>(val), 1);
+        else
+            return _mm_add_epi32(sse2Mul<F - 1>(val), val);
+    }
+
+    template <int32_t W>
+    static inline __m128i sse2Accumulate(const __m128i sum, const RGBA *pixel) noexcept
+    {
+        if constexpr (W == 0)
+            return sum;
+        else
+        {
+            const __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pixel));
+            const __m128i val = _mm_unpacklo_epi16(raw, _mm_setzero_si128());
+
+            if constexpr (W > 0)
+                return _mm_add_epi32(sum, sse2Mul<W>(val));
+            else
+                return _mm_sub_epi32(sum, sse2Mul<-W>(val));
+        }
+    }
+
+    template <typename K>
+    static inline __m128i sse2Divide(const __m128i sum) noexcept
+    {
+        if constexpr (K::Divisor == 1)
+            return sum;
+        else if constexpr (K::PowerOfTwo)
+        {
+            // truncate towards zero like the integer division does
+            const __m128i bias = _mm_and_si128(_mm_srai_epi32(sum, 31),
+                                               _mm_set1_epi32(K::Divisor - 1));
+
+            return _mm_srai_epi32(_mm_add_epi32(sum, bias), K::Shift);
+        }
+        else
+            return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(sum),
+                                               _mm_set1_ps(K::Divisor)));
+    }
+
+    template <typename K>
+    static void sse2Row(const RGBA *above, const RGBA *row, const RGBA *below, RGBA *out,
+                        const int64_t begin, const int64_t end) noexcept
+    {
+        constexpr auto &W = K::Weights;
+        const __m128i bias = _mm_set1_epi32(0x8000);
+        const __m128i flip = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+
+        for (int64_t x = begin; x < end; ++x)
+        {
+            __m128i sum = _mm_setzero_si128();
+
+            sum = sse2Accumulate<W[0]>(sum, above + x - 1);
+            sum = sse2Accumulate<W[1]>(sum, above + x);
+            sum = sse2Accumulate<W[2]>(sum, above + x + 1);
+            sum = sse2Accumulate<W[3]>(sum, row + x - 1);
+            sum = sse2Accumulate<W[4]>(sum, row + x);
+            sum = sse2Accumulate<W[5]>(sum, row + x + 1);
+            sum = sse2Accumulate<W[6]>(sum, below + x - 1);
+            sum = sse2Accumulate<W[7]>(sum, below + x);
+            sum = sse2Accumulate<W[8]>(sum, below + x + 1);
+            sum = sse2Divide<K>(sum);
+
+            // SSE2 has no unsigned saturation for 32 bit lanes, so shift the range to signed
+            // 16 bit, saturate and shift it back, which clamps to 0 - 0xFFFF
+            sum = _mm_sub_epi32(sum, bias);
+            sum = _mm_xor_si128(_mm_packs_epi32(sum, sum), flip);
+            out[x].value = (static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) & ~0xFFFFull) |
+                           (row[x].value & 0xFFFFull);
+        }
+    }
+
+    //
+    // AVX2 path - two pixels per iteration, the remainder is done by the SSE2 path
+    //
+    template <int32_t F>
+    static __attribute__((target("avx2"))) inline __m256i avx2Mul(const __m256i val) noexcept
+    {
+        if constexpr (F == 1)
+            return val;
+        else if constexpr (F % 2 == 0)
+            return _mm256_slli_epi32(avx2Mul<F / 2>(val), 1);
+        else
+            return _mm256_add_epi32(avx2Mul<F - 1>(val), val);
+    }
+
+    template <int32_t W>
+    static __attribute__((target("avx2"))) inline __m256i avx2Accumulate(const __m256i sum,
+                                                                        const RGBA *pixels) noexcept
+    {
+        if constexpr (W == 0)
+            return sum;
+        else
+        {
+            const __m256i val = _mm256_cvtepu16_epi32(
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels)));
+
+            if constexpr (W > 0)
+                return _mm256_add_epi32(sum, avx2Mul<W>(val));
+            else
+                return _mm256_sub_epi32(sum, avx2Mul<-W>(val));
+        }
+    }
+
+    template <typename K>
+    static __attribute__((target("avx2"))) inline __m256i avx2Divide(const __m256i sum) noexcept
+    {
+        if constexpr (K::Divisor == 1)
+            return sum;
+        else if constexpr (K::PowerOfTwo)
+        {
+            const __m256i bias = _mm256_and_si256(_mm256_srai_epi32(sum, 31),
+                                                  _mm256_set1_epi32(K::Divisor - 1));
+
+            return _mm256_srai_epi32(_mm256_add_epi32(sum, bias), K::Shift);
+        }
+        else
+            return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(sum),
+                                                     _mm256_set1_ps(K::Divisor)));
+    }
+
+    template <typename K>
+    static __attribute__((target("avx2"))) void avx2Row(const RGBA *above, const RGBA *row,
+                                                        const RGBA *below, RGBA *out,
+                                                        const int64_t begin, const int64_t end)
+        noexcept
+    {
+        constexpr auto &W = K::Weights;
+        int64_t x = begin;
+
+        for (; (x + 1) < end; x += 2)
+        {
+            __m256i sum = _mm256_setzero_si256();
+
+            sum = avx2Accumulate<W[0]>(sum, above + x - 1);
+            sum = avx2Accumulate<W[1]>(sum, above + x);
+            sum = avx2Accumulate<W[2]>(sum, above + x + 1);
+            sum = avx2Accumulate<W[3]>(sum, row + x - 1);
+            sum = avx2Accumulate<W[4]>(sum, row + x);
+            sum = avx2Accumulate<W[5]>(sum, row + x + 1);
+            sum = avx2Accumulate<W[6]>(sum, below + x - 1);
+            sum = avx2Accumulate<W[7]>(sum, below + x);
+            sum = avx2Accumulate<W[8]>(sum, below + x + 1);
+            sum = avx2Divide<K>(sum);
+
+            // saturate per lane, gather both pixels in the lower half and keep the source alpha
+            const __m128i packed = _mm256_castsi256_si128(
+                                       _mm256_permute4x64_epi64(_mm256_packus_epi32(sum, sum),
+                                                                0x08));
+            const __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x),
+                             _mm_blend_epi16(packed, center, 0x11));
+        }
+
+        // leave the upper halves clean, the SSE2 code would pay for every instruction otherwise
+        _mm256_zeroupper();
+        sse2Row<K>(above, row, below, out, x, end);
+    }
+#endif
+
+    template <typename K>
+    static inline void kernelRow(const RGBA *above, const RGBA *row, const RGBA *below, RGBA *out,
+                                 const int64_t width) noexcept
+    {
+#if defined __x86_64__
+        if (hasAvx2())
+            avx2Row<K>(above, row, below, out, 1, width - 1);
+        else
+            sse2Row<K>(above, row, below, out, 1, width - 1);
+#else
+        scalarRow<K>(above, row, below, out, 1, width - 1);
+#endif
+    }
+
+    //
+    // box passes - the channels of a pixel are four 16 bit lanes that are all treated the same, so
+    // the passes work on lanes and do not care about their order, the sums are updated by one
+    // sample entering and one leaving the window per pixel, the edges are clamped
+    //
+    // - the average of a window is (sum * inverse + Round) >> Shift with the fixed point
+    //   reciprocal of its size, one per pass instead of a division per channel and pixel, with 47
+    //   fraction bits it is the rounded division for every 32 bit sum
+    // - Sum is 32 bits as long as the window of 16 bit samples can not overflow it, the wider sums
+    //   of larger windows are divided, the product would not fit into 64 bits any more
+    // - the window of the first pixel is summed in closed form, the part of it beyond an edge is
+    //   that edge repeated, so a pass costs the same for any radius
+    //
+    constexpr int64_t Lanes = 4;
+    constexpr int64_t Shift = 47;
+    constexpr uint64_t Round = 1ull << (Shift - 1);
+    constexpr int64_t MaxNarrowCount = 65537;
+
+    // the columns the vertical passes run over at once, a row of them is a few cache lines
+    constexpr int64_t StripWidth = 128;
+
+    static inline uint64_t reciprocal(const uint64_t count) noexcept
+    {
+        return ((1ull << Shift) + count / 2) / count;
+    }
+
+    template <typename Sum>
+    static inline uint16_t average(const Sum sum, const uint64_t inverse, const uint64_t count)
+        noexcept
+    {
+        if constexpr (sizeof (Sum) < sizeof (uint64_t))
+            return static_cast<uint16_t>((sum * inverse + Round) >> Shift);
+        else
+            return static_cast<uint16_t>((sum + count / 2) / count);
+    }
+
+    static inline uint16_t *lanes(RGBA *pixels) noexcept
+    {
+        return reinterpret_cast<uint16_t *>(pixels);
+    }
+
+    // one pass over a row from in to out, these must not overlap
+    template <typename Sum>
+    static void boxRow(const uint16_t *in, uint16_t *out, const int64_t length,
+                       const int64_t radius) noexcept
+    {
+        const uint64_t count = 2 * radius + 1;
+        const uint64_t inverse = reciprocal(count);
+        const int64_t inside = std::min(radius, length - 1);
+        const uint16_t *last = in + (length - 1) * Lanes;
+        Sum sums[Lanes];
+
+        for (int64_t lane = 0; lane < Lanes; ++lane)
+            sums[lane] = static_cast<Sum>(radius) * in[lane] +
+                         static_cast<Sum>(radius - inside) * last[lane];
+        for (int64_t i = 0; i <= inside; ++i)
+            for (int64_t lane = 0; lane < Lanes; ++lane)
+                sums[lane] += in[i * Lanes + lane];
+
+        for (int64_t i = 0; i < length; ++i)
+        {
+            const uint16_t *enter = in + std::min(i + radius + 1, length - 1) * Lanes;
+            const uint16_t *leave = in + std::max<int64_t>(i - radius, 0) * Lanes;
+
+            for (int64_t lane = 0; lane < Lanes; ++lane)
+            {
+                out[i * Lanes + lane] = average(sums[lane], inverse, count);
+                sums[lane] += enter[lane] - leave[lane];
+            }
+        }
+    }
+
+    //
+    // one pass down a strip of columns, row by row with a row of running sums, the pass is in
+    // place, so the rows that leave the window later on are kept in a ring of radius + 1 rows
+    // before they are overwritten
+    //
+    template <typename Sum>
+    static void boxStrip(RGBA *pixels, const int64_t width, const int64_t height,
+                         const int64_t stride, const int64_t radius, std::vector<Sum> &sums,
+                         std::vector<RGBA> &ring) noexcept
+    {
+        const uint64_t count = 2 * radius + 1;
+        const uint64_t inverse = reciprocal(count);
+        const int64_t slots = std::min(radius + 1, height);
+        const int64_t size = width * Lanes;
+        const int64_t inside = std::min(radius, height - 1);
+        const uint16_t *first = lanes(pixels);
+        const uint16_t *last = lanes(pixels + (height - 1) * stride);
+
+        for (int64_t j = 0; j < size; ++j)
+            sums[j] = static_cast<Sum>(radius) * first[j] +
+                      static_cast<Sum>(radius - inside) * last[j];
+        for (int64_t i = 0; i <= inside; ++i)
+        {
+            const uint16_t *row = lanes(pixels + i * stride);
+
+            for (int64_t j = 0; j < size; ++j)
+                sums[j] += row[j];
+        }
+
+        for (int64_t y = 0; y < height; ++y)
+        {
+            RGBA *row = pixels + y * stride;
+            uint16_t *out = lanes(row);
+
+            std::copy_n(row, width, ring.begin() + (y % slots) * width);
+            for (int64_t j = 0; j < size; ++j)
+                out[j] = average(sums[j], inverse, count);
+
+            if ((y + 1) == height)
+                break;
+
+            // the row entering is further down and still untouched, the one leaving is in the ring
+            const uint16_t *enter = lanes(pixels + std::min(y + radius + 1, height - 1) * stride);
+            const uint16_t *leave = lanes(ring.data() +
+                                          (std::max<int64_t>(y - radius, 0) % slots) * width);
+
+            for (int64_t j = 0; j < size; ++j)
+                sums[j] += enter[j] - leave[j];
+        }
+    }
+
+    template <typename Sum>
+    static void boxRows(RGBA *pixels, const int64_t width, const int64_t height,
+                        const int64_t stride, const std::vector<int64_t> &radii,
+                        const int64_t threads) noexcept(false)
+    {
+        Common::ThreadPool::global().runBands(height, threads,
+            [&](const int64_t begin, const int64_t end)
+        {
+            std::vector<RGBA> scratch(width);
+
+            // ping-pong between the row and the scratch line, an odd count ends in the scratch
+            for (int64_t y = begin; y < end; ++y)
+            {
+                RGBA *buffers[2] = {pixels + y * stride, scratch.data()};
+                int64_t current = 0;
+
+                for (const int64_t radius : radii)
+                {
+                    boxRow<Sum>(lanes(buffers[current]), lanes(buffers[1 - current]), width,
+                                radius);
+                    current = 1 - current;
+                }
+                if (current)
+                    std::copy_n(scratch.data(), width, pixels + y * stride);
+            }
+        });
+    }
+
+    template <typename Sum>
+    static void boxColumns(RGBA *pixels, const int64_t width, const int64_t height,
+                           const int64_t stride, const std::vector<int64_t> &radii,
+                           const int64_t threads) noexcept(false)
+    {
+        const int64_t strips = (width + StripWidth - 1) / StripWidth;
+        const int64_t slots = std::min(*std::max_element(radii.begin(), radii.end()) + 1, height);
+
+        Common::ThreadPool::global().runBands(strips, threads,
+            [&](const int64_t begin, const int64_t end)
+        {
+            std::vector<Sum> sums(StripWidth * Lanes);
+            std::vector<RGBA> ring(slots * StripWidth);
+
+            for (int64_t strip = begin; strip < end; ++strip)
+            {
+                const int64_t first = strip * StripWidth;
+                const int64_t columns = std::min(StripWidth, width - first);
+
+                for (const int64_t radius : radii)
+                    boxStrip<Sum>(pixels + first, columns, height, stride, radius, sums, ring);
+            }
+        });
+    }
+
+    //--- public functions ---
+
+    void filterRow(const Filter filter, const RGBA *above, const RGBA *row, const RGBA *below,
+                   RGBA *out, const int64_t width) noexcept
+    {
+        switch (filter)
+        {
+            case Filter::Smooth:
+                kernelRow<SmoothKernel>(above, row, below, out, width);
+                break;
+
+            case Filter::Sharpen:
+                kernelRow<SharpenKernel>(above, row, below, out, width);
+                break;
+
+            case Filter::Edge:
+                kernelRow<EdgeKernel>(above, row, below, out, width);
+                break;
+
+            case Filter::Blur:
+                kernelRow<BlurKernel>(above, row, below, out, width);
+                break;
+
+            case Filter::Raised:
+                kernelRow<RaisedKernel>(above, row, below, out, width);
+                break;
+
+            case Filter::BoxBlur:
+            case Filter::GaussianBlur:
+                // not 3x3 kernels, see boxBlur()
+                break;
+        }
+    }
+
+    std::vector<int64_t> gaussianBoxes(const double sigma) noexcept(false)
+    {
+        // the variance of n successive boxes of the width w is n * (w * w - 1) / 12, so pick the
+        // odd width below the ideal one and widen the first boxes until the variance fits
+        const int64_t passes = 3;
+        const double ideal = std::sqrt(12 * sigma * sigma / passes + 1);
+        int64_t lower = std::floor(ideal);
+
+        if (!(lower & 1))
+            --lower;
+
+        const int64_t upper = lower + 2;
+        const int64_t larger = std::llround((12 * sigma * sigma - passes * lower * lower -
+                                            4 * passes * lower - 3 * passes) / (-4 * lower - 4));
+        std::vector<int64_t> radii;
+
+        for (int64_t i = 0; i < passes; ++i)
+            radii.push_back(((i < larger ? lower : upper) - 1) / 2);
+
+        return radii;
+    }
+
+    void filter(const Filter filter, RGBA *pixels, const int64_t width, const int64_t height,
+                const int64_t stride, const int64_t threads) noexcept(false)
+    {
+        const int64_t bands = std::clamp<int64_t>(threads, 1, height - 2);
+        std::vector<std::vector<RGBA>> edges(bands * 2);
+        auto &pool = Common::ThreadPool::global();
+
+        // the interior rows are filtered in place, every band keeps copies of the original rows
+        // above, at and below the current one in a three row ring, but the rows just outside of a
+        // band belong to its neighbours (or the border), so these are saved before anyone writes
+        pool.run(bands, [&](const int64_t band)
+        {
+            const int64_t begin = 1 + (height - 2) * band / bands;
+            const int64_t end = 1 + (height - 2) * (band + 1) / bands;
+            const RGBA *first = pixels + (begin - 1) * stride;
+            const RGBA *last = pixels + end * stride;
+
+            edges[band * 2].assign(first, first + width);
+            edges[band * 2 + 1].assign(last, last + width);
+        });
+
+        pool.run(bands, [&](const int64_t band)
+        {
+            const int64_t begin = 1 + (height - 2) * band / bands;
+            const int64_t end = 1 + (height - 2) * (band + 1) / bands;
+            const std::vector<RGBA> &below_end = edges[band * 2 + 1];
+            std::vector<RGBA> ring[3] = {edges[band * 2], std::vector<RGBA>(width),
+                                         std::vector<RGBA>(width)};
+
+            std::copy_n(pixels + begin * stride, width, ring[1].begin());
+            for (int64_t y = begin, slot = 0; y < end; ++y, slot = (slot + 1) % 3)
+            {
+                const RGBA *below = (y + 1) < end ? pixels + (y + 1) * stride : below_end.data();
+                std::vector<RGBA> &next = ring[(slot + 2) % 3];
+                RGBA *row = pixels + y * stride;
+
+                std::copy_n(below, width, next.begin());
+                filterRow(filter, ring[slot].data(), ring[(slot + 1) % 3].data(), next.data(), row,
+                          width);
+                row[0] = RGBA::Black;
+                row[width - 1] = RGBA::Black;
+            }
+
+            // the border rows are only read through the saved edges
+            if (band == 0)
+                std::fill_n(pixels, width, RGBA::Black);
+            if (band == (bands - 1))
+                std::fill_n(pixels + (height - 1) * stride, width, RGBA::Black);
+        });
+    }
+
+    void boxBlur(RGBA *pixels, const int64_t width, const int64_t height, const int64_t stride,
+                 const std::vector<int64_t> &radii, const int64_t threads) noexcept(false)
+    {
+        // a box of a single pixel changes nothing
+        std::vector<int64_t> passes;
+
+        std::copy_if(radii.begin(), radii.end(), std::back_inserter(passes),
+                     [](const int64_t radius) { return radius > 0; });
+        if (passes.empty())
+            return;
+
+        if ((2 * *std::max_element(passes.begin(), passes.end()) + 1) <= MaxNarrowCount)
+        {
+            boxRows<uint32_t>(pixels, width, height, stride, passes, threads);
+            boxColumns<uint32_t>(pixels, width, height, stride, passes, threads);
+        }
+        else
+        {
+            boxRows<uint64_t>(pixels, width, height, stride, passes, threads);
+            boxColumns<uint64_t>(pixels, width, height, stride, passes, threads);
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Base.hxx"
+
+namespace Image::Detail
+{
+    using RGBA = Base::RGBA;
+
+    // applies one of the 3x3 filters to a single row, only out[1] to out[width - 2] are written,
+    // the three input rows must not overlap with the output row
+    void filterRow(const Filter filter, const RGBA *above, const RGBA *row, const RGBA *below,
+                   RGBA *out, const int64_t width) noexcept;
+
+    // applies one of the 3x3 filters in place to an image whose rows are stride pixels apart, the
+    // border ends up black, every band of rows only keeps a ring of three rows as scratch
+    void filter(const Filter filter, RGBA *pixels, const int64_t width, const int64_t height,
+                const int64_t stride, const int64_t threads) noexcept(false);
+
+    // box radii of three successive box blurs approximating a gaussian blur of the given sigma
+    std::vector<int64_t> gaussianBoxes(const double sigma) noexcept(false);
+
+    // runs one running sum box blur per radius over the rows and then over the columns, the cost
+    // per pixel does not depend on the radius, the columns are walked row by row in strips with a
+    // row of sums and a ring of the last radius + 1 rows per strip as scratch
+    void boxBlur(RGBA *pixels, const int64_t width, const int64_t height, const int64_t stride,
+                 const std::vector<int64_t> &radii, const int64_t threads) noexcept(false);
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "Codec.hxx"
+#include "Compact.hxx"
 #include "Farbfeld.hxx"
+#include "Indexed.hxx"
+#include "Picture.hxx"
 #include "PPM.hxx"
 #include "Simple00.hxx"
 #include "Simple01.hxx"
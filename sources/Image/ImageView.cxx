@@ -0,0 +1,540 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include "Color/MiddleCutQuantizer.hxx"
+#include "Common/Tools.hxx"
+#include "Base.hxx"
+#include "ConvolveDetail.hxx"
+#include "DrawDetail.hxx"
+#include "FilterDetail.hxx"
+#include "ImageView.hxx"
+#include "PixelDetail.hxx"
+#include "ResampleDetail.hxx"
+#include "RotateDetail.hxx"
+
+namespace Image
+{
+    //--- internal stuff ---
+
+    namespace T = Common::Tools;
+
+    //--- public constructors ---
+
+    ImageView::ImageView() noexcept
+    : _pixels(nullptr), _width(0), _height(0), _stride(0)
+    {
+    }
+
+    ImageView::ImageView(const RGBA *pixels, const int64_t width, const int64_t height,
+                         const int64_t stride) noexcept(false)
+    : _pixels(pixels), _width(width), _height(height), _stride(stride)
+    {
+        if ((width < 0) || (height < 0) || (stride < width))
+            throw std::invalid_argument("view needs a positive size and a stride of at least its "
+                                        "width");
+
+        if (!pixels && width && height)
+            throw std::invalid_argument("view of no pixels");
+    }
+
+    ImageView::ImageView(const ImageView &rhs) noexcept
+    : _pixels(rhs._pixels), _width(rhs._width), _height(rhs._height), _stride(rhs._stride)
+    {
+    }
+
+    ImageView::ImageView(ImageView &&rhs) noexcept
+    : _pixels(rhs._pixels), _width(rhs._width), _height(rhs._height), _stride(rhs._stride)
+    {
+    }
+
+    ImageView::~ImageView() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    ImageView &ImageView::operator=(const ImageView &rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _pixels = rhs._pixels;
+            _width = rhs._width;
+            _height = rhs._height;
+            _stride = rhs._stride;
+        }
+
+        return *this;
+    }
+
+    ImageView &ImageView::operator=(ImageView &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _pixels = rhs._pixels;
+            _width = rhs._width;
+            _height = rhs._height;
+            _stride = rhs._stride;
+        }
+
+        return *this;
+    }
+
+    bool ImageView::operator==(const ImageView &rhs) const noexcept
+    {
+        if ((_width != rhs._width) || (_height != rhs._height))
+            return false;
+
+        for (int64_t y = 0; y < _height; ++y)
+            if (!std::equal(row(y), row(y) + _width, rhs.row(y)))
+                return false;
+
+        return true;
+    }
+
+    bool ImageView::operator!=(const ImageView &rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    //--- public methods ---
+
+    int64_t ImageView::width() const noexcept
+    {
+        return _width;
+    }
+
+    int64_t ImageView::height() const noexcept
+    {
+        return _height;
+    }
+
+    int64_t ImageView::stride() const noexcept
+    {
+        return _stride;
+    }
+
+    bool ImageView::contiguous() const noexcept
+    {
+        return (_stride == _width) || (_height < 2);
+    }
+
+    const ImageView::RGBA *ImageView::data() const noexcept
+    {
+        return _pixels;
+    }
+
+    const ImageView::RGBA *ImageView::row(const int64_t y) const noexcept
+    {
+        return _pixels + y * _stride;
+    }
+
+    ImageView::RGBA ImageView::pixel(const int64_t x, const int64_t y) const noexcept(false)
+    {
+        if (!implContains(x, y))
+            throw std::out_of_range("pixel outside of the view");
+
+        return row(y)[x];
+    }
+
+    ImageView::Pixels ImageView::pixels() const noexcept(false)
+    {
+        Pixels result;
+
+        result.reserve(_width * _height);
+        for (int64_t y = 0; y < _height; ++y)
+            result.insert(result.end(), row(y), row(y) + _width);
+
+        return result;
+    }
+
+    ImageView ImageView::view(const int64_t x, const int64_t y, const int64_t width,
+                              const int64_t height) const noexcept(false)
+    {
+        implCheckRect(x, y, width, height);
+
+        return ImageView(row(y) + x, width, height, _stride);
+    }
+
+    //--- protected methods ---
+
+    bool ImageView::implContains(const int64_t x, const int64_t y) const noexcept
+    {
+        return T::inRange(x, 0, _width, true, false) && T::inRange(y, 0, _height, true, false);
+    }
+
+    void ImageView::implCheckRect(const int64_t x, const int64_t y, const int64_t width,
+                                  const int64_t height) const noexcept(false)
+    {
+        if ((x < 0) || (y < 0) || !Detail::validRect(x, y, width, height, _width, _height))
+            throw std::out_of_range("rectangle outside of the view");
+    }
+
+    //--- public constructors ---
+
+    MutableImageView::MutableImageView() noexcept
+    : ImageView()
+    {
+    }
+
+    MutableImageView::MutableImageView(RGBA *pixels, const int64_t width, const int64_t height,
+                                       const int64_t stride) noexcept(false)
+    : ImageView(pixels, width, height, stride)
+    {
+    }
+
+    MutableImageView::MutableImageView(const MutableImageView &rhs) noexcept
+    : ImageView(rhs)
+    {
+    }
+
+    MutableImageView::MutableImageView(MutableImageView &&rhs) noexcept
+    : ImageView(std::move(rhs))
+    {
+    }
+
+    MutableImageView::~MutableImageView() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    MutableImageView &MutableImageView::operator=(const MutableImageView &rhs) noexcept
+    {
+        ImageView::operator=(rhs);
+
+        return *this;
+    }
+
+    MutableImageView &MutableImageView::operator=(MutableImageView &&rhs) noexcept
+    {
+        ImageView::operator=(std::move(rhs));
+
+        return *this;
+    }
+
+    //--- public methods ---
+
+    MutableImageView::RGBA *MutableImageView::data() const noexcept
+    {
+        // the pixels came in writable through the constructor
+        return const_cast<RGBA *>(_pixels);
+    }
+
+    MutableImageView::RGBA *MutableImageView::row(const int64_t y) const noexcept
+    {
+        return data() + y * _stride;
+    }
+
+    MutableImageView MutableImageView::view(const int64_t x, const int64_t y, const int64_t width,
+                                            const int64_t height) const noexcept(false)
+    {
+        implCheckRect(x, y, width, height);
+
+        return MutableImageView(row(y) + x, width, height, _stride);
+    }
+
+    void MutableImageView::fill(const RGBA color) const noexcept
+    {
+        for (int64_t y = 0; y < _height; ++y)
+            std::fill_n(row(y), _width, color);
+    }
+
+    bool MutableImageView::copy(const ImageView &source) const noexcept
+    {
+        if ((source.width() != _width) || (source.height() != _height))
+            return false;
+
+        for (int64_t y = 0; y < _height; ++y)
+            std::copy_n(source.row(y), _width, row(y));
+
+        return true;
+    }
+
+    void MutableImageView::flipVertical(const int64_t threads) const noexcept(false)
+    {
+        Detail::flipVertical(data(), _width, _height, _stride, threads);
+    }
+
+    void MutableImageView::flipHorizontal(const int64_t threads) const noexcept(false)
+    {
+        Detail::flipHorizontal(data(), _width, _height, _stride, threads);
+    }
+
+    bool MutableImageView::filter(const Filter filter, const int64_t radius,
+                                  const int64_t threads) const noexcept(false)
+    {
+        switch (filter)
+        {
+            case Filter::BoxBlur:
+            case Filter::GaussianBlur:
+                if ((_width > 0) && (_height > 0) && (radius > 0))
+                {
+                    // the gaussian uses the same sigma as Kernel::gaussian() for this radius
+                    const std::vector<int64_t> radii = filter == Filter::BoxBlur ?
+                        std::vector<int64_t>{radius} :
+                        Detail::gaussianBoxes(std::max(radius / 3.0, 0.5));
+
+                    Detail::boxBlur(data(), _width, _height, _stride, radii, threads);
+
+                    return true;
+                }
+                break;
+
+            default:
+                if ((_width > 2) && (_height > 2))
+                {
+                    Detail::filter(filter, data(), _width, _height, _stride, threads);
+
+                    return true;
+                }
+                break;
+        }
+
+        return false;
+    }
+
+    bool MutableImageView::convolve(const Kernel &kernel, const Border border,
+                                    const int64_t threads) const noexcept(false)
+    {
+        if ((_width > 0) && (_height > 0))
+        {
+            Detail::convolve(data(), _width, _height, _stride, kernel, border, threads);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool MutableImageView::resample(const ImageView &source, const Scaler scaler,
+                                    const int64_t threads) const noexcept(false)
+    {
+        const int64_t src_width = source.width();
+        const int64_t src_height = source.height();
+
+        if ((_width < 1) || (_height < 1) || (src_width < 1) || (src_height < 1))
+            return false;
+
+        switch (scaler)
+        {
+            case Scaler::FastBillinear:
+                Detail::bilinear(source.data(), src_width, src_height, source.stride(), data(),
+                                 _width, _height, _stride, threads);
+                break;
+
+            case Scaler::Nearest:
+                Detail::nearest(source.data(), src_width, src_height, source.stride(), data(),
+                                _width, _height, _stride);
+                break;
+
+            case Scaler::Bilinear:
+            case Scaler::Bicubic:
+            case Scaler::Lanczos3:
+            case Scaler::Area:
+                Detail::resample(source.data(), src_width, src_height, source.stride(), data(),
+                                 _width, _height, _stride, scaler, threads);
+                break;
+
+            case Scaler::Keep:
+                Detail::keep(source.data(), src_width, src_height, source.stride(), data(), _width,
+                             _height, _stride, RGBA(RGBA::Black));
+                break;
+
+            case Scaler::Clear:
+            default:
+                fill(RGBA::Black);
+                break;
+        }
+
+        return true;
+    }
+
+    bool MutableImageView::warp(const ImageView &source, const Affine &affine,
+                                const Scaler scaler, const RGBA background,
+                                const int64_t threads) const noexcept(false)
+    {
+        if ((_width < 1) || (_height < 1) || (source.width() < 1) || (source.height() < 1) ||
+            !affine.invertible())
+            return false;
+
+        switch (scaler)
+        {
+            case Scaler::Nearest:
+            case Scaler::FastBillinear:
+            case Scaler::Bilinear:
+                Detail::warp(source.data(), source.width(), source.height(), source.stride(),
+                             data(), _width, _height, _stride, affine.inverse(),
+                             scaler != Scaler::Nearest, background, threads);
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    bool MutableImageView::reduceColors(const int64_t colors, const Quantizer quantizer) const
+        noexcept(false)
+    {
+        Pixels palette;
+
+        switch (quantizer)
+        {
+            case Quantizer::MiddleCut:
+                return Color::Quantize::middleCut<RGBA>(_width, _height, colors, data(), _stride,
+                                                        data(), _stride, palette);
+        }
+
+        return false;
+    }
+
+    bool MutableImageView::setPixel(const int64_t x, const int64_t y, const RGBA color) const
+        noexcept
+    {
+        if (!implContains(x, y))
+            return false;
+
+        row(y)[x] = color;
+
+        return true;
+    }
+
+    bool MutableImageView::setLine(const int64_t x1, const int64_t y1, const int64_t x2,
+                                   const int64_t y2, const RGBA color) const noexcept
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsLine(clip, x1, y1, x2, y2))
+            return false;
+
+        Detail::drawLine(x1, y1, x2, y2, [&](const int64_t x, const int64_t y)
+        {
+            row(y)[x] = color;
+        },
+        clip);
+
+        return true;
+    }
+
+    bool MutableImageView::setTriangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                                       const int64_t y2, const int64_t x3, const int64_t y3,
+                                       const RGBA color, const bool fill) const noexcept
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsTriangle(clip, x1, y1, x2, y2, x3, y3))
+            return false;
+
+        Detail::drawTriangle(x1, y1, x2, y2, x3, y3, fill, [&](const int64_t x, const int64_t y)
+        {
+            row(y)[x] = color;
+        },
+        [&](const int64_t first, const int64_t last, const int64_t y)
+        {
+            std::fill(row(y) + first, row(y) + last + 1, color);
+        },
+        clip);
+
+        return true;
+    }
+
+    bool MutableImageView::setRectangle(const int64_t x1, const int64_t y1, const int64_t x2,
+                                        const int64_t y2, const RGBA color, const bool fill) const
+        noexcept
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsRectangle(clip, x1, y1, x2, y2))
+            return false;
+
+        Detail::drawRectangle(x1, y1, x2, y2, fill, [&](const int64_t x, const int64_t y)
+        {
+            row(y)[x] = color;
+        },
+        [&](const int64_t first, const int64_t last, const int64_t y)
+        {
+            std::fill(row(y) + first, row(y) + last + 1, color);
+        },
+        clip);
+
+        return true;
+    }
+
+    bool MutableImageView::setCircle(const int64_t x, const int64_t y, const int64_t radius,
+                                     const RGBA color, const bool fill) const noexcept
+    {
+        return setEllipse(x, y, radius, radius, color, fill);
+    }
+
+    bool MutableImageView::setEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                                      const int64_t radius_y, const RGBA color, const bool fill)
+        const noexcept
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsEllipse(clip, x, y, radius_x, radius_y))
+            return false;
+
+        const int64_t rx = std::abs(radius_x);
+        const int64_t ry = std::abs(radius_y);
+
+        Detail::drawEllipse(x, y, rx, ry, fill,
+                            [&](const int64_t first, const int64_t last, const int64_t yy)
+        {
+            std::fill(row(yy) + first, row(yy) + last + 1, color);
+        },
+        clip);
+
+        return true;
+    }
+
+    bool MutableImageView::setSmoothLine(const double x1, const double y1, const double x2,
+                                         const double y2, const RGBA color) const noexcept
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsSmoothLine(clip, x1, y1, x2, y2))
+            return false;
+
+        Detail::drawSmoothLine(x1, y1, x2, y2, [&](const int64_t x, const int64_t y,
+                                                   const uint32_t coverage)
+        {
+            implBlendSpan(x, x, y, color, coverage);
+        },
+        clip);
+
+        return true;
+    }
+
+    bool MutableImageView::setSmoothPolygon(const std::vector<Affine::V2d> &points,
+                                            const RGBA color) const noexcept(false)
+    {
+        const Detail::Clip clip = {0, 0, _width, _height};
+
+        if (!Detail::acceptsSmoothPolygon(clip, points))
+            return false;
+
+        Detail::fillSmoothPolygon(points, [&](const int64_t first, const int64_t last,
+                                              const int64_t y, const uint32_t coverage)
+        {
+            implBlendSpan(first, last, y, color, coverage);
+        },
+        clip);
+
+        return true;
+    }
+
+    void MutableImageView::implBlendSpan(const int64_t x1, const int64_t x2, const int64_t y,
+                                         const RGBA color, const uint32_t coverage) const noexcept
+    {
+        const uint32_t alpha = (coverage * color.a + Detail::Opaque / 2) / Detail::Opaque;
+        RGBA *pixels = row(y);
+
+        if (alpha == Detail::Opaque)
+            std::fill(pixels + x1, pixels + x2 + 1, color);
+        else
+            for (int64_t x = x1; x <= x2; ++x)
+                pixels[x] = Detail::blend(pixels[x], color, alpha);
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "Color/RGBA16161616.hxx"
+#include "Affine.hxx"
+#include "Kernel.hxx"
+
+namespace Image
+{
+    //--- base types and constants ---
+    // defined in Base.hxx
+    enum class Filter : int16_t;
+    enum class Border : int16_t;
+    enum class Scaler : int16_t;
+    enum class Quantizer : int16_t;
+
+    //
+    // ImageView - a rectangle of pixels owned by someone else, its rows are stride pixels apart,
+    //             so any part of a linear image can be looked at without copying it
+    //
+    // - a view is only valid as long as the pixels it points to, any resize or layout change of the
+    //   image it was taken from invalidates it
+    // - views compare by their pixels, not by where these are
+    //
+    class ImageView {
+    public:
+        //--- public types and constants ---
+        using RGBA = Color::RGBA16161616;
+        using Pixels = std::pmr::vector<RGBA>;
+
+        //--- public constructors ---
+        ImageView() noexcept;
+        ImageView(const RGBA *pixels, const int64_t width, const int64_t height,
+                  const int64_t stride) noexcept(false);
+        ImageView(const ImageView &rhs) noexcept;
+        ImageView(ImageView &&rhs) noexcept;
+        ~ImageView() noexcept;
+
+        //--- public operators ---
+        ImageView &operator=(const ImageView &rhs) noexcept;
+        ImageView &operator=(ImageView &&rhs) noexcept;
+        bool operator==(const ImageView &rhs) const noexcept;
+        bool operator!=(const ImageView &rhs) const noexcept;
+
+        //--- public methods ---
+        int64_t width() const noexcept;
+        int64_t height() const noexcept;
+        int64_t stride() const noexcept;
+        bool contiguous() const noexcept;
+        const RGBA *data() const noexcept;
+        const RGBA *row(const int64_t y) const noexcept;
+        RGBA pixel(const int64_t x, const int64_t y) const noexcept(false);
+        Pixels pixels() const noexcept(false);
+        ImageView view(const int64_t x, const int64_t y, const int64_t width,
+                       const int64_t height) const noexcept(false);
+
+    protected:
+        //--- protected methods ---
+        bool implContains(const int64_t x, const int64_t y) const noexcept;
+        void implCheckRect(const int64_t x, const int64_t y, const int64_t width,
+                           const int64_t height) const noexcept(false);
+
+        //--- protected properties ---
+        const RGBA *_pixels;
+        int64_t _width;
+        int64_t _height;
+        int64_t _stride;
+    };
+
+    //
+    // MutableImageView - a view that may change the pixels it looks at, it offers the drawing,
+    //                    flips, filtering, resampling and quantization of Base for just that
+    //                    rectangle
+    //
+    // - the view is treated as an image of its own, so filters see its edges as the image border
+    //   (3x3 filters blacken them) and nothing outside of it is read or written
+    // - resample() scales a source view into this one, warp() maps one into it with an affine
+    //   transform from source to view positions, the source must not overlap this view
+    //
+    class MutableImageView : public ImageView {
+    public:
+        //--- public constructors ---
+        MutableImageView() noexcept;
+        MutableImageView(RGBA *pixels, const int64_t width, const int64_t height,
+                         const int64_t stride) noexcept(false);
+        MutableImageView(const MutableImageView &rhs) noexcept;
+        MutableImageView(MutableImageView &&rhs) noexcept;
+        ~MutableImageView() noexcept;
+
+        //--- public operators ---
+        MutableImageView &operator=(const MutableImageView &rhs) noexcept;
+        MutableImageView &operator=(MutableImageView &&rhs) noexcept;
+
+        //--- public methods ---
+        RGBA *data() const noexcept;
+        RGBA *row(const int64_t y) const noexcept;
+        MutableImageView view(const int64_t x, const int64_t y, const int64_t width,
+                              const int64_t height) const noexcept(false);
+        void fill(const RGBA color) const noexcept;
+        bool copy(const ImageView &source) const noexcept;
+        void flipVertical(const int64_t threads = 1) const noexcept(false);
+        void flipHorizontal(const int64_t threads = 1) const noexcept(false);
+        bool filter(const Filter filter, const int64_t radius = 1, const int64_t threads = 1) const
+            noexcept(false);
+        bool convolve(const Kernel &kernel, const Border border, const int64_t threads = 1) const
+            noexcept(false);
+        bool resample(const ImageView &source, const Scaler scaler, const int64_t threads = 1)
+            const noexcept(false);
+        bool warp(const ImageView &source, const Affine &affine, const Scaler scaler,
+                  const RGBA background, const int64_t threads = 1) const noexcept(false);
+        bool reduceColors(const int64_t colors, const Quantizer quantizer) const noexcept(false);
+        bool setPixel(const int64_t x, const int64_t y, const RGBA color) const noexcept;
+        bool setLine(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                     const RGBA color) const noexcept;
+        bool setTriangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                         const int64_t x3, const int64_t y3, const RGBA color, const bool fill)
+            const noexcept;
+        bool setRectangle(const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2,
+                          const RGBA color, const bool fill) const noexcept;
+        bool setCircle(const int64_t x, const int64_t y, const int64_t radius, const RGBA color,
+                       const bool fill) const noexcept;
+        bool setEllipse(const int64_t x, const int64_t y, const int64_t radius_x,
+                        const int64_t radius_y, const RGBA color, const bool fill) const noexcept;
+        bool setSmoothLine(const double x1, const double y1, const double x2, const double y2,
+                           const RGBA color) const noexcept;
+        bool setSmoothPolygon(const std::vector<Affine::V2d> &points, const RGBA color) const
+            noexcept(false);
+
+    protected:
+        //--- protected methods ---
+        void implBlendSpan(const int64_t x1, const int64_t x2, const int64_t y, const RGBA color,
+                           const uint32_t coverage) const noexcept;
+    };
+}
@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+#include "Color/MiddleCutQuantizer.hxx"
+#include "Common/ThreadPool.hxx"
+#include "Common/Tools.hxx"
+#include "Indexed.hxx"
+
+namespace Image
+{
+    //--- internal stuff ---
+
+    namespace T = Common::Tools;
+
+    //--- public constructors ---
+
+    template <typename Index>
+    Indexed<Index>::Indexed() noexcept
+    : _data(), _palette(), _width(0), _height(0), _resource(std::pmr::get_default_resource())
+    {
+    }
+
+    template <typename Index>
+    Indexed<Index>::Indexed(const std::string &filename) noexcept(false)
+    : Indexed()
+    {
+        load(filename);
+    }
+
+    template <typename Index>
+    Indexed<Index>::Indexed(const int64_t width, const int64_t height, const Palette &palette)
+        noexcept(false)
+    : Indexed(Indices(width * height, 0, std::pmr::get_default_resource()), width, height,
+              palette)
+    {
+    }
+
+    template <typename Index>
+    Indexed<Index>::Indexed(Indices &&indices, const int64_t width, const int64_t height,
+                            const Palette &palette) noexcept(false)
+    : _data(), _palette(palette), _width(width), _height(height),
+      _resource(indices.get_allocator().resource())
+    {
+        if ((width < 0) || (height < 0) ||
+          (static_cast<uint64_t>(width * height) != static_cast<uint64_t>(indices.size())))
+            throw std::invalid_argument("indices do not match the size of the image");
+
+        if (static_cast<int64_t>(palette.size()) > MaxColors)
+            throw std::invalid_argument("palette has more colors than the indices can hold");
+
+        if (std::any_of(indices.begin(), indices.end(), [&](const Index index)
+            {
+                return index >= palette.size();
+            }))
+            throw std::invalid_argument("index outside of the palette");
+
+        _data = std::make_shared<Indices>(std::move(indices));
+    }
+
+    template <typename Index>
+    Indexed<Index>::Indexed(const ImageView &view, const int64_t colors,
+                            const Quantizer quantizer) noexcept(false)
+    : Indexed()
+    {
+        if ((colors < 1) || (colors > MaxColors))
+            throw std::invalid_argument("amount of colors does not fit the indices");
+
+        Indices indices(view.width() * view.height(), 0, _resource);
+        Palette palette;
+
+        switch (quantizer)
+        {
+            case Quantizer::MiddleCut:
+                Color::Quantize::middleCutIndices(view.width(), view.height(), colors,
+                                                  view.data(), view.stride(), indices.data(),
+                                                  view.width(), palette);
+                break;
+        }
+
+        // an empty view has no colors at all
+        _data = std::make_shared<Indices>(std::move(indices));
+        _palette = std::move(palette);
+        _width = view.width();
+        _height = view.height();
+    }
+
+    template <typename Index>
+    Indexed<Index>::Indexed(const Indexed &rhs) noexcept(false)
+    : _data(rhs._data), _palette(rhs._palette), _width(rhs._width), _height(rhs._height),
+      _resource(rhs._resource)
+    {
+    }
+
+    template <typename Index>
+    Indexed<Index>::Indexed(Indexed &&rhs) noexcept
+    : _data(std::move(rhs._data)), _palette(std::move(rhs._palette)),
+      _width(std::move(rhs._width)), _height(std::move(rhs._height)),
+      _resource(std::move(rhs._resource))
+    {
+    }
+
+    template <typename Index>
+    Indexed<Index>::~Indexed() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    template <typename Index>
+    Indexed<Index> &Indexed<Index>::operator=(const Indexed &rhs) noexcept(false)
+    {
+        if (this != &rhs)
+        {
+            _data = rhs._data;
+            _palette = rhs._palette;
+            _width = rhs._width;
+            _height = rhs._height;
+            _resource = rhs._resource;
+        }
+
+        return *this;
+    }
+
+    template <typename Index>
+    Indexed<Index> &Indexed<Index>::operator=(Indexed &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _data = std::move(rhs._data);
+            _palette = std::move(rhs._palette);
+            _width = std::move(rhs._width);
+            _height = std::move(rhs._height);
+            _resource = std::move(rhs._resource);
+        }
+
+        return *this;
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::operator==(const Indexed &rhs) const noexcept
+    {
+        return (_width == rhs._width) && (_height == rhs._height) && (_palette == rhs._palette) &&
+               ((_data == rhs._data) || (indices() == rhs.indices()));
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::operator!=(const Indexed &rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    //--- public methods ---
+
+    template <typename Index>
+    int64_t Indexed<Index>::width() const noexcept
+    {
+        return _width;
+    }
+
+    template <typename Index>
+    int64_t Indexed<Index>::height() const noexcept
+    {
+        return _height;
+    }
+
+    template <typename Index>
+    std::pmr::memory_resource *Indexed<Index>::memoryResource() const noexcept
+    {
+        return _resource;
+    }
+
+    template <typename Index>
+    void Indexed<Index>::setMemoryResource(std::pmr::memory_resource *resource) noexcept(false)
+    {
+        _resource = resource ? resource : std::pmr::get_default_resource();
+
+        if (_data && (_data->get_allocator().resource() != _resource))
+            _data = std::make_shared<Indices>(*_data, _resource);
+    }
+
+    template <typename Index>
+    const typename Indexed<Index>::Palette &Indexed<Index>::palette() const noexcept
+    {
+        return _palette;
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::setPalette(const Palette &palette) noexcept(false)
+    {
+        if (static_cast<int64_t>(palette.size()) > MaxColors)
+            return false;
+
+        // a smaller palette has to keep a color for every index in use
+        if (palette.size() < _palette.size())
+        {
+            const Indices &data = indices();
+
+            if (std::any_of(data.begin(), data.end(), [&](const Index index)
+                {
+                    return index >= palette.size();
+                }))
+                return false;
+        }
+
+        _palette = palette;
+
+        return true;
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::setColor(const int64_t index, const RGBA color) noexcept
+    {
+        if (!T::inRange(index, 0, static_cast<int64_t>(_palette.size()), true, false))
+            return false;
+
+        _palette[index] = color;
+
+        return true;
+    }
+
+    template <typename Index>
+    const typename Indexed<Index>::Indices &Indexed<Index>::indices() const noexcept
+    {
+        static const Indices none;
+
+        return _data ? *_data : none;
+    }
+
+    template <typename Index>
+    Index Indexed<Index>::index(const int64_t x, const int64_t y) const noexcept(false)
+    {
+        if (!implContains(x, y))
+            throw std::out_of_range("pixel outside of the image");
+
+        return (*_data)[y * _width + x];
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::setIndex(const int64_t x, const int64_t y, const Index index)
+        noexcept(false)
+    {
+        if (!implContains(x, y) || (index >= _palette.size()))
+            return false;
+
+        implOwnData()[y * _width + x] = index;
+
+        return true;
+    }
+
+    template <typename Index>
+    typename Indexed<Index>::RGBA Indexed<Index>::pixel(const int64_t x, const int64_t y) const
+        noexcept(false)
+    {
+        return _palette[index(x, y)];
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::blit(const MutableImageView &target, const int64_t threads) const
+        noexcept(false)
+    {
+        if ((target.width() != _width) || (target.height() != _height))
+            return false;
+
+        const Index *in = indices().data();
+        const RGBA *colors = _palette.data();
+
+        Common::ThreadPool::global().runBands(_height, threads,
+            [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t y = begin; y < end; ++y)
+            {
+                const Index *row = in + y * _width;
+                RGBA *out = target.row(y);
+
+                for (int64_t x = 0; x < _width; ++x)
+                    out[x] = colors[row[x]];
+            }
+        });
+
+        return true;
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::blit(Base &target, const int64_t x, const int64_t y,
+                              const int64_t threads) const noexcept(false)
+    {
+        if ((x < 0) || (y < 0) || ((x + _width) > target.width()) ||
+          ((y + _height) > target.height()))
+            return false;
+
+        return blit(target.mutableView(x, y, _width, _height), threads);
+    }
+
+    template <typename Index>
+    Picture Indexed<Index>::promote(const int64_t threads) const noexcept(false)
+    {
+        Picture::Pixels pixels(_width * _height, _resource);
+
+        blit(MutableImageView(pixels.data(), _width, _height, _width), threads);
+
+        Picture picture(std::move(pixels), _width, _height);
+
+        // the pixels are already in the resource, so this only sets it for later buffers
+        picture.setMemoryResource(_resource);
+
+        return picture;
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::save(const std::string &filename, const CodecOptions &options) const
+        noexcept(false)
+    {
+        // codecs keeping indices only know 8 bit ones
+        if constexpr (std::is_same_v<Index, uint8_t>)
+        {
+            if (const auto codec = Codecs::byExtension(filename); codec && codec->encodeIndexed)
+                return codec->encodeIndexed(*this, filename, options);
+        }
+
+        Picture picture = promote();
+
+        picture.setOptions(options);
+
+        return picture.save(filename);
+    }
+
+    template <typename Index>
+    bool Indexed<Index>::load(const std::string &filename) noexcept(false)
+    {
+        if (const auto codec = Codecs::byContent(filename))
+        {
+            if constexpr (std::is_same_v<Index, uint8_t>)
+            {
+                if (codec->decodeIndexed)
+                {
+                    Indexed image;
+
+                    image.setMemoryResource(_resource);
+                    if (codec->decodeIndexed(filename, image))
+                    {
+                        *this = std::move(image);
+
+                        return true;
+                    }
+                }
+            }
+
+            // everything else is quantized to the colors the indices can hold
+            if (const auto image = codec->decode(filename, _resource))
+            {
+                std::pmr::memory_resource *resource = _resource;
+
+                *this = Indexed(image->view(), MaxColors);
+                setMemoryResource(resource);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //--- protected methods ---
+
+    template <typename Index>
+    bool Indexed<Index>::implContains(const int64_t x, const int64_t y) const noexcept
+    {
+        return T::inRange(x, 0, _width, true, false) && T::inRange(y, 0, _height, true, false);
+    }
+
+    template <typename Index>
+    typename Indexed<Index>::Indices &Indexed<Index>::implOwnData() noexcept(false)
+    {
+        // the same copy on write as Base
+        if (!_data)
+            _data = std::make_shared<Indices>(_resource);
+        else if (_data.use_count() > 1)
+            _data = std::make_shared<Indices>(*_data, _resource);
+        else
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+        return *_data;
+    }
+
+    //--- explicit instantiations ---
+
+    template class Indexed<uint8_t>;
+    template class Indexed<uint16_t>;
+}
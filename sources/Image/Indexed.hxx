@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "Color/RGBA16161616.hxx"
+#include "Base.hxx"
+#include "Codec.hxx"
+#include "Picture.hxx"
+
+namespace Image
+{
+    //
+    // Indexed - an image of palette indices, every pixel is the position of its color in the
+    //           palette, so a 256 color image takes one byte per pixel instead of the eight of Base
+    //
+    // - the quantizers fill it directly and the mapped Targa types are written from and read into
+    //   it as they are, without a detour over expanded pixels
+    // - every index is smaller than the size of the palette, the setters refuse anything else
+    // - blit() expands the indices through the palette into any view of the same size, promote()
+    //   does the same into a new Picture, saving goes through it for codecs without index support
+    // - the indices are shared between copies and come from the memory resource of the image just
+    //   like the pixels of Base, the palette is small enough to be always copied
+    //
+    template <typename Index>
+    class Indexed {
+    public:
+        //--- public types and constants ---
+        using RGBA = Color::RGBA16161616;
+        using Palette = std::vector<RGBA>;
+        using Indices = std::pmr::vector<Index>;
+
+        static constexpr int64_t MaxColors = static_cast<int64_t>(std::numeric_limits<Index>::max())
+                                             + 1;
+
+        //--- public constructors ---
+        Indexed() noexcept;
+        Indexed(const std::string &filename) noexcept(false);
+        Indexed(const int64_t width, const int64_t height, const Palette &palette) noexcept(false);
+        Indexed(Indices &&indices, const int64_t width, const int64_t height,
+                const Palette &palette) noexcept(false);
+        Indexed(const ImageView &view, const int64_t colors,
+                const Quantizer quantizer = Quantizer::MiddleCut) noexcept(false);
+        Indexed(const Indexed &rhs) noexcept(false);
+        Indexed(Indexed &&rhs) noexcept;
+        ~Indexed() noexcept;
+
+        //--- public operators ---
+        Indexed &operator=(const Indexed &rhs) noexcept(false);
+        Indexed &operator=(Indexed &&rhs) noexcept;
+        bool operator==(const Indexed &rhs) const noexcept;
+        bool operator!=(const Indexed &rhs) const noexcept;
+
+        //--- public methods ---
+        int64_t width() const noexcept;
+        int64_t height() const noexcept;
+        std::pmr::memory_resource *memoryResource() const noexcept;
+        void setMemoryResource(std::pmr::memory_resource *resource) noexcept(false);
+        const Palette &palette() const noexcept;
+        bool setPalette(const Palette &palette) noexcept(false);
+        bool setColor(const int64_t index, const RGBA color) noexcept;
+        const Indices &indices() const noexcept;
+        Index index(const int64_t x, const int64_t y) const noexcept(false);
+        bool setIndex(const int64_t x, const int64_t y, const Index index) noexcept(false);
+        RGBA pixel(const int64_t x, const int64_t y) const noexcept(false);
+        bool blit(const MutableImageView &target, const int64_t threads = 1) const noexcept(false);
+        bool blit(Base &target, const int64_t x = 0, const int64_t y = 0,
+                  const int64_t threads = 1) const noexcept(false);
+        Picture promote(const int64_t threads = 1) const noexcept(false);
+        bool save(const std::string &filename, const CodecOptions &options = {}) const
+            noexcept(false);
+        bool load(const std::string &filename) noexcept(false);
+
+    protected:
+        //--- protected methods ---
+        bool implContains(const int64_t x, const int64_t y) const noexcept;
+        Indices &implOwnData() noexcept(false);
+
+    private:
+        //--- private properties ---
+        std::shared_ptr<Indices> _data;
+        Palette _palette;
+        int64_t _width;
+        int64_t _height;
+        std::pmr::memory_resource *_resource;
+    };
+
+    using Indexed8 = Indexed<uint8_t>;
+    using Indexed16 = Indexed<uint16_t>;
+
+    extern template class Indexed<uint8_t>;
+    extern template class Indexed<uint16_t>;
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include "Kernel.hxx"
+
+namespace Image
+{
+    //--- internal stuff ---
+
+    static const float Epsilon = 1e-6;
+
+    static int64_t sideLength(const size_t count) noexcept(false)
+    {
+        const int64_t size = std::llround(std::sqrt(count));
+
+        if ((size * size != static_cast<int64_t>(count)) || !(size & 1))
+            throw std::invalid_argument("kernel needs an odd square amount of weights");
+
+        return size;
+    }
+
+    static float normalizer(const float divisor, const float sum) noexcept
+    {
+        if (divisor != 0)
+            return divisor;
+
+        return std::abs(sum) < Epsilon ? 1 : sum;
+    }
+
+    //--- public constructors ---
+
+    Kernel::Kernel() noexcept(false)
+    : _weights{1}, _column{1}, _row{1}, _size(1)
+    {
+    }
+
+    Kernel::Kernel(const std::vector<float> &weights, const float divisor) noexcept(false)
+    : _weights(weights), _column(), _row(), _size(sideLength(weights.size()))
+    {
+        float sum = 0;
+
+        for (auto weight : _weights)
+            sum += weight;
+
+        const float norm = normalizer(divisor, sum);
+
+        for (auto &weight : _weights)
+            weight /= norm;
+
+        detectSeparable();
+    }
+
+    Kernel::Kernel(const std::vector<float> &column, const std::vector<float> &row,
+                   const float divisor) noexcept(false)
+    : _weights(), _column(column), _row(row), _size(column.size())
+    {
+        if ((column.size() != row.size()) || !(_size & 1))
+            throw std::invalid_argument("kernel vectors need the same odd size");
+
+        float sum_column = 0;
+        float sum_row = 0;
+
+        for (int64_t i = 0; i < _size; ++i)
+        {
+            sum_column += _column[i];
+            sum_row += _row[i];
+        }
+
+        // fold the whole normalization into the column vector
+        const float norm = normalizer(divisor, sum_column * sum_row);
+
+        for (auto &weight : _column)
+            weight /= norm;
+
+        _weights.reserve(_size * _size);
+        for (int64_t y = 0; y < _size; ++y)
+            for (int64_t x = 0; x < _size; ++x)
+                _weights.push_back(_column[y] * _row[x]);
+    }
+
+    Kernel::Kernel(const Kernel &rhs) noexcept(false)
+    : _weights(rhs._weights), _column(rhs._column), _row(rhs._row), _size(rhs._size)
+    {
+    }
+
+    Kernel::Kernel(Kernel &&rhs) noexcept
+    : _weights(std::move(rhs._weights)), _column(std::move(rhs._column)),
+      _row(std::move(rhs._row)), _size(std::move(rhs._size))
+    {
+    }
+
+    Kernel::~Kernel() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    Kernel &Kernel::operator=(const Kernel &rhs) noexcept(false)
+    {
+        if (this != &rhs)
+        {
+            _weights = rhs._weights;
+            _column = rhs._column;
+            _row = rhs._row;
+            _size = rhs._size;
+        }
+
+        return *this;
+    }
+
+    Kernel &Kernel::operator=(Kernel &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _weights = std::move(rhs._weights);
+            _column = std::move(rhs._column);
+            _row = std::move(rhs._row);
+            _size = std::move(rhs._size);
+        }
+
+        return *this;
+    }
+
+    bool Kernel::operator==(const Kernel &rhs) const noexcept
+    {
+        return _weights == rhs._weights &&
+               _size == rhs._size;
+    }
+
+    bool Kernel::operator!=(const Kernel &rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    //--- public methods ---
+
+    int64_t Kernel::size() const noexcept
+    {
+        return _size;
+    }
+
+    int64_t Kernel::radius() const noexcept
+    {
+        return _size >> 1;
+    }
+
+    float Kernel::weight(const int64_t x, const int64_t y) const noexcept
+    {
+        return _weights[y * _size + x];
+    }
+
+    const std::vector<float> &Kernel::weights() const noexcept
+    {
+        return _weights;
+    }
+
+    bool Kernel::separable() const noexcept
+    {
+        return !_column.empty();
+    }
+
+    const std::vector<float> &Kernel::column() const noexcept
+    {
+        return _column;
+    }
+
+    const std::vector<float> &Kernel::row() const noexcept
+    {
+        return _row;
+    }
+
+    //--- static public methods ---
+
+    Kernel Kernel::box(const int64_t radius) noexcept(false)
+    {
+        const std::vector<float> line(std::max<int64_t>(radius, 0) * 2 + 1, 1);
+
+        return Kernel(line, line);
+    }
+
+    Kernel Kernel::gaussian(const int64_t radius, const double sigma) noexcept(false)
+    {
+        const int64_t rad = std::max<int64_t>(radius, 0);
+        // a radius of 3 sigma covers more than 99% of the curve
+        const double sig = sigma > 0 ? sigma : std::max(rad / 3.0, 0.5);
+        std::vector<float> line(rad * 2 + 1);
+
+        for (int64_t i = -rad; i <= rad; ++i)
+            line[i + rad] = std::exp(-(i * i) / (2 * sig * sig));
+
+        return Kernel(line, line);
+    }
+
+    //--- protected methods ---
+
+    void Kernel::detectSeparable() noexcept(false)
+    {
+        // a kernel is separable if it has rank 1, every row is then a multiple of the row holding
+        // the largest weight
+        const auto pivot = std::max_element(_weights.begin(), _weights.end(),
+                           [](const float w1, const float w2){ return std::abs(w1) < std::abs(w2); });
+        const int64_t pivot_pos = std::distance(_weights.begin(), pivot);
+        const int64_t pivot_x = pivot_pos % _size;
+        const int64_t pivot_y = pivot_pos / _size;
+        const float max = std::abs(*pivot);
+        std::vector<float> column(_size);
+        std::vector<float> row(_size);
+
+        _column.clear();
+        _row.clear();
+        if (max < Epsilon)
+            return;
+
+        for (int64_t i = 0; i < _size; ++i)
+        {
+            column[i] = weight(pivot_x, i);
+            row[i] = weight(i, pivot_y) / *pivot;
+        }
+
+        for (int64_t y = 0; y < _size; ++y)
+            for (int64_t x = 0; x < _size; ++x)
+                if (std::abs(weight(x, y) - column[y] * row[x]) > (Epsilon * max))
+                    return;
+
+        _column = std::move(column);
+        _row = std::move(row);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Image
+{
+    //
+    // Kernel - a square convolution kernel with an odd size
+    //
+    // - weights are stored normalized (divided by the divisor, which defaults to the sum of all
+    //   weights, or 1 if that sum is 0)
+    // - rank 1 kernels are detected on construction and split into a column and a row vector, so
+    //   they can be applied as two 1D passes
+    //
+    class Kernel {
+    public:
+        //--- public constructors ---
+        Kernel() noexcept(false);
+        Kernel(const std::vector<float> &weights, const float divisor = 0) noexcept(false);
+        Kernel(const std::vector<float> &column, const std::vector<float> &row,
+               const float divisor = 0) noexcept(false);
+        Kernel(const Kernel &rhs) noexcept(false);
+        Kernel(Kernel &&rhs) noexcept;
+        ~Kernel() noexcept;
+
+        //--- public operators ---
+        Kernel &operator=(const Kernel &rhs) noexcept(false);
+        Kernel &operator=(Kernel &&rhs) noexcept;
+        bool operator==(const Kernel &rhs) const noexcept;
+        bool operator!=(const Kernel &rhs) const noexcept;
+
+        //--- public methods ---
+        int64_t size() const noexcept;
+        int64_t radius() const noexcept;
+        float weight(const int64_t x, const int64_t y) const noexcept;
+        const std::vector<float> &weights() const noexcept;
+        bool separable() const noexcept;
+        const std::vector<float> &column() const noexcept;
+        const std::vector<float> &row() const noexcept;
+
+        //--- static public methods ---
+        static Kernel box(const int64_t radius) noexcept(false);
+        static Kernel gaussian(const int64_t radius, const double sigma = 0) noexcept(false);
+
+    protected:
+        //--- protected methods ---
+        void detectSeparable() noexcept(false);
+
+    private:
+        //--- private properties ---
+        std::vector<float> _weights;
+        std::vector<float> _column;
+        std::vector<float> _row;
+        int64_t _size;
+    };
+}
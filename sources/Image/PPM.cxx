@@ -1,12 +1,15 @@
 #include <fstream>
 #include <utility>
 #include "Common/Tools.hxx"
+#include "Compact.hxx"
+#include "PixelDetail.hxx"
 #include "PPM.hxx"
 
 namespace Image
 {
     //--- internal stuff ---
 
+    namespace D = Detail;
     namespace T = Common::Tools;
 
     //--- public constructors ---
@@ -38,6 +41,15 @@ namespace Image
             implReplace(pixels, width, height);
     }
 
+    PPM::PPM(const Base &image) noexcept(false)
+    : Base(), _comment(""), _wide(false), _binary(false)
+    {
+        // the pixels are shared until one of both images changes them
+        if (T::inRange(image.width(), MinWidth, MaxWidth) &&
+          T::inRange(image.height(), MinHeight, MaxHeight))
+            implShare(image);
+    }
+
     PPM::PPM(const PPM &rhs) noexcept(false)
     : Base(rhs), _comment(rhs._comment), _wide(rhs._wide), _binary(rhs._binary)
     {
@@ -131,7 +143,8 @@ namespace Image
         // having no pixels, aka a width/height of 0 is considert invalid, but the PPM image format
         // supports it
         return (width() * height() > 0) &&
-               (static_cast<uint64_t>(pixels().size())) == static_cast<uint64_t>(width() * height());
+               (static_cast<uint64_t>(implData().size()) ==
+                static_cast<uint64_t>(width() * height()));
     }
 
     bool PPM::resize(const int64_t width, const int64_t height, const Scaler scaler) noexcept(false)
@@ -149,6 +162,8 @@ namespace Image
 
         if (std::ofstream ofile(filename); ofile.is_open() && ofile.good())
         {
+            const auto rows = implRows();
+
             if (_binary)
                 ofile << "P6\n";
             else
@@ -173,24 +188,24 @@ namespace Image
 
             if (!_wide && !_binary)
             {
-                for (auto &pixel : pixels())
+                for (auto &pixel : *rows)
                     ofile << static_cast<uint16_t>(pixel.rh) << ' '
                           << static_cast<uint16_t>(pixel.gh) << ' '
                           << static_cast<uint16_t>(pixel.bh) << '\n';
             }
             else if (!_wide && _binary)
             {
-                for (auto &pixel : pixels())
+                for (auto &pixel : *rows)
                     ofile.put(pixel.c1).put(pixel.c3).put(pixel.c5);
             }
             else if (_wide && !_binary)
             {
-                for (auto &pixel : pixels())
+                for (auto &pixel : *rows)
                     ofile << pixel.r << ' ' << pixel.g << ' ' << pixel.b << '\n';
             }
             else if (_wide && _binary)
             {
-                for (auto &pixel : pixels())
+                for (auto &pixel : *rows)
                     ofile.put(pixel.c1).put(pixel.c2).put(pixel.c3).put(pixel.c4).put(pixel.c5)
                          .put(pixel.c6);
             }
@@ -203,29 +218,53 @@ namespace Image
     }
 
     bool PPM::load(const std::string &filename) noexcept(false)
+    {
+        Pixels pixels(memoryResource());
+        int64_t width = 0;
+        int64_t height = 0;
+
+        if (!implLoad(filename, pixels, width, height))
+            return false;
+
+        implReplace(std::move(pixels), width, height);
+
+        return true;
+    }
+
+    bool PPM::loadCompact(const std::string &filename, Compact &image) noexcept(false)
+    {
+        Compact::Pixels pixels(image.memoryResource());
+        int64_t width = 0;
+        int64_t height = 0;
+
+        if (!implLoad(filename, pixels, width, height))
+            return false;
+
+        image = Compact(std::move(pixels), width, height);
+
+        return true;
+    }
+
+    //--- static public methods ---
+
+    bool PPM::identify(const std::string &filename) noexcept(false)
     {
         if (std::ifstream ifile(filename); ifile.is_open() && ifile.good())
         {
             std::string comment;
             std::string line;
-            Pixels pixels;
             int64_t width = 0;
             int64_t height = 0;
             int64_t colors = 0;
-            int64_t binary = false;
 
             std::getline(ifile, line);
-            if (!line.compare("P6"))
-                binary = true;
-            else if (!line.compare("P3"))
-                binary = false;
-            else
+
+            if ((line.substr(0, 2) != "P3") && (line.substr(0, 2) != "P6"))
             {
                 ifile.close();
                 return false;
             }
 
-            // comments can be all over the header, which can be really anoying
             while ((ifile.peek() == '#') && std::getline(ifile, line))
                 comment += T::trim(line.substr(1, std::string::npos)) + '\n';
             ifile >> width;
@@ -236,7 +275,6 @@ namespace Image
                 comment += T::trim(line.substr(1, std::string::npos)) + '\n';
             ifile >> colors;
 
-            // there is ONE newline at the end of the header .. then pixel data starts
             if (ifile.peek() == '\n')
                 ifile.get();
 
@@ -248,70 +286,39 @@ namespace Image
                 return false;
             }
 
-            pixels.resize(width * height, RGBA::Black);
-            if (!binary)
-            {
-                uint32_t tmp = 0;
-
-                for (auto &pixel : pixels)
-                {
-                    ifile >> tmp;
-                    pixel.r = tmp * MaxWidth / colors;
-                    ifile >> tmp;
-                    pixel.g = tmp * MaxWidth / colors;
-                    ifile >> tmp;
-                    pixel.b = tmp * MaxWidth / colors;
-                }
-            }
-            else if (binary && (colors < 256))
-            {
-                for (auto &pixel : pixels)
-                {
-                    ifile.get(pixel.c2).get(pixel.c4).get(pixel.c6);
-                    pixel.r = pixel.r * MaxWidth / colors;
-                    pixel.g = pixel.g * MaxWidth / colors;
-                    pixel.b = pixel.b * MaxWidth / colors;
-                }
-            }
-            else if (binary && (colors > 255))
-            {
-                for (auto &pixel : pixels)
-                    ifile.get(pixel.c1).get(pixel.c2).get(pixel.c3).get(pixel.c4).get(pixel.c5)
-                         .get(pixel.c6);
-            }
             ifile.close();
 
-            implReplace(pixels, width, height);
-            _comment = comment;
-            _wide = (colors > 255) ? true : false;
-            _binary = binary;
-
             return true;
         }
 
         return false;
     }
 
-    //--- static public methods ---
+    //--- protected methods ---
 
-    bool PPM::identify(const std::string &filename) noexcept(false)
+    template <typename Pixel>
+    bool PPM::implLoad(const std::string &filename, std::pmr::vector<Pixel> &pixels, int64_t &width,
+                       int64_t &height) noexcept(false)
     {
         if (std::ifstream ifile(filename); ifile.is_open() && ifile.good())
         {
             std::string comment;
             std::string line;
-            int64_t width = 0;
-            int64_t height = 0;
             int64_t colors = 0;
+            int64_t binary = false;
 
             std::getline(ifile, line);
-
-            if ((line.substr(0, 2) != "P3") && (line.substr(0, 2) != "P6"))
+            if (!line.compare("P6"))
+                binary = true;
+            else if (!line.compare("P3"))
+                binary = false;
+            else
             {
                 ifile.close();
                 return false;
             }
 
+            // comments can be all over the header, which can be really anoying
             while ((ifile.peek() == '#') && std::getline(ifile, line))
                 comment += T::trim(line.substr(1, std::string::npos)) + '\n';
             ifile >> width;
@@ -322,6 +329,7 @@ namespace Image
                 comment += T::trim(line.substr(1, std::string::npos)) + '\n';
             ifile >> colors;
 
+            // there is ONE newline at the end of the header .. then pixel data starts
             if (ifile.peek() == '\n')
                 ifile.get();
 
@@ -333,8 +341,53 @@ namespace Image
                 return false;
             }
 
+            pixels.resize(width * height, Pixel(Pixel::Black));
+            if (!binary)
+            {
+                uint32_t tmp = 0;
+
+                for (auto &pixel : pixels)
+                {
+                    ifile >> tmp;
+                    pixel.r = D::channel<Pixel>(tmp * MaxWidth / colors);
+                    ifile >> tmp;
+                    pixel.g = D::channel<Pixel>(tmp * MaxWidth / colors);
+                    ifile >> tmp;
+                    pixel.b = D::channel<Pixel>(tmp * MaxWidth / colors);
+                }
+            }
+            else if (binary && (colors < 256))
+            {
+                for (auto &pixel : pixels)
+                {
+                    pixel.r = D::channel<Pixel>(ifile.get() * MaxWidth / colors);
+                    pixel.g = D::channel<Pixel>(ifile.get() * MaxWidth / colors);
+                    pixel.b = D::channel<Pixel>(ifile.get() * MaxWidth / colors);
+                }
+            }
+            else if (binary && (colors > 255))
+            {
+                // big endian words, not scaled to the full range
+                const auto word = [&ifile]()
+                {
+                    const uint32_t high = ifile.get() << 8;
+
+                    return high | ifile.get();
+                };
+
+                for (auto &pixel : pixels)
+                {
+                    pixel.r = D::channel<Pixel>(word());
+                    pixel.g = D::channel<Pixel>(word());
+                    pixel.b = D::channel<Pixel>(word());
+                }
+            }
             ifile.close();
 
+            _comment = comment;
+            _wide = (colors > 255) ? true : false;
+            _binary = binary;
+
             return true;
         }
 
@@ -6,6 +6,16 @@
 
 namespace Image
 {
+    //--- base types and constants ---
+    // defined in Compact.hxx
+    class Compact;
+
+    //
+    // PPM - the portable pixmap of netpbm, in its ascii (P3) and binary (P6) flavour
+    //
+    // - loadCompact() keeps files with up to 8 bit per channel at 8 bit, wide files lose their low
+    //   byte there
+    //
     class PPM : public Base {
     public:
         //--- public types and constants ---
@@ -20,6 +30,7 @@ namespace Image
         PPM(const int64_t width, const int64_t height, const RGBA color = RGBA::Black)
             noexcept(false);
         PPM(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        explicit PPM(const Base &image) noexcept(false);
         PPM(const PPM &rhs) noexcept(false);
         PPM(PPM &&rhs) noexcept;
         virtual ~PPM() noexcept;
@@ -43,10 +54,17 @@ namespace Image
             noexcept(false) override final;
         virtual bool save(const std::string &filename) const noexcept(false) override final;
         virtual bool load(const std::string &filename) noexcept(false) override final;
+        bool loadCompact(const std::string &filename, Compact &image) noexcept(false);
 
         //--- static public methods ---
         static bool identify(const std::string &filename) noexcept(false);
 
+    protected:
+        //--- protected methods ---
+        template <typename Pixel>
+        bool implLoad(const std::string &filename, std::pmr::vector<Pixel> &pixels,
+                      int64_t &width, int64_t &height) noexcept(false);
+
     private:
         //--- private properties ---
         std::string _comment;
@@ -0,0 +1,142 @@
+#include <utility>
+#include "Picture.hxx"
+
+namespace Image
+{
+    //--- public constructors ---
+
+    Picture::Picture() noexcept
+    : Base(), _options()
+    {
+    }
+
+    Picture::Picture(const std::string &filename) noexcept(false)
+    : Base(), _options()
+    {
+        load(filename);
+    }
+
+    Picture::Picture(const int64_t width, const int64_t height, const RGBA color) noexcept(false)
+    : Base(width, height, color), _options()
+    {
+    }
+
+    Picture::Picture(const Pixels &pixels, const int64_t width, const int64_t height)
+        noexcept(false)
+    : Base(), _options()
+    {
+        if (static_cast<uint64_t>(width * height) == static_cast<uint64_t>(pixels.size()))
+            implReplace(pixels, width, height);
+    }
+
+    Picture::Picture(Pixels &&pixels, const int64_t width, const int64_t height) noexcept(false)
+    : Base(), _options()
+    {
+        // the pixels are taken as they are, with the memory resource they came from
+        if (static_cast<uint64_t>(width * height) == static_cast<uint64_t>(pixels.size()))
+            implReplace(std::move(pixels), width, height);
+    }
+
+    Picture::Picture(const Base &image) noexcept
+    : Base(), _options()
+    {
+        implShare(image);
+    }
+
+    Picture::Picture(const Picture &rhs) noexcept(false)
+    : Base(rhs), _options(rhs._options)
+    {
+    }
+
+    Picture::Picture(Picture &&rhs) noexcept
+    : Base(std::move(rhs)), _options(std::move(rhs._options))
+    {
+    }
+
+    Picture::~Picture() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    Picture &Picture::operator=(const Picture &rhs) noexcept(false)
+    {
+        if (this != &rhs)
+        {
+            Base::operator=(rhs);
+            _options = rhs._options;
+        }
+
+        return *this;
+    }
+
+    Picture &Picture::operator=(Picture &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Base::operator=(std::move(rhs));
+            _options = std::move(rhs._options);
+        }
+
+        return *this;
+    }
+
+    bool Picture::operator==(const Picture &rhs) const noexcept
+    {
+        return Base::operator==(rhs);
+    }
+
+    bool Picture::operator!=(const Picture &rhs) const noexcept
+    {
+        return Base::operator!=(rhs);
+    }
+
+    //--- public methods ---
+
+    const CodecOptions &Picture::options() const noexcept
+    {
+        return _options;
+    }
+
+    void Picture::setOptions(const CodecOptions &options) noexcept(false)
+    {
+        _options = options;
+    }
+
+    bool Picture::valid() const noexcept(false)
+    {
+        // the tiled layout keeps the same amount of pixels, so this holds for both
+        return (width() >= 0) && (height() >= 0) &&
+               (static_cast<uint64_t>(implData().size()) ==
+                static_cast<uint64_t>(width() * height()));
+    }
+
+    bool Picture::resize(const int64_t width, const int64_t height, const Scaler scaler)
+        noexcept(false)
+    {
+        return implResize(width, height, scaler);
+    }
+
+    bool Picture::save(const std::string &filename) const noexcept(false)
+    {
+        if (const auto codec = Codecs::byExtension(filename); codec && valid())
+            return codec->encode(*this, filename, _options);
+
+        return false;
+    }
+
+    bool Picture::load(const std::string &filename) noexcept(false)
+    {
+        if (const auto codec = Codecs::byContent(filename))
+        {
+            if (const auto image = codec->decode(filename, memoryResource()))
+            {
+                implShare(*image);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include "Base.hxx"
+#include "Codec.hxx"
+
+namespace Image
+{
+    //
+    // Picture - an image that is not tied to a file format, it loads whatever one of the registered
+    //           codecs recognizes and saves in the format the extension of the file name asks for
+    //
+    // - loading keeps the pixels of the decoder and saving hands them to the encoder as they are,
+    //   so converting a file never copies the image
+    // - the options are passed to every encoder, see Codec for the known keys
+    //
+    class Picture : public Base {
+    public:
+        //--- public constructors ---
+        Picture() noexcept;
+        Picture(const std::string &filename) noexcept(false);
+        Picture(const int64_t width, const int64_t height, const RGBA color = RGBA::Black)
+            noexcept(false);
+        Picture(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        Picture(Pixels &&pixels, const int64_t width, const int64_t height) noexcept(false);
+        explicit Picture(const Base &image) noexcept;
+        Picture(const Picture &rhs) noexcept(false);
+        Picture(Picture &&rhs) noexcept;
+        virtual ~Picture() noexcept;
+
+        //--- public operators ---
+        Picture &operator=(const Picture &rhs) noexcept(false);
+        Picture &operator=(Picture &&rhs) noexcept;
+        bool operator==(const Picture &rhs) const noexcept;
+        bool operator!=(const Picture &rhs) const noexcept;
+
+        //--- public methods ---
+        const CodecOptions &options() const noexcept;
+        void setOptions(const CodecOptions &options) noexcept(false);
+
+        virtual bool valid() const noexcept(false) override final;
+        virtual bool resize(const int64_t width, const int64_t height, const Scaler scaler)
+            noexcept(false) override final;
+        virtual bool save(const std::string &filename) const noexcept(false) override final;
+        virtual bool load(const std::string &filename) noexcept(false) override final;
+
+    private:
+        //--- private properties ---
+        CodecOptions _options;
+    };
+}
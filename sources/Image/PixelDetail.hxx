@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Image::Detail
+{
+    //
+    // the algorithms that only move pixels around, they work for any pixel type, so Base with its
+    // 16 bit and Compact with its 8 bit pixels share them, the rows are stride pixels apart
+    //
+
+    // the loaders think in 16 bit channels, a pixel with 8 bit channels keeps the high byte
+    template <typename Pixel>
+    constexpr inline decltype(Pixel::r) channel(const uint32_t value) noexcept
+    {
+        return value >> (16 - 8 * sizeof (Pixel::r));
+    }
+
+    // an opaque grey of the given 8 bit level
+    template <typename Pixel>
+    inline Pixel grey(const uint8_t level) noexcept
+    {
+        const auto value = channel<Pixel>(level << 8);
+
+        return Pixel(value, value, value, channel<Pixel>(255 << 8));
+    }
+
+    template <typename Pixel>
+    inline void nearest(const Pixel *src, const int64_t src_width, const int64_t src_height,
+                        const int64_t src_stride, Pixel *dst, const int64_t dst_width,
+                        const int64_t dst_height, const int64_t dst_stride) noexcept
+    {
+        // to stay with integer math I need a little trick here, hope noone ever tries to scale
+        // beyond 2^47 pixels :D
+        const int64_t column_ratio = ((src_width - 1) << 16) / dst_width;
+        const int64_t row_ratio = ((src_height - 1) << 16) / dst_height;
+
+        for (int64_t y = 0; y < dst_height; ++y)
+        {
+            const Pixel *in = src + ((y * row_ratio) >> 16) * src_stride;
+            Pixel *out = dst + y * dst_stride;
+
+            for (int64_t x = 0; x < dst_width; ++x)
+                out[x] = in[(x * column_ratio) >> 16];
+        }
+    }
+
+    // the top left corner stays, whatever is new gets the background
+    template <typename Pixel>
+    inline void keep(const Pixel *src, const int64_t src_width, const int64_t src_height,
+                     const int64_t src_stride, Pixel *dst, const int64_t dst_width,
+                     const int64_t dst_height, const int64_t dst_stride, const Pixel background)
+        noexcept
+    {
+        const int64_t min_width = std::min(src_width, dst_width);
+        const int64_t min_height = std::min(src_height, dst_height);
+
+        for (int64_t y = 0; y < dst_height; ++y)
+        {
+            Pixel *out = dst + y * dst_stride;
+            const int64_t kept = y < min_height ? min_width : 0;
+
+            std::copy_n(src + y * src_stride, kept, out);
+            std::fill(out + kept, out + dst_width, background);
+        }
+    }
+}
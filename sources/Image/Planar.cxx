@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "Common/ThreadPool.hxx"
+#include "Common/Tools.hxx"
+#include "Planar.hxx"
+#include "PlanarDetail.hxx"
+
+namespace Image
+{
+    //--- internal stuff ---
+
+    namespace T = Common::Tools;
+
+    //--- public constructors ---
+
+    Planar::Planar() noexcept
+    : _data(), _width(0), _height(0), _stride(0)
+    {
+    }
+
+    Planar::Planar(const int64_t width, const int64_t height) noexcept(false)
+    : _data(), _width(0), _height(0), _stride(0)
+    {
+        implAllocate(width, height);
+        // black like a fresh Base, so the alpha plane is opaque
+        std::fill(plane(Channel::Alpha), plane(Channel::Alpha) + _stride, 0xFFFF);
+    }
+
+    Planar::Planar(const Pixels &pixels, const int64_t width, const int64_t height,
+                   const int64_t threads) noexcept(false)
+    : _data(), _width(0), _height(0), _stride(0)
+    {
+        if (static_cast<int64_t>(pixels.size()) != width * height)
+            throw std::invalid_argument("planar image needs width * height pixels");
+
+        implAllocate(width, height);
+        implFromPixels(pixels.data(), threads);
+    }
+
+    Planar::Planar(const RGBA *pixels, const int64_t width, const int64_t height,
+                   const int64_t threads) noexcept(false)
+    : _data(), _width(0), _height(0), _stride(0)
+    {
+        implAllocate(width, height);
+        implFromPixels(pixels, threads);
+    }
+
+    Planar::Planar(const Planar &rhs) noexcept(false)
+    : _data(rhs._data), _width(rhs._width), _height(rhs._height), _stride(rhs._stride)
+    {
+    }
+
+    Planar::Planar(Planar &&rhs) noexcept
+    : _data(std::move(rhs._data)), _width(rhs._width), _height(rhs._height),
+      _stride(rhs._stride)
+    {
+        rhs._width = 0;
+        rhs._height = 0;
+        rhs._stride = 0;
+    }
+
+    Planar::~Planar() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    Planar &Planar::operator=(const Planar &rhs) noexcept(false)
+    {
+        if (this != &rhs)
+        {
+            _data = rhs._data;
+            _width = rhs._width;
+            _height = rhs._height;
+            _stride = rhs._stride;
+        }
+
+        return *this;
+    }
+
+    Planar &Planar::operator=(Planar &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _data = std::move(rhs._data);
+            _width = rhs._width;
+            _height = rhs._height;
+            _stride = rhs._stride;
+            rhs._width = 0;
+            rhs._height = 0;
+            rhs._stride = 0;
+        }
+
+        return *this;
+    }
+
+    bool Planar::operator==(const Planar &rhs) const noexcept
+    {
+        // the padding behind the planes is never written, so it takes part in the comparison
+        return _width == rhs._width &&
+               _height == rhs._height &&
+               _data == rhs._data;
+    }
+
+    bool Planar::operator!=(const Planar &rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    //--- public methods ---
+
+    int64_t Planar::width() const noexcept
+    {
+        return _width;
+    }
+
+    int64_t Planar::height() const noexcept
+    {
+        return _height;
+    }
+
+    uint16_t *Planar::plane(const Channel channel) noexcept
+    {
+        return _data.data() + T::valueOf(channel) * _stride;
+    }
+
+    const uint16_t *Planar::plane(const Channel channel) const noexcept
+    {
+        return _data.data() + T::valueOf(channel) * _stride;
+    }
+
+    Planar::RGBA Planar::pixel(const int64_t x, const int64_t y) const noexcept(false)
+    {
+        if (!T::inRange(x, 0, _width, true, false) || !T::inRange(y, 0, _height, true, false))
+            throw std::out_of_range("pixel outside of the planar image");
+
+        const int64_t index = y * _width + x;
+
+        return RGBA(plane(Channel::Red)[index], plane(Channel::Green)[index],
+                    plane(Channel::Blue)[index], plane(Channel::Alpha)[index]);
+    }
+
+    bool Planar::setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept
+    {
+        if (!T::inRange(x, 0, _width, true, false) || !T::inRange(y, 0, _height, true, false))
+            return false;
+
+        const int64_t index = y * _width + x;
+
+        plane(Channel::Red)[index] = color.r;
+        plane(Channel::Green)[index] = color.g;
+        plane(Channel::Blue)[index] = color.b;
+        plane(Channel::Alpha)[index] = color.a;
+
+        return true;
+    }
+
+    Planar::Pixels Planar::pixels(const int64_t threads) const noexcept(false)
+    {
+        Pixels result(_width * _height);
+
+        toPixels(result.data(), threads);
+
+        return result;
+    }
+
+    void Planar::toPixels(RGBA *pixels, const int64_t threads) const noexcept(false)
+    {
+        if (!_width || !_height)
+            return;
+
+        Common::ThreadPool::global().runBands(_height,
+                                              threads < 1 ? Common::ThreadPool::hardwareThreads()
+                                                          : threads,
+        [&](const int64_t begin, const int64_t end)
+        {
+            const int64_t offset = begin * _width;
+
+            Detail::fromPlanes(plane(Channel::Red) + offset, plane(Channel::Green) + offset,
+                               plane(Channel::Blue) + offset, plane(Channel::Alpha) + offset,
+                               pixels + offset, (end - begin) * _width);
+        });
+    }
+
+    //--- protected methods ---
+
+    void Planar::implAllocate(const int64_t width, const int64_t height) noexcept(false)
+    {
+        if ((width < 0) || (height < 0))
+            throw std::invalid_argument("planar image with a negative size");
+
+        // every plane is padded up to the alignment, so the next one starts aligned as well
+        constexpr int64_t per_line = Alignment / sizeof (uint16_t);
+
+        _width = width;
+        _height = height;
+        _stride = (width * height + per_line - 1) / per_line * per_line;
+        _data.resize(_stride * 4);
+    }
+
+    void Planar::implFromPixels(const RGBA *pixels, const int64_t threads) noexcept(false)
+    {
+        if (!_width || !_height)
+            return;
+
+        Common::ThreadPool::global().runBands(_height,
+                                              threads < 1 ? Common::ThreadPool::hardwareThreads()
+                                                          : threads,
+        [&](const int64_t begin, const int64_t end)
+        {
+            const int64_t offset = begin * _width;
+
+            Detail::toPlanes(pixels + offset, plane(Channel::Red) + offset,
+                             plane(Channel::Green) + offset, plane(Channel::Blue) + offset,
+                             plane(Channel::Alpha) + offset, (end - begin) * _width);
+        });
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "Color/RGBA16161616.hxx"
+#include "Common/AlignedAllocator.hxx"
+
+namespace Image
+{
+    //--- base types and constants ---
+    enum class Channel : int16_t {
+        Red,
+        Green,
+        Blue,
+        Alpha
+    };
+
+    //
+    // Planar - the structure of arrays counterpart to the interleaved pixels of Base, every channel
+    //          lives in a plane of its own, so a kernel that only needs one channel streams it
+    //          without dragging the other three through the cache
+    //
+    // - all four planes share one allocation, every plane starts on a 64 byte boundary and the
+    //   rows inside a plane follow each other without padding
+    // - the conversion from and to interleaved pixels runs in bands of rows and uses SSE2 shuffles
+    //   for eight pixels at a time where available
+    //
+    class Planar {
+    public:
+        //--- public types and constants ---
+        using RGBA = Color::RGBA16161616;
+        using Pixels = std::pmr::vector<RGBA>;
+        using Plane = std::vector<uint16_t, Common::AlignedAllocator<uint16_t, 64>>;
+
+        static constexpr int64_t Alignment = 64;
+
+        //--- public constructors ---
+        Planar() noexcept;
+        Planar(const int64_t width, const int64_t height) noexcept(false);
+        Planar(const Pixels &pixels, const int64_t width, const int64_t height,
+               const int64_t threads = 1) noexcept(false);
+        Planar(const RGBA *pixels, const int64_t width, const int64_t height,
+               const int64_t threads = 1) noexcept(false);
+        Planar(const Planar &rhs) noexcept(false);
+        Planar(Planar &&rhs) noexcept;
+        ~Planar() noexcept;
+
+        //--- public operators ---
+        Planar &operator=(const Planar &rhs) noexcept(false);
+        Planar &operator=(Planar &&rhs) noexcept;
+        bool operator==(const Planar &rhs) const noexcept;
+        bool operator!=(const Planar &rhs) const noexcept;
+
+        //--- public methods ---
+        int64_t width() const noexcept;
+        int64_t height() const noexcept;
+        uint16_t *plane(const Channel channel) noexcept;
+        const uint16_t *plane(const Channel channel) const noexcept;
+        RGBA pixel(const int64_t x, const int64_t y) const noexcept(false);
+        bool setPixel(const int64_t x, const int64_t y, const RGBA color) noexcept;
+        Pixels pixels(const int64_t threads = 1) const noexcept(false);
+        void toPixels(RGBA *pixels, const int64_t threads = 1) const noexcept(false);
+
+    protected:
+        //--- protected methods ---
+        void implAllocate(const int64_t width, const int64_t height) noexcept(false);
+        void implFromPixels(const RGBA *pixels, const int64_t threads) noexcept(false);
+
+    private:
+        //--- private properties ---
+        Plane _data;
+        int64_t _width;
+        int64_t _height;
+        int64_t _stride;
+    };
+}
@@ -0,0 +1,81 @@
+#if defined __x86_64__
+#include <immintrin.h>
+#endif
+#include "PlanarDetail.hxx"
+
+namespace Image::Detail
+{
+    //--- public functions ---
+
+    //
+    // the channels of a pixel are the words a, b, g, r in memory, so eight pixels are transposed
+    // in two rounds of 16 bit unpacks, that gather the same channel of four pixels into one half
+    // of a register, and the 64 bit halves are then sorted into the planes
+    //
+    void toPlanes(const RGBA *pixels, uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *a,
+                  const int64_t count) noexcept
+    {
+        int64_t i = 0;
+
+#if defined __x86_64__
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i *in = reinterpret_cast<const __m128i *>(pixels + i);
+            const __m128i v0 = _mm_loadu_si128(in);
+            const __m128i v1 = _mm_loadu_si128(in + 1);
+            const __m128i v2 = _mm_loadu_si128(in + 2);
+            const __m128i v3 = _mm_loadu_si128(in + 3);
+            const __m128i t0 = _mm_unpacklo_epi16(v0, v1);
+            const __m128i t1 = _mm_unpackhi_epi16(v0, v1);
+            const __m128i t2 = _mm_unpacklo_epi16(v2, v3);
+            const __m128i t3 = _mm_unpackhi_epi16(v2, v3);
+            const __m128i ab0 = _mm_unpacklo_epi16(t0, t1);
+            const __m128i gr0 = _mm_unpackhi_epi16(t0, t1);
+            const __m128i ab1 = _mm_unpacklo_epi16(t2, t3);
+            const __m128i gr1 = _mm_unpackhi_epi16(t2, t3);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(a + i), _mm_unpacklo_epi64(ab0, ab1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(b + i), _mm_unpackhi_epi64(ab0, ab1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(g + i), _mm_unpacklo_epi64(gr0, gr1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(r + i), _mm_unpackhi_epi64(gr0, gr1));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            r[i] = pixels[i].r;
+            g[i] = pixels[i].g;
+            b[i] = pixels[i].b;
+            a[i] = pixels[i].a;
+        }
+    }
+
+    void fromPlanes(const uint16_t *r, const uint16_t *g, const uint16_t *b, const uint16_t *a,
+                    RGBA *pixels, const int64_t count) noexcept
+    {
+        int64_t i = 0;
+
+#if defined __x86_64__
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+            const __m128i vg = _mm_loadu_si128(reinterpret_cast<const __m128i *>(g + i));
+            const __m128i vr = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r + i));
+            const __m128i ab0 = _mm_unpacklo_epi16(va, vb);
+            const __m128i ab1 = _mm_unpackhi_epi16(va, vb);
+            const __m128i gr0 = _mm_unpacklo_epi16(vg, vr);
+            const __m128i gr1 = _mm_unpackhi_epi16(vg, vr);
+            __m128i *out = reinterpret_cast<__m128i *>(pixels + i);
+
+            _mm_storeu_si128(out, _mm_unpacklo_epi32(ab0, gr0));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi32(ab0, gr0));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi32(ab1, gr1));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi32(ab1, gr1));
+        }
+#endif
+
+        for (; i < count; ++i)
+            pixels[i].set(r[i], g[i], b[i], a[i]);
+    }
+}
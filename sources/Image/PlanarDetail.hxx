@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include "Base.hxx"
+
+namespace Image::Detail
+{
+    using RGBA = Base::RGBA;
+
+    // splits count interleaved pixels into the four channel planes and merges them back
+    void toPlanes(const RGBA *pixels, uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *a,
+                  const int64_t count) noexcept;
+    void fromPlanes(const uint16_t *r, const uint16_t *g, const uint16_t *b, const uint16_t *a,
+                    RGBA *pixels, const int64_t count) noexcept;
+}
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "Common/ThreadPool.hxx"
+#include "Common/Tools.hxx"
+#include "Pyramid.hxx"
+#include "ResampleDetail.hxx"
+
+namespace Image
+{
+    //--- internal stuff ---
+
+    namespace T = Common::Tools;
+
+    //--- public constructors ---
+
+    Pyramid::Pyramid() noexcept
+    : _data(), _levels()
+    {
+    }
+
+    Pyramid::Pyramid(const Pixels &pixels, const int64_t width, const int64_t height,
+                     const int64_t threads) noexcept(false)
+    : _data(), _levels()
+    {
+        if ((width < 0) || (height < 0) || (static_cast<int64_t>(pixels.size()) != width * height))
+            throw std::invalid_argument("pyramid needs width * height pixels");
+
+        if (width && height)
+        {
+            layout(width, height);
+            // the buffer is allocated once with room for all levels
+            _data.reserve(_levels.back().offset + 1);
+            _data.insert(_data.end(), pixels.begin(), pixels.end());
+            _data.resize(_levels.back().offset + 1);
+            build(threads < 1 ? Common::ThreadPool::hardwareThreads() : threads);
+        }
+    }
+
+    Pyramid::Pyramid(const Pyramid &rhs) noexcept(false)
+    : _data(rhs._data), _levels(rhs._levels)
+    {
+    }
+
+    Pyramid::Pyramid(Pyramid &&rhs) noexcept
+    : _data(std::move(rhs._data)), _levels(std::move(rhs._levels))
+    {
+    }
+
+    Pyramid::~Pyramid() noexcept
+    {
+    }
+
+    //--- public operators ---
+
+    Pyramid &Pyramid::operator=(const Pyramid &rhs) noexcept(false)
+    {
+        if (this != &rhs)
+        {
+            _data = rhs._data;
+            _levels = rhs._levels;
+        }
+
+        return *this;
+    }
+
+    Pyramid &Pyramid::operator=(Pyramid &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _data = std::move(rhs._data);
+            _levels = std::move(rhs._levels);
+        }
+
+        return *this;
+    }
+
+    bool Pyramid::operator==(const Pyramid &rhs) const noexcept
+    {
+        return _data == rhs._data &&
+               _levels == rhs._levels;
+    }
+
+    bool Pyramid::operator!=(const Pyramid &rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    //--- public methods ---
+
+    int64_t Pyramid::levels() const noexcept
+    {
+        return _levels.size();
+    }
+
+    int64_t Pyramid::width(const int64_t level) const noexcept(false)
+    {
+        return _levels.at(level).width;
+    }
+
+    int64_t Pyramid::height(const int64_t level) const noexcept(false)
+    {
+        return _levels.at(level).height;
+    }
+
+    const Pyramid::RGBA *Pyramid::data(const int64_t level) const noexcept(false)
+    {
+        return _data.data() + _levels.at(level).offset;
+    }
+
+    Pyramid::Pixels Pyramid::pixels(const int64_t level) const noexcept(false)
+    {
+        const Level &lvl = _levels.at(level);
+        const auto begin = _data.begin() + lvl.offset;
+
+        return Pixels(begin, begin + lvl.width * lvl.height);
+    }
+
+    Pyramid::RGBA Pyramid::pixel(const int64_t level, const int64_t x, const int64_t y) const
+        noexcept(false)
+    {
+        const Level &lvl = _levels.at(level);
+
+        if (!T::inRange(x, 0, lvl.width, true, false) || !T::inRange(y, 0, lvl.height, true, false))
+            throw std::out_of_range("pixel outside of the pyramid level");
+
+        return _data[lvl.offset + y * lvl.width + x];
+    }
+
+    int64_t Pyramid::pick(const int64_t width, const int64_t height) const noexcept
+    {
+        // the smallest level that still covers the requested size, so it only ever gets reduced
+        for (int64_t level = levels() - 1; level > 0; --level)
+            if ((_levels[level].width >= width) && (_levels[level].height >= height))
+                return level;
+
+        return 0;
+    }
+
+    //--- protected methods ---
+
+    void Pyramid::layout(const int64_t width, const int64_t height) noexcept(false)
+    {
+        _levels.push_back({0, width, height});
+        while ((_levels.back().width > 1) || (_levels.back().height > 1))
+        {
+            const Level &last = _levels.back();
+
+            _levels.push_back({last.offset + last.width * last.height,
+                               std::max<int64_t>(last.width / 2, 1),
+                               std::max<int64_t>(last.height / 2, 1)});
+        }
+    }
+
+    void Pyramid::build(const int64_t threads) noexcept(false)
+    {
+        if (levels() < 2)
+            return;
+
+        // a band of rows of some level only depends on the rows twice as far down in the level
+        // above, so every band is carried down to the deepest level that still has a row per
+        // band on its own, as long as the rows really got halved on the way
+        const int64_t bands = std::clamp<int64_t>(threads, 1, _levels[1].height);
+        int64_t deepest = 1;
+
+        while (((deepest + 1) < levels()) && (_levels[deepest + 1].height >= bands) &&
+               (_levels[deepest].height > 1))
+            ++deepest;
+
+        Common::ThreadPool::global().runBands(_levels[deepest].height, bands,
+        [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t level = 1; level <= deepest; ++level)
+            {
+                const int64_t scale = int64_t(1) << (deepest - level);
+                // the rows left over by odd heights belong to the last band
+                const int64_t last = end == _levels[deepest].height ? _levels[level].height
+                                                                     : end * scale;
+
+                buildRows(level, begin * scale, last);
+            }
+        });
+
+        // whatever is left is smaller than a row per band
+        for (int64_t level = deepest + 1; level < levels(); ++level)
+            buildRows(level, 0, _levels[level].height);
+    }
+
+    void Pyramid::buildRows(const int64_t level, const int64_t begin, const int64_t end) noexcept
+    {
+        const Level &src = _levels[level - 1];
+        const Level &dst = _levels[level];
+
+        for (int64_t y = begin; y < end; ++y)
+        {
+            // a side of a single pixel is not halved any more, so the pixels are just repeated
+            const RGBA *top = _data.data() + src.offset + y * 2 * src.width;
+            const RGBA *bottom = src.height > 1 ? top + src.width : top;
+            RGBA *out = _data.data() + dst.offset + y * dst.width;
+
+            if (src.width > 1)
+                Detail::halveRow(top, bottom, out, dst.width);
+            else
+                out->set((top->r + bottom->r + 1) >> 1, (top->g + bottom->g + 1) >> 1,
+                         (top->b + bottom->b + 1) >> 1, (top->a + bottom->a + 1) >> 1);
+        }
+    }
+}
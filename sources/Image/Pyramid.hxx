@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "Color/RGBA16161616.hxx"
+
+namespace Image
+{
+    //
+    // Pyramid - a complete mipmap chain kept in one buffer, level 0 is the full image and every
+    //           further level halves both sides with a 2x2 box until a 1x1 level is reached
+    //
+    // - odd sides are rounded down (but never below 1), so the last row or column of an odd level
+    //   does not reach the next one, like OpenGL does it
+    // - every band of rows is carried through as many levels as it fully covers by one thread,
+    //   so the levels are built in parallel and while the rows are still in the cache
+    //
+    class Pyramid {
+    public:
+        //--- public types and constants ---
+        using RGBA = Color::RGBA16161616;
+        using Pixels = std::pmr::vector<RGBA>;
+
+        //--- public constructors ---
+        Pyramid() noexcept;
+        Pyramid(const Pixels &pixels, const int64_t width, const int64_t height,
+                const int64_t threads = 1) noexcept(false);
+        Pyramid(const Pyramid &rhs) noexcept(false);
+        Pyramid(Pyramid &&rhs) noexcept;
+        ~Pyramid() noexcept;
+
+        //--- public operators ---
+        Pyramid &operator=(const Pyramid &rhs) noexcept(false);
+        Pyramid &operator=(Pyramid &&rhs) noexcept;
+        bool operator==(const Pyramid &rhs) const noexcept;
+        bool operator!=(const Pyramid &rhs) const noexcept;
+
+        //--- public methods ---
+        int64_t levels() const noexcept;
+        int64_t width(const int64_t level) const noexcept(false);
+        int64_t height(const int64_t level) const noexcept(false);
+        const RGBA *data(const int64_t level) const noexcept(false);
+        Pixels pixels(const int64_t level) const noexcept(false);
+        RGBA pixel(const int64_t level, const int64_t x, const int64_t y) const noexcept(false);
+        int64_t pick(const int64_t width, const int64_t height) const noexcept;
+
+    protected:
+        //--- protected methods ---
+        void layout(const int64_t width, const int64_t height) noexcept(false);
+        void build(const int64_t threads) noexcept(false);
+        void buildRows(const int64_t level, const int64_t begin, const int64_t end) noexcept;
+
+    private:
+        //--- private types and constants ---
+        struct Level {
+            int64_t offset;
+            int64_t width;
+            int64_t height;
+
+            bool operator==(const Level &rhs) const noexcept = default;
+        };
+
+        //--- private properties ---
+        Pixels _data;
+        std::vector<Level> _levels;
+    };
+}
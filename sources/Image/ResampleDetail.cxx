@@ -0,0 +1,626 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <vector>
+#if defined __x86_64__
+#include <immintrin.h>
+#endif
+#include "Common/ThreadPool.hxx"
+#include "CpuDetail.hxx"
+#include "ResampleDetail.hxx"
+
+namespace Image::Detail
+{
+    //--- internal stuff ---
+
+    // all four channels of a pixel in one vector, kept in the memory order of RGBA16161616, which
+    // does not matter here because every channel is treated the same
+    using FPixel = float __attribute__((vector_size(16)));
+    using IPixel = int32_t __attribute__((vector_size(16)));
+    using Channels = uint16_t __attribute__((vector_size(8)));
+
+    //
+    // Weights - for every output position the first source position and a fixed amount of taps,
+    //           source positions beyond the edges are clamped and merged into the edge taps, so
+    //           the taps of one output position always cover consecutive source positions
+    //
+    struct Weights {
+        std::vector<int64_t> first;
+        std::vector<float> weights;
+        int64_t taps;
+    };
+
+    static inline double triangle(const double x) noexcept
+    {
+        return std::max(1.0 - std::abs(x), .0);
+    }
+
+    static inline double cubic(const double x) noexcept
+    {
+        // Keys cubic convolution with a = -0.5 (Catmull-Rom)
+        const double ax = std::abs(x);
+
+        if (ax < 1)
+            return (1.5 * ax - 2.5) * ax * ax + 1;
+        if (ax < 2)
+            return ((-0.5 * ax + 2.5) * ax - 4) * ax + 2;
+
+        return 0;
+    }
+
+    static inline double lanczos3(const double x) noexcept
+    {
+        constexpr double pi = std::numbers::pi;
+
+        if (x == 0)
+            return 1;
+        if (std::abs(x) >= 3)
+            return 0;
+
+        return 3 * std::sin(pi * x) * std::sin(pi * x / 3) / (pi * pi * x * x);
+    }
+
+    static Weights weights(const int64_t src_size, const int64_t dst_size, const Scaler scaler)
+        noexcept(false)
+    {
+        const double scale = static_cast<double>(dst_size) / src_size;
+        // when reducing, the filter is stretched over the source to cover all contributing pixels
+        const double stretch = std::min(scale, 1.0);
+        double support = 1;
+        double (*func)(const double) = triangle;
+        Weights result;
+
+        switch (scaler)
+        {
+            case Scaler::Bicubic:
+                support = 2;
+                func = cubic;
+                break;
+
+            case Scaler::Lanczos3:
+                support = 3;
+                func = lanczos3;
+                break;
+
+            case Scaler::Area:
+                support = .5;
+                break;
+
+            default:
+                break;
+        }
+
+        support /= stretch;
+        result.taps = std::min<int64_t>(std::ceil(support) * 2 + 1, src_size);
+        result.first.resize(dst_size);
+        result.weights.resize(dst_size * result.taps, 0);
+
+        for (int64_t i = 0; i < dst_size; ++i)
+        {
+            const double center = (i + .5) / scale;
+            const int64_t low = std::floor(center - support);
+            const int64_t high = std::ceil(center + support);
+            const int64_t first = std::clamp<int64_t>(std::min(low, src_size - result.taps), 0,
+                                                      src_size - result.taps);
+            float *taps = result.weights.data() + i * result.taps;
+            double sum = 0;
+
+            for (int64_t j = low; j <= high; ++j)
+            {
+                double weight = 0;
+
+                if (scaler == Scaler::Area)
+                {
+                    // the overlap of the source pixel with the output pixel's footprint
+                    weight = std::max(std::min(j + 1.0, center + support) -
+                                      std::max(j * 1.0, center - support), .0);
+                }
+                else
+                    weight = func((j + .5 - center) * stretch);
+
+                if (weight != 0)
+                {
+                    taps[std::clamp<int64_t>(j, 0, src_size - 1) - first] += weight;
+                    sum += weight;
+                }
+            }
+
+            result.first[i] = first;
+            if (sum != 0)
+                for (int64_t t = 0; t < result.taps; ++t)
+                    taps[t] /= sum;
+        }
+
+        return result;
+    }
+
+    static inline FPixel load(const RGBA &pixel) noexcept
+    {
+#if defined __x86_64__
+        // gcc scalarizes the generic 16 bit to float conversion, so help it out
+        const __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&pixel));
+
+        return _mm_cvtepi32_ps(_mm_unpacklo_epi16(raw, _mm_setzero_si128()));
+#else
+        Channels channels;
+
+        std::memcpy(&channels, &pixel.value, sizeof (channels));
+
+        return __builtin_convertvector(channels, FPixel);
+#endif
+    }
+
+    static inline void store(RGBA &out, FPixel pixel) noexcept
+    {
+        pixel = pixel < .0f ? .0f : pixel;
+        pixel = pixel > 65535.0f ? 65535.0f : pixel;
+
+#if defined __x86_64__
+        // shift into the signed 16 bit range for the saturating pack and back again
+        const __m128i val = _mm_sub_epi32(_mm_cvttps_epi32(pixel + .5f), _mm_set1_epi32(0x8000));
+        const __m128i packed = _mm_xor_si128(_mm_packs_epi32(val, val),
+                                             _mm_set1_epi16(static_cast<int16_t>(0x8000)));
+
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(&out), packed);
+#else
+        const IPixel rounded = __builtin_convertvector(pixel + .5f, IPixel);
+        const Channels channels = __builtin_convertvector(rounded, Channels);
+
+        std::memcpy(&out.value, &channels, sizeof (channels));
+#endif
+    }
+
+    static void horizontal(const FPixel *in, RGBA *out, const int64_t out_width, const Weights &wx)
+        noexcept
+    {
+        for (int64_t x = 0; x < out_width; ++x)
+        {
+            const float *weights = wx.weights.data() + x * wx.taps;
+            const FPixel *taps = in + wx.first[x];
+            FPixel sum = {0, 0, 0, 0};
+
+            for (int64_t t = 0; t < wx.taps; ++t)
+                sum += taps[t] * weights[t];
+
+            store(out[x], sum);
+        }
+    }
+
+    static void vertical(const RGBA *in, const int64_t width, const int64_t stride, FPixel *out,
+                         const int64_t y, const Weights &wy) noexcept
+    {
+        const float *weights = wy.weights.data() + y * wy.taps;
+
+        std::fill_n(out, width, FPixel{0, 0, 0, 0});
+        for (int64_t t = 0; t < wy.taps; ++t)
+        {
+            const RGBA *src = in + (wy.first[y] + t) * stride;
+            const float weight = weights[t];
+
+            if (weight != 0)
+                for (int64_t x = 0; x < width; ++x)
+                    out[x] += load(src[x]) * weight;
+        }
+    }
+
+    //
+    // Linear - the first of the two source positions for every output position and the fraction
+    //          of the second one in 16 bit fixed point, repeated for all four channels so the
+    //          fractions can be loaded right next to the pixels, positions beyond the last source
+    //          pixel are clamped to it with a zero fraction, they are all at the end and start at
+    //          inner, before that the second source position is always valid
+    //
+    struct Linear {
+        std::vector<int64_t> offsets;
+        std::vector<uint64_t> fractions;
+        int64_t inner;
+    };
+
+    static Linear linear(const int64_t src_size, const int64_t dst_size) noexcept(false)
+    {
+        const double scale = static_cast<double>(src_size) / dst_size;
+        Linear result;
+
+        result.offsets.resize(dst_size);
+        result.fractions.resize(dst_size);
+        result.inner = dst_size;
+        for (int64_t i = 0; i < dst_size; ++i)
+        {
+            // pixel centers are aligned
+            const double pos = std::clamp((i + .5) * scale - .5, .0, src_size - 1.0);
+            const int64_t offset = pos;
+            const uint64_t fraction = std::min<int64_t>((pos - offset) * 65536, 0xFFFF);
+
+            result.offsets[i] = offset;
+            result.fractions[i] = fraction * 0x0001000100010001ull;
+            if ((offset == (src_size - 1)) && (result.inner == dst_size))
+                result.inner = i;
+        }
+
+        return result;
+    }
+
+    // a - a * f + b * f with every product truncated, which never leaves the range of a and b,
+    // all paths use the same formula so their results are identical
+    static inline uint64_t scalarLerp(const uint64_t a, const uint64_t b, const uint64_t fractions)
+        noexcept
+    {
+        const uint32_t fraction = fractions & 0xFFFF;
+        uint64_t result = 0;
+
+        for (int32_t shift = 0; shift < 64; shift += 16)
+        {
+            const uint32_t ca = (a >> shift) & 0xFFFF;
+            const uint32_t cb = (b >> shift) & 0xFFFF;
+
+            result |= static_cast<uint64_t>(ca - ((ca * fraction) >> 16) +
+                                            ((cb * fraction) >> 16)) << shift;
+        }
+
+        return result;
+    }
+
+    static void scalarRow(const RGBA *top, const RGBA *bottom, const uint64_t fy, const Linear &lx,
+                          RGBA *out, const int64_t begin, const int64_t end) noexcept
+    {
+        for (int64_t x = begin; x < end; ++x)
+        {
+            // a zero fraction does not need the second pixel, which might not even exist
+            const int64_t offset = lx.offsets[x];
+            const int64_t next = offset + (lx.fractions[x] != 0);
+            const uint64_t left = scalarLerp(top[offset].value, bottom[offset].value, fy);
+            const uint64_t right = scalarLerp(top[next].value, bottom[next].value, fy);
+
+            out[x].value = scalarLerp(left, right, lx.fractions[x]);
+        }
+    }
+
+#if defined __x86_64__
+    //
+    // SSE2 path - two pixels per iteration, the left and right source pixels are loaded together
+    //             and blended vertically before they are split up for the horizontal blend
+    //
+    static inline __m128i sse2Lerp(const __m128i a, const __m128i b, const __m128i fractions)
+        noexcept
+    {
+        return _mm_add_epi16(_mm_sub_epi16(a, _mm_mulhi_epu16(a, fractions)),
+                             _mm_mulhi_epu16(b, fractions));
+    }
+
+    static inline __m128i sse2Pair(const RGBA *top, const RGBA *bottom, const int64_t offset,
+                                   const __m128i fy) noexcept
+    {
+        return sse2Lerp(_mm_loadu_si128(reinterpret_cast<const __m128i *>(top + offset)),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(bottom + offset)), fy);
+    }
+
+    static void sse2Row(const RGBA *top, const RGBA *bottom, const uint64_t fy, const Linear &lx,
+                        RGBA *out, const int64_t begin, const int64_t end) noexcept
+    {
+        const __m128i fractions = _mm_set1_epi64x(fy);
+        int64_t x = begin;
+
+        for (; (x + 1) < end; x += 2)
+        {
+            const __m128i first = sse2Pair(top, bottom, lx.offsets[x], fractions);
+            const __m128i second = sse2Pair(top, bottom, lx.offsets[x + 1], fractions);
+            const __m128i fx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                                                   lx.fractions.data() + x));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x),
+                             sse2Lerp(_mm_unpacklo_epi64(first, second),
+                                      _mm_unpackhi_epi64(first, second), fx));
+        }
+
+        scalarRow(top, bottom, fy, lx, out, x, end);
+    }
+
+    //
+    // AVX2 path - four pixels per iteration, the remainder is done by the SSE2 path
+    //
+    static __attribute__((target("avx2"))) inline __m256i avx2Lerp(const __m256i a,
+                                                                   const __m256i b,
+                                                                   const __m256i fractions)
+        noexcept
+    {
+        return _mm256_add_epi16(_mm256_sub_epi16(a, _mm256_mulhi_epu16(a, fractions)),
+                                _mm256_mulhi_epu16(b, fractions));
+    }
+
+    static __attribute__((target("avx2"))) inline __m256i avx2Load(const RGBA *low,
+                                                                   const RGBA *high) noexcept
+    {
+        const __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i *>(low));
+        const __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i *>(high));
+
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(lower), upper, 1);
+    }
+
+    static __attribute__((target("avx2"))) void avx2Row(const RGBA *top, const RGBA *bottom,
+                                                        const uint64_t fy, const Linear &lx,
+                                                        RGBA *out, const int64_t begin,
+                                                        const int64_t end) noexcept
+    {
+        const __m256i fractions = _mm256_set1_epi64x(fy);
+        int64_t x = begin;
+
+        for (; (x + 3) < end; x += 4)
+        {
+            // pixels 0 and 2 go into one register and 1 and 3 into the other, so unpacking the
+            // lanes puts the four pixels back into order
+            const int64_t *offsets = lx.offsets.data() + x;
+            const __m256i even = avx2Lerp(avx2Load(top + offsets[0], top + offsets[2]),
+                                          avx2Load(bottom + offsets[0], bottom + offsets[2]),
+                                          fractions);
+            const __m256i odd = avx2Lerp(avx2Load(top + offsets[1], top + offsets[3]),
+                                         avx2Load(bottom + offsets[1], bottom + offsets[3]),
+                                         fractions);
+            const __m256i fx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+                                                      lx.fractions.data() + x));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x),
+                                avx2Lerp(_mm256_unpacklo_epi64(even, odd),
+                                         _mm256_unpackhi_epi64(even, odd), fx));
+        }
+
+        // leave the upper halves clean, the SSE2 code would pay for every instruction otherwise
+        _mm256_zeroupper();
+        sse2Row(top, bottom, fy, lx, out, x, end);
+    }
+#endif
+
+    //
+    // 2x2 box - the four source pixels of every output pixel are summed up in 32 bit lanes and
+    //           rounded, all paths give the same results
+    //
+    static void scalarHalve(const RGBA *top, const RGBA *bottom, RGBA *out, const int64_t begin,
+                            const int64_t end) noexcept
+    {
+        for (int64_t x = begin; x < end; ++x)
+        {
+            const RGBA *t = top + x * 2;
+            const RGBA *b = bottom + x * 2;
+
+            out[x].set((t[0].r + t[1].r + b[0].r + b[1].r + 2) >> 2,
+                       (t[0].g + t[1].g + b[0].g + b[1].g + 2) >> 2,
+                       (t[0].b + t[1].b + b[0].b + b[1].b + 2) >> 2,
+                       (t[0].a + t[1].a + b[0].a + b[1].a + 2) >> 2);
+        }
+    }
+
+#if defined __x86_64__
+    // the sum of a source pixel pair in 32 bit lanes
+    static inline __m128i sse2PairSum(const __m128i pair) noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        return _mm_add_epi32(_mm_unpacklo_epi16(pair, zero), _mm_unpackhi_epi16(pair, zero));
+    }
+
+    static inline __m128i sse2BoxSum(const RGBA *top, const RGBA *bottom) noexcept
+    {
+        return _mm_add_epi32(sse2PairSum(_mm_loadu_si128(reinterpret_cast<const __m128i *>(top))),
+                             sse2PairSum(_mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                                                             bottom))));
+    }
+
+    static void sse2Halve(const RGBA *top, const RGBA *bottom, RGBA *out, const int64_t begin,
+                          const int64_t end) noexcept
+    {
+        const __m128i round = _mm_set1_epi32(2);
+        const __m128i bias = _mm_set1_epi32(0x8000);
+        const __m128i flip = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+        int64_t x = begin;
+
+        for (; (x + 1) < end; x += 2)
+        {
+            __m128i first = _mm_srli_epi32(_mm_add_epi32(sse2BoxSum(top + x * 2, bottom + x * 2),
+                                                         round), 2);
+            __m128i second = _mm_srli_epi32(_mm_add_epi32(sse2BoxSum(top + x * 2 + 2,
+                                                                     bottom + x * 2 + 2),
+                                                          round), 2);
+
+            // no unsigned 32 bit pack in SSE2, so go through the signed one
+            first = _mm_sub_epi32(first, bias);
+            second = _mm_sub_epi32(second, bias);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x),
+                             _mm_xor_si128(_mm_packs_epi32(first, second), flip));
+        }
+
+        scalarHalve(top, bottom, out, x, end);
+    }
+
+    static __attribute__((target("avx2"))) inline __m256i avx2BoxSum(const RGBA *top,
+                                                                    const RGBA *bottom) noexcept
+    {
+        // every lane holds a source pair, so both lanes end up with the sum of one output pixel
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(top));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bottom));
+
+        return _mm256_add_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(t, zero),
+                                                 _mm256_unpackhi_epi16(t, zero)),
+                                _mm256_add_epi32(_mm256_unpacklo_epi16(b, zero),
+                                                 _mm256_unpackhi_epi16(b, zero)));
+    }
+
+    static __attribute__((target("avx2"))) void avx2Halve(const RGBA *top, const RGBA *bottom,
+                                                          RGBA *out, const int64_t begin,
+                                                          const int64_t end) noexcept
+    {
+        const __m256i round = _mm256_set1_epi32(2);
+        int64_t x = begin;
+
+        for (; (x + 3) < end; x += 4)
+        {
+            const __m256i first = _mm256_srli_epi32(_mm256_add_epi32(avx2BoxSum(top + x * 2,
+                                                                                bottom + x * 2),
+                                                                     round), 2);
+            const __m256i second = _mm256_srli_epi32(_mm256_add_epi32(
+                                                         avx2BoxSum(top + x * 2 + 4,
+                                                                    bottom + x * 2 + 4),
+                                                         round), 2);
+
+            // the pack gives the pixel order 0 2 1 3
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x),
+                                _mm256_permute4x64_epi64(_mm256_packus_epi32(first, second),
+                                                         0xD8));
+        }
+
+        _mm256_zeroupper();
+        sse2Halve(top, bottom, out, x, end);
+    }
+#endif
+
+    //
+    // warp - the source positions are fixed point numbers with 32 bits of fraction, the upper 16
+    //        of these are the fractions of the interpolation
+    //
+    constexpr int64_t WarpShift = 32;
+    constexpr double WarpOne = 1ll << WarpShift;
+    constexpr int64_t WarpHalf = 1ll << (WarpShift - 1);
+
+    // the four source pixels around a position inside of the source, the ones beyond the edges
+    // are clamped, the pixels that are inside are blended with SSE2 two at a time
+    static inline uint64_t warpPixel(const RGBA *src, const int64_t src_width,
+                                     const int64_t src_height, const int64_t src_stride,
+                                     const int64_t pos_x, const int64_t pos_y) noexcept
+    {
+        const int64_t left = pos_x >> WarpShift;
+        const int64_t top = pos_y >> WarpShift;
+        const uint64_t fx = ((pos_x >> (WarpShift - 16)) & 0xFFFF) * 0x0001000100010001ull;
+        const uint64_t fy = ((pos_y >> (WarpShift - 16)) & 0xFFFF) * 0x0001000100010001ull;
+
+#if defined __x86_64__
+        if ((left >= 0) && (left < src_width - 1) && (top >= 0) && (top < src_height - 1))
+        {
+            const RGBA *upper = src + top * src_stride + left;
+            const __m128i pair = sse2Pair(upper, upper + src_stride, 0, _mm_set1_epi64x(fy));
+
+            return _mm_cvtsi128_si64(sse2Lerp(pair, _mm_srli_si128(pair, 8),
+                                              _mm_set1_epi64x(fx)));
+        }
+#endif
+        const int64_t x1 = std::clamp<int64_t>(left, 0, src_width - 1);
+        const int64_t x2 = std::clamp<int64_t>(left + 1, 0, src_width - 1);
+        const RGBA *upper = src + std::clamp<int64_t>(top, 0, src_height - 1) * src_stride;
+        const RGBA *lower = src + std::clamp<int64_t>(top + 1, 0, src_height - 1) * src_stride;
+
+        return scalarLerp(scalarLerp(upper[x1].value, lower[x1].value, fy),
+                          scalarLerp(upper[x2].value, lower[x2].value, fy), fx);
+    }
+
+    //--- public functions ---
+
+    void resample(const RGBA *src, const int64_t src_width, const int64_t src_height,
+                  const int64_t src_stride, RGBA *dst, const int64_t dst_width,
+                  const int64_t dst_height, const int64_t dst_stride, const Scaler scaler,
+                  const int64_t threads) noexcept(false)
+    {
+        const Weights wx = weights(src_width, dst_width, scaler);
+        const Weights wy = weights(src_height, dst_height, scaler);
+
+        // every output row is streamed through a single float row holding the vertical pass,
+        // so no intermediate image is needed and the rows are independent of each other
+        Common::ThreadPool::global().runBands(dst_height, threads,
+        [&](const int64_t begin, const int64_t end)
+        {
+            std::vector<FPixel> row(src_width);
+
+            for (int64_t y = begin; y < end; ++y)
+            {
+                vertical(src, src_width, src_stride, row.data(), y, wy);
+                horizontal(row.data(), dst + y * dst_stride, dst_width, wx);
+            }
+        });
+    }
+
+    void bilinear(const RGBA *src, const int64_t src_width, const int64_t src_height,
+                  const int64_t src_stride, RGBA *dst, const int64_t dst_width,
+                  const int64_t dst_height, const int64_t dst_stride, const int64_t threads)
+        noexcept(false)
+    {
+        // the horizontal offsets and fractions are the same for every row
+        const Linear lx = linear(src_width, dst_width);
+        const Linear ly = linear(src_height, dst_height);
+
+        Common::ThreadPool::global().runBands(dst_height, threads,
+        [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t y = begin; y < end; ++y)
+            {
+                const uint64_t fy = ly.fractions[y];
+                const RGBA *top = src + ly.offsets[y] * src_stride;
+                const RGBA *bottom = fy != 0 ? top + src_stride : top;
+                RGBA *out = dst + y * dst_stride;
+
+                // the vector paths load both source pixels at once, so the clamped positions at
+                // the end are left to the scalar path
+#if defined __x86_64__
+                if (hasAvx2())
+                    avx2Row(top, bottom, fy, lx, out, 0, lx.inner);
+                else
+                    sse2Row(top, bottom, fy, lx, out, 0, lx.inner);
+#else
+                scalarRow(top, bottom, fy, lx, out, 0, lx.inner);
+#endif
+                scalarRow(top, bottom, fy, lx, out, lx.inner, dst_width);
+            }
+        });
+    }
+
+    void warp(const RGBA *src, const int64_t src_width, const int64_t src_height,
+              const int64_t src_stride, RGBA *dst, const int64_t dst_width,
+              const int64_t dst_height, const int64_t dst_stride, const Affine &inverse,
+              const bool interpolate, const RGBA background, const int64_t threads)
+        noexcept(false)
+    {
+        // interpolation starts at the pixel whose center is left of and above the position, the
+        // position itself still decides whether a pixel is inside of the source
+        const double start = interpolate ? .5 : 0;
+        const int64_t inside = interpolate ? WarpHalf : 0;
+        const Affine::V2d step = inverse.mapDirection(Affine::V2d(1, 0));
+        const int64_t step_x = std::llround(step.x * WarpOne);
+        const int64_t step_y = std::llround(step.y * WarpOne);
+
+        Common::ThreadPool::global().runBands(dst_height, threads,
+        [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t y = begin; y < end; ++y)
+            {
+                // every row starts exactly, so the steps can not drift further than one row
+                const Affine::V2d first = inverse.map(Affine::V2d(.5, y + .5)) - start;
+                int64_t pos_x = std::llround(first.x * WarpOne);
+                int64_t pos_y = std::llround(first.y * WarpOne);
+                RGBA *out = dst + y * dst_stride;
+
+                for (int64_t x = 0; x < dst_width; ++x, pos_x += step_x, pos_y += step_y)
+                {
+                    const int64_t px = (pos_x + inside) >> WarpShift;
+                    const int64_t py = (pos_y + inside) >> WarpShift;
+
+                    if ((px < 0) || (px >= src_width) || (py < 0) || (py >= src_height))
+                        out[x] = background;
+                    else if (!interpolate)
+                        out[x] = src[py * src_stride + px];
+                    else
+                        out[x].value = warpPixel(src, src_width, src_height, src_stride, pos_x,
+                                                 pos_y);
+                }
+            }
+        });
+    }
+
+    void halveRow(const RGBA *top, const RGBA *bottom, RGBA *out, const int64_t width) noexcept
+    {
+#if defined __x86_64__
+        if (hasAvx2())
+            avx2Halve(top, bottom, out, 0, width);
+        else
+            sse2Halve(top, bottom, out, 0, width);
+#else
+        scalarHalve(top, bottom, out, 0, width);
+#endif
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include "Affine.hxx"
+#include "Base.hxx"
+
+namespace Image::Detail
+{
+    using RGBA = Base::RGBA;
+
+    // resamples with one of the separable filters (Bilinear, Bicubic, Lanczos3, Area), the weights
+    // of all output columns and rows are computed once and the output rows are done in bands, the
+    // rows of both images are their stride pixels apart
+    void resample(const RGBA *src, const int64_t src_width, const int64_t src_height,
+                  const int64_t src_stride, RGBA *dst, const int64_t dst_width,
+                  const int64_t dst_height, const int64_t dst_stride, const Scaler scaler,
+                  const int64_t threads) noexcept(false);
+
+    // interpolates between the four nearest source pixels with 16 bit fixed point fractions, this
+    // is point sampling and not filtering, so it is fast but aliases when reducing a lot
+    void bilinear(const RGBA *src, const int64_t src_width, const int64_t src_height,
+                  const int64_t src_stride, RGBA *dst, const int64_t dst_width,
+                  const int64_t dst_height, const int64_t dst_stride, const int64_t threads)
+        noexcept(false);
+
+    // maps the center of every output pixel back into the source with the inverse of an affine
+    // transform, only the first pixel of a row is mapped, the others step by fixed point
+    // increments, so there is no matrix multiply per pixel, the nearest source pixel is taken or
+    // the four around the position are interpolated like bilinear() does, positions outside of the
+    // source get the background, the output rows are done in bands
+    void warp(const RGBA *src, const int64_t src_width, const int64_t src_height,
+              const int64_t src_stride, RGBA *dst, const int64_t dst_width,
+              const int64_t dst_height, const int64_t dst_stride, const Affine &inverse,
+              const bool interpolate, const RGBA background, const int64_t threads)
+        noexcept(false);
+
+    // halves two source rows into one output row of the given width with a rounded 2x2 box
+    void halveRow(const RGBA *top, const RGBA *bottom, RGBA *out, const int64_t width) noexcept;
+}
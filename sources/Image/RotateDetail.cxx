@@ -0,0 +1,283 @@
+#if defined __x86_64__
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include "Common/ThreadPool.hxx"
+#include "RotateDetail.hxx"
+
+namespace Image::Detail
+{
+    //--- internal stuff ---
+
+    constexpr int64_t Block = 16;
+    constexpr int64_t Step = 4;
+
+    //
+    // four rows of four pixels become four columns, out[i] is where the column of source pixel i
+    // goes in the destination, reversed writes it from the bottom up
+    //
+    static inline void transpose4x4(const uint64_t *in, const int64_t stride,
+                                    uint64_t *const out[Step], const bool reversed) noexcept
+    {
+#if defined __x86_64__
+        const __m128i *r0 = reinterpret_cast<const __m128i *>(in);
+        const __m128i *r1 = reinterpret_cast<const __m128i *>(in + stride);
+        const __m128i *r2 = reinterpret_cast<const __m128i *>(in + 2 * stride);
+        const __m128i *r3 = reinterpret_cast<const __m128i *>(in + 3 * stride);
+        const __m128i a0 = _mm_loadu_si128(r0);
+        const __m128i a1 = _mm_loadu_si128(r0 + 1);
+        const __m128i b0 = _mm_loadu_si128(r1);
+        const __m128i b1 = _mm_loadu_si128(r1 + 1);
+        const __m128i c0 = _mm_loadu_si128(r2);
+        const __m128i c1 = _mm_loadu_si128(r2 + 1);
+        const __m128i d0 = _mm_loadu_si128(r3);
+        const __m128i d1 = _mm_loadu_si128(r3 + 1);
+        __m128i *o0 = reinterpret_cast<__m128i *>(out[0]);
+        __m128i *o1 = reinterpret_cast<__m128i *>(out[1]);
+        __m128i *o2 = reinterpret_cast<__m128i *>(out[2]);
+        __m128i *o3 = reinterpret_cast<__m128i *>(out[3]);
+
+        // swapping the operands of the unpacks reverses the pairs without another shuffle
+        if (!reversed)
+        {
+            _mm_storeu_si128(o0, _mm_unpacklo_epi64(a0, b0));
+            _mm_storeu_si128(o0 + 1, _mm_unpacklo_epi64(c0, d0));
+            _mm_storeu_si128(o1, _mm_unpackhi_epi64(a0, b0));
+            _mm_storeu_si128(o1 + 1, _mm_unpackhi_epi64(c0, d0));
+            _mm_storeu_si128(o2, _mm_unpacklo_epi64(a1, b1));
+            _mm_storeu_si128(o2 + 1, _mm_unpacklo_epi64(c1, d1));
+            _mm_storeu_si128(o3, _mm_unpackhi_epi64(a1, b1));
+            _mm_storeu_si128(o3 + 1, _mm_unpackhi_epi64(c1, d1));
+        }
+        else
+        {
+            _mm_storeu_si128(o0, _mm_unpacklo_epi64(d0, c0));
+            _mm_storeu_si128(o0 + 1, _mm_unpacklo_epi64(b0, a0));
+            _mm_storeu_si128(o1, _mm_unpackhi_epi64(d0, c0));
+            _mm_storeu_si128(o1 + 1, _mm_unpackhi_epi64(b0, a0));
+            _mm_storeu_si128(o2, _mm_unpacklo_epi64(d1, c1));
+            _mm_storeu_si128(o2 + 1, _mm_unpacklo_epi64(b1, a1));
+            _mm_storeu_si128(o3, _mm_unpackhi_epi64(d1, c1));
+            _mm_storeu_si128(o3 + 1, _mm_unpackhi_epi64(b1, a1));
+        }
+#else
+        for (int64_t i = 0; i < Step; ++i)
+            for (int64_t j = 0; j < Step; ++j)
+                out[i][reversed ? Step - 1 - j : j] = in[j * stride + i];
+#endif
+    }
+
+    static inline void transpose4x4(const uint32_t *in, const int64_t stride,
+                                    uint32_t *const out[Step], const bool reversed) noexcept
+    {
+#if defined __x86_64__
+        const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+        const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + stride));
+        const __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * stride));
+        const __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 3 * stride));
+        const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+        const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+        const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+        const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+        __m128i columns[Step] = {_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+                                 _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3)};
+
+        for (int64_t i = 0; i < Step; ++i)
+        {
+            if (reversed)
+                columns[i] = _mm_shuffle_epi32(columns[i], 0x1B);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out[i]), columns[i]);
+        }
+#else
+        for (int64_t i = 0; i < Step; ++i)
+            for (int64_t j = 0; j < Step; ++j)
+                out[i][reversed ? Step - 1 - j : j] = in[j * stride + i];
+#endif
+    }
+
+    // the scratch buffer of a row swap, the rows pass through it piece by piece
+    constexpr int64_t ScratchBytes = 4096;
+
+    template <typename Word>
+    static inline void swapRows(Word *top, Word *bottom, const int64_t width) noexcept
+    {
+        constexpr int64_t Scratch = ScratchBytes / sizeof (Word);
+        Word scratch[Scratch];
+
+        for (int64_t x = 0; x < width; x += Scratch)
+        {
+            const size_t bytes = std::min(Scratch, width - x) * sizeof (Word);
+
+            std::memcpy(scratch, top + x, bytes);
+            std::memcpy(top + x, bottom + x, bytes);
+            std::memcpy(bottom + x, scratch, bytes);
+        }
+    }
+
+#if defined __x86_64__
+    static inline __m128i reverseLanes(const __m128i words, const uint64_t *) noexcept
+    {
+        return _mm_shuffle_epi32(words, 0x4E);
+    }
+
+    static inline __m128i reverseLanes(const __m128i words, const uint32_t *) noexcept
+    {
+        return _mm_shuffle_epi32(words, 0x1B);
+    }
+#endif
+
+    template <typename Word>
+    static inline void mirrorRow(Word *row, const int64_t width) noexcept
+    {
+        Word *left = row;
+        Word *right = row + width;
+
+#if defined __x86_64__
+        constexpr int64_t Lanes = sizeof (__m128i) / sizeof (Word);
+
+        // the outer pixels are swapped a register at a time, what is left in the middle is less
+        // than two registers and reversed as before
+        while (right - left >= 2 * Lanes)
+        {
+            right -= Lanes;
+
+            const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left));
+            const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(left), reverseLanes(tail, left));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(right), reverseLanes(head, left));
+            left += Lanes;
+        }
+#endif
+        std::reverse(left, right);
+    }
+
+    template <typename Word>
+    static void flipRows(Word *pixels, const int64_t width, const int64_t height,
+                         const int64_t stride, const int64_t threads) noexcept(false)
+    {
+        Common::ThreadPool::global().runBands(height / 2, threads,
+            [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t y = begin; y < end; ++y)
+                swapRows(pixels + y * stride, pixels + (height - 1 - y) * stride, width);
+        });
+    }
+
+    template <typename Word>
+    static void mirrorRows(Word *pixels, const int64_t width, const int64_t height,
+                           const int64_t stride, const int64_t threads) noexcept(false)
+    {
+        Common::ThreadPool::global().runBands(height, threads,
+            [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t y = begin; y < end; ++y)
+                mirrorRow(pixels + y * stride, width);
+        });
+    }
+
+    template <typename Word>
+    static void transposeBlocks(const Word *src, const int64_t width, const int64_t height,
+                                const int64_t src_stride, Word *dst, const int64_t dst_stride,
+                                const bool mirror_rows, const bool mirror_columns,
+                                const int64_t threads) noexcept(false)
+    {
+        // the destination row of source column x and the destination column of source row y
+        auto target_row = [&](const int64_t x)
+        {
+            return dst + (mirror_rows ? width - 1 - x : x) * dst_stride;
+        };
+        auto target_column = [&](const int64_t y)
+        {
+            return mirror_columns ? height - 1 - y : y;
+        };
+
+        const int64_t blocks = (height + Block - 1) / Block;
+
+        Common::ThreadPool::global().runBands(blocks, threads,
+            [&](const int64_t begin, const int64_t end)
+        {
+            for (int64_t y0 = begin * Block; y0 < std::min(end * Block, height); y0 += Block)
+            {
+                const int64_t y1 = std::min(y0 + Block, height);
+                const int64_t full_y = y0 + (y1 - y0) / Step * Step;
+
+                for (int64_t x0 = 0; x0 < width; x0 += Block)
+                {
+                    const int64_t x1 = std::min(x0 + Block, width);
+                    const int64_t full_x = x0 + (x1 - x0) / Step * Step;
+
+                    for (int64_t y = y0; y < full_y; y += Step)
+                    {
+                        // a reversed column starts at the row that is last in the source
+                        const int64_t column = target_column(mirror_columns ? y + Step - 1 : y);
+
+                        for (int64_t x = x0; x < full_x; x += Step)
+                        {
+                            Word *const out[Step] = {target_row(x) + column,
+                                                     target_row(x + 1) + column,
+                                                     target_row(x + 2) + column,
+                                                     target_row(x + 3) + column};
+
+                            transpose4x4(src + y * src_stride + x, src_stride, out,
+                                         mirror_columns);
+                        }
+
+                        for (int64_t yy = y; yy < y + Step; ++yy)
+                            for (int64_t x = full_x; x < x1; ++x)
+                                target_row(x)[target_column(yy)] = src[yy * src_stride + x];
+                    }
+
+                    for (int64_t y = full_y; y < y1; ++y)
+                        for (int64_t x = x0; x < x1; ++x)
+                            target_row(x)[target_column(y)] = src[y * src_stride + x];
+                }
+            }
+        });
+    }
+
+    //--- public functions ---
+
+    void transposeWords(const uint64_t *src, const int64_t width, const int64_t height,
+                        const int64_t src_stride, uint64_t *dst, const int64_t dst_stride,
+                        const bool mirror_rows, const bool mirror_columns, const int64_t threads)
+        noexcept(false)
+    {
+        transposeBlocks(src, width, height, src_stride, dst, dst_stride, mirror_rows,
+                        mirror_columns, threads);
+    }
+
+    void transposeWords(const uint32_t *src, const int64_t width, const int64_t height,
+                        const int64_t src_stride, uint32_t *dst, const int64_t dst_stride,
+                        const bool mirror_rows, const bool mirror_columns, const int64_t threads)
+        noexcept(false)
+    {
+        transposeBlocks(src, width, height, src_stride, dst, dst_stride, mirror_rows,
+                        mirror_columns, threads);
+    }
+
+    void flipVerticalWords(uint64_t *pixels, const int64_t width, const int64_t height,
+                           const int64_t stride, const int64_t threads) noexcept(false)
+    {
+        flipRows(pixels, width, height, stride, threads);
+    }
+
+    void flipVerticalWords(uint32_t *pixels, const int64_t width, const int64_t height,
+                           const int64_t stride, const int64_t threads) noexcept(false)
+    {
+        flipRows(pixels, width, height, stride, threads);
+    }
+
+    void flipHorizontalWords(uint64_t *pixels, const int64_t width, const int64_t height,
+                             const int64_t stride, const int64_t threads) noexcept(false)
+    {
+        mirrorRows(pixels, width, height, stride, threads);
+    }
+
+    void flipHorizontalWords(uint32_t *pixels, const int64_t width, const int64_t height,
+                             const int64_t stride, const int64_t threads) noexcept(false)
+    {
+        mirrorRows(pixels, width, height, stride, threads);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace Image::Detail
+{
+    //
+    // the quarter turns and the transpose write the pixels of a source into a destination of the
+    // swapped size, both are walked in blocks of 16x16 pixels, so only a few cache lines of each
+    // are in use at a time, and inside a block 4x4 pixels are transposed in registers
+    //
+    // - mirror_rows turns the transpose into a rotation by 270 degrees (the first column of the
+    //   source becomes the last row), mirror_columns into one by 90 degrees (the first row of the
+    //   source becomes the last column)
+    // - the pixels are only moved, so they are handled as words of their size, which makes the
+    //   same code work for the 8 byte pixels of Base and the 4 byte pixels of Compact
+    // - the bands of source rows run on the thread pool, source and destination must not overlap
+    //
+    void transposeWords(const uint64_t *src, const int64_t width, const int64_t height,
+                        const int64_t src_stride, uint64_t *dst, const int64_t dst_stride,
+                        const bool mirror_rows, const bool mirror_columns, const int64_t threads)
+        noexcept(false);
+    void transposeWords(const uint32_t *src, const int64_t width, const int64_t height,
+                        const int64_t src_stride, uint32_t *dst, const int64_t dst_stride,
+                        const bool mirror_rows, const bool mirror_columns, const int64_t threads)
+        noexcept(false);
+
+    template <typename Pixel>
+    inline void transpose(const Pixel *src, const int64_t width, const int64_t height,
+                          const int64_t src_stride, Pixel *dst, const int64_t dst_stride,
+                          const bool mirror_rows, const bool mirror_columns,
+                          const int64_t threads = 1) noexcept(false)
+    {
+        static_assert((sizeof (Pixel) == 8) || (sizeof (Pixel) == 4), "pixels of 4 or 8 bytes");
+        using Word = std::conditional_t<sizeof (Pixel) == 8, uint64_t, uint32_t>;
+
+        transposeWords(reinterpret_cast<const Word *>(src), width, height, src_stride,
+                       reinterpret_cast<Word *>(dst), dst_stride, mirror_rows, mirror_columns,
+                       threads);
+    }
+
+    //
+    // the flips stay in place and touch every pixel once, the rows are split over the threads
+    //
+    // - flipVertical turns the image upside down, it swaps the top and the bottom rows with
+    //   memcpy through a scratch buffer that stays in the first level cache
+    // - flipHorizontal mirrors every row, both ends of a row are reversed in registers and stored
+    //   at the other end
+    //
+    void flipVerticalWords(uint64_t *pixels, const int64_t width, const int64_t height,
+                           const int64_t stride, const int64_t threads) noexcept(false);
+    void flipVerticalWords(uint32_t *pixels, const int64_t width, const int64_t height,
+                           const int64_t stride, const int64_t threads) noexcept(false);
+    void flipHorizontalWords(uint64_t *pixels, const int64_t width, const int64_t height,
+                             const int64_t stride, const int64_t threads) noexcept(false);
+    void flipHorizontalWords(uint32_t *pixels, const int64_t width, const int64_t height,
+                             const int64_t stride, const int64_t threads) noexcept(false);
+
+    template <typename Pixel>
+    inline void flipVertical(Pixel *pixels, const int64_t width, const int64_t height,
+                             const int64_t stride, const int64_t threads = 1) noexcept(false)
+    {
+        static_assert((sizeof (Pixel) == 8) || (sizeof (Pixel) == 4), "pixels of 4 or 8 bytes");
+        using Word = std::conditional_t<sizeof (Pixel) == 8, uint64_t, uint32_t>;
+
+        flipVerticalWords(reinterpret_cast<Word *>(pixels), width, height, stride, threads);
+    }
+
+    template <typename Pixel>
+    inline void flipHorizontal(Pixel *pixels, const int64_t width, const int64_t height,
+                               const int64_t stride, const int64_t threads = 1) noexcept(false)
+    {
+        static_assert((sizeof (Pixel) == 8) || (sizeof (Pixel) == 4), "pixels of 4 or 8 bytes");
+        using Word = std::conditional_t<sizeof (Pixel) == 8, uint64_t, uint32_t>;
+
+        flipHorizontalWords(reinterpret_cast<Word *>(pixels), width, height, stride, threads);
+    }
+
+    // half a turn stays in place, the rows from the top and the bottom swap their mirrored pixels
+    // in one pass, the middle row of an odd height is only mirrored
+    template <typename Pixel>
+    inline void rotate180(Pixel *pixels, const int64_t width, const int64_t height,
+                          const int64_t stride) noexcept
+    {
+        for (int64_t y = 0; y < height / 2; ++y)
+        {
+            Pixel *bottom = pixels + (height - 1 - y) * stride;
+
+            std::swap_ranges(pixels + y * stride, pixels + y * stride + width,
+                             std::reverse_iterator<Pixel *>(bottom + width));
+        }
+
+        if (height % 2)
+            std::reverse(pixels + height / 2 * stride, pixels + height / 2 * stride + width);
+    }
+}
@@ -39,6 +39,15 @@ namespace Image
             implReplace(pixels, width, height);
     }
 
+    Simple00::Simple00(const Base &image) noexcept(false)
+    : Base()
+    {
+        // the pixels are shared until one of both images changes them
+        if (T::inRange(image.width(), MinWidth, MaxWidth) &&
+          T::inRange(image.height(), MinHeight, MaxHeight))
+            implShare(image);
+    }
+
     Simple00::Simple00(const Simple00 &rhs) noexcept(false)
     : Base(rhs)
     {
@@ -87,7 +96,8 @@ namespace Image
     {
         return T::inRange(width(), MinWidth, MaxWidth) &&
                T::inRange(height(), MinHeight, MaxHeight) &&
-               (static_cast<uint64_t>(pixels().size()) == static_cast<uint64_t>(width() * height()));
+               (static_cast<uint64_t>(implData().size()) ==
+                static_cast<uint64_t>(width() * height()));
     }
 
     bool Simple00::resize(const int64_t width, const int64_t height, const Scaler scaler)
@@ -103,6 +113,7 @@ namespace Image
     {
         if (std::ofstream ofile(filename); valid() && ofile.is_open() && ofile.good())
         {
+            const auto rows = implRows();
             E::Union32 tmp;
 
             ofile.write("simple00", 8);
@@ -112,7 +123,7 @@ namespace Image
             tmp.u = height();
             tmp.u = E::toBE(tmp.u);
             ofile.put(tmp.c1).put(tmp.c2).put(tmp.c3).put(tmp.c4);
-            for (const auto &pixel : pixels())
+            for (const auto &pixel : *rows)
             {
                 ofile.put(pixel.c1).put(pixel.c2).put(pixel.c3).put(pixel.c4).put(pixel.c5)
                      .put(pixel.c6).put(pixel.c7).put(pixel.c8);
@@ -131,7 +142,7 @@ namespace Image
         {
             const uint64_t size = ifile.seekg(0, std::ios::end).tellg();
             std::string id(8, '\0');
-            Pixels pixels;
+            Pixels pixels(memoryResource());
             E::Union32 width;
             E::Union32 height;
 
@@ -169,7 +180,7 @@ namespace Image
             }
             ifile.close();
 
-            implReplace(pixels, width.u, height.u);
+            implReplace(std::move(pixels), width.u, height.u);
 
             return true;
         }
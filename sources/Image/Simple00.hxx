@@ -31,6 +31,7 @@ namespace Image
         Simple00(const int64_t width, const int64_t height, const RGBA color = RGBA::Black)
             noexcept(false);
         Simple00(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        explicit Simple00(const Base &image) noexcept(false);
         Simple00(const Simple00 &rhs) noexcept(false);
         Simple00(Simple00 &&rhs) noexcept;
         virtual ~Simple00() noexcept;
@@ -38,6 +38,15 @@ namespace Image
             implReplace(pixels, width, height);
     }
 
+    Simple01::Simple01(const Base &image) noexcept(false)
+    : Base()
+    {
+        // the pixels are shared until one of both images changes them
+        if (T::inRange(image.width(), MinWidth, MaxWidth) &&
+          T::inRange(image.height(), MinHeight, MaxHeight))
+            implShare(image);
+    }
+
     Simple01::Simple01(const Simple01 &rhs) noexcept(false)
     : Base(rhs)
     {
@@ -86,7 +95,8 @@ namespace Image
     {
         return T::inRange(width(), MinWidth, MaxWidth) &&
                T::inRange(height(), MinHeight, MaxHeight) &&
-               (static_cast<uint64_t>(pixels().size()) == static_cast<uint64_t>(width() * height()));
+               (static_cast<uint64_t>(implData().size()) ==
+                static_cast<uint64_t>(width() * height()));
     }
 
     bool Simple01::resize(const int64_t width, const int64_t height, const Scaler scaler)
@@ -102,7 +112,7 @@ namespace Image
     {
         if (std::ofstream ofile(filename); valid() && ofile.is_open() && ofile.good())
         {
-            const std::string data(encodeRLE(pixels()));
+            const std::string data(encodeRLE(*implRows()));
             E::Union64 size = {.u = data.size()};
             E::Union32 tmp;
 
@@ -132,7 +142,7 @@ namespace Image
             const uint64_t size = ifile.seekg(0, std::ios::end).tellg();
             std::string id(8, '\0');
             std::string buffer;
-            Pixels pixels;
+            Pixels pixels(memoryResource());
             E::Union64 dsize;
             E::Union32 width;
             E::Union32 height;
@@ -178,7 +188,7 @@ namespace Image
             if (pixels.size() != (static_cast<size_t>(width.u) * static_cast<size_t>(height.u)))
                 return false;
 
-            implReplace(pixels, width.u, height.u);
+            implReplace(std::move(pixels), width.u, height.u);
 
             return true;
         }
@@ -296,7 +306,7 @@ namespace Image
     Simple01::Pixels Simple01::decodeRLE(const std::string &data) const noexcept(false)
     {
         const size_t size = data.size();
-        Pixels result;
+        Pixels result(memoryResource());
         size_t pos = 0;
 
         while (pos < (size - 1))
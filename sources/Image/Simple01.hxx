@@ -30,6 +30,7 @@ namespace Image
         Simple01(const int64_t width, const int64_t height, const RGBA color = RGBA::Black)
             noexcept(false);
         Simple01(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        explicit Simple01(const Base &image) noexcept(false);
         Simple01(const Simple01 &rhs) noexcept(false);
         Simple01(Simple01 &&rhs) noexcept;
         virtual ~Simple01() noexcept;
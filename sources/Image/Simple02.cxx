@@ -41,6 +41,15 @@ namespace Image
             implReplace(pixels, width, height);
     }
 
+    Simple02::Simple02(const Base &image) noexcept(false)
+    : Base()
+    {
+        // the pixels are shared until one of both images changes them
+        if (T::inRange(image.width(), MinWidth, MaxWidth) &&
+          T::inRange(image.height(), MinHeight, MaxHeight))
+            implShare(image);
+    }
+
     Simple02::Simple02(const Simple02 &rhs) noexcept(false)
     : Base(rhs)
     {
@@ -89,7 +98,8 @@ namespace Image
     {
         return T::inRange(width(), MinWidth, MaxWidth) &&
                T::inRange(height(), MinHeight, MaxHeight) &&
-               (static_cast<uint64_t>(pixels().size()) == static_cast<uint64_t>(width() * height()));
+               (static_cast<uint64_t>(implData().size()) ==
+                static_cast<uint64_t>(width() * height()));
     }
 
     bool Simple02::resize(const int64_t width, const int64_t height, const Scaler scaler)
@@ -105,13 +115,14 @@ namespace Image
     {
         if (std::ofstream ofile(filename); valid() && ofile.is_open() && ofile.good())
         {
+            const auto rows = implRows();
             C::LZW16 lzw;
             std::stringstream in;
             std::stringstream out;
             E::Union64 size;
             E::Union32 tmp;
 
-            for (const auto &pixel : pixels())
+            for (const auto &pixel : *rows)
             {
                 in << pixel.c1 << pixel.c2 << pixel.c3 << pixel.c4 << pixel.c5 << pixel.c6
                    << pixel.c7 << pixel.c8;
@@ -148,7 +159,7 @@ namespace Image
             std::string id(8, '\0');
             std::stringstream in;
             std::stringstream out;
-            Pixels pixels;
+            Pixels pixels(memoryResource());
             E::Union64 dsize;
             E::Union32 width;
             E::Union32 height;
@@ -202,7 +213,7 @@ namespace Image
                    .get(pixel.c6).get(pixel.c7).get(pixel.c8);
             }
 
-            implReplace(pixels, width.u, height.u);
+            implReplace(std::move(pixels), width.u, height.u);
 
             return true;
         }
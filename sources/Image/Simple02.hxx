@@ -27,6 +27,7 @@ namespace Image
         Simple02(const int64_t width, const int64_t height, const RGBA color = RGBA::Black)
             noexcept(false);
         Simple02(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        explicit Simple02(const Base &image) noexcept(false);
         Simple02(const Simple02 &rhs) noexcept(false);
         Simple02(Simple02 &&rhs) noexcept;
         virtual ~Simple02() noexcept;
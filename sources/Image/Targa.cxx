@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
-#include <map>
 #include <stdexcept>
 #include "Color/Dithering.hxx"
 #include "Common/Endian.hxx"
 #include "Common/Tools.hxx"
+#include "Compact.hxx"
+#include "Indexed.hxx"
+#include "PixelDetail.hxx"
 #include "Targa.hxx"
 
 namespace Image
@@ -12,14 +15,17 @@ namespace Image
     //--- internal stuff ---
 
     namespace C = Color;
+    namespace D = Detail;
     namespace E = Common::Endian;
-    namespace Q = C::Quantize;
     namespace T = Common::Tools;
     using IT = Targa::ImageType;
     using IA = Targa::ImageAttribute;
 
     const std::string Signature("\0\0\0\0\0\0\0\0TRUEVISION-XFILE.\0");
     const uint16_t MaxU16 = std::numeric_limits<uint16_t>::max();
+    // max palette size is 8192 bytes, so it could be 2048 32bit colors or 4096 15/16bit colors
+    // but I never came across a Targa with more the 256 mapped colors
+    const int64_t MaxMappedColors = 256;
 
     //--- public constructors ---
 
@@ -61,6 +67,18 @@ namespace Image
             implReplace(pixels, width, height);
     }
 
+    Targa::Targa(const Base &image) noexcept(false)
+    : Base(), _colormap_type(0), _image_type(IT::Truecolor), _colormap_offset(0),
+      _colormap_length(0), _colormap_entry_size(0), _x_origin(0), _y_origin(0), _depth(24),
+      _image_descriptor(T::valueOf(IA::OriginTop)), _image_id(""), _version2(false),
+      _greyscale(false)
+    {
+        // the pixels are shared until one of both images changes them
+        if (T::inRange(image.width(), MinWidth, MaxWidth) &&
+          T::inRange(image.height(), MinHeight, MaxHeight))
+            implShare(image);
+    }
+
     Targa::Targa(const Targa &rhs) noexcept(false)
     : Base(rhs), _colormap_type(rhs._colormap_type), _image_type(rhs._image_type),
       _colormap_offset(rhs._colormap_offset), _colormap_length(rhs._colormap_length),
@@ -376,7 +394,8 @@ namespace Image
     {
         return T::inRange(width(), MinWidth, MaxWidth) &&
                T::inRange(height(), MinHeight, MaxHeight) &&
-               (static_cast<uint64_t>(width() * height()) == static_cast<uint64_t>(pixels().size()));
+               (static_cast<uint64_t>(width() * height()) ==
+                static_cast<uint64_t>(implData().size()));
     }
 
     bool Targa::resize(const int64_t width, const int64_t height, const Scaler scaler)
@@ -390,239 +409,135 @@ namespace Image
 
     bool Targa::save(const std::string &filename) const noexcept(false)
     {
-        if (std::ofstream ofile(filename); valid() && ofile.is_open() && ofile.good())
+        std::string data;
+
+        if (!valid())
+            return false;
+
+        const auto rows = implRows();
+
+        switch (_image_type)
         {
-            std::string data;
-            Pixels palette;
-            E::Union16 tmp16;
-            E::Union8 tmp8;
+            case IT::NoData:
+                break;
 
-            switch (_image_type)
-            {
-                case IT::NoData:
-                    break;
+            // the mapped types quantize once and write the indices, the pixels are looked at row
+            // by row, just like the other writers do
+            case IT::Mapped:
+            case IT::MappedRLE:
+                return saveIndexed(filename, Indexed<uint8_t>(ImageView(rows->data(), width(),
+                                   height(), width()), MaxMappedColors));
 
-                case IT::Mapped:
-                    data = genMappedData(palette, pixels());
-                    break;
+            case IT::Truecolor:
+                data = genTruecolorData(*rows);
+                break;
 
-                case IT::Truecolor:
-                    data = genTruecolorData(pixels());
-                    break;
+            case IT::Mono:
+                data = genMonoData(*rows);
+                break;
 
-                case IT::Mono:
-                    data = genMonoData(pixels());
-                    break;
+            case IT::TruecolorRLE:
+                data = genTruecolorRleData(*rows);
+                break;
 
-                case IT::MappedRLE:
-                    data = genMappedRleData(palette, pixels());
-                    break;
+            case IT::MonoRLE:
+                data = genMonoRleData(*rows);
+                break;
 
-                case IT::TruecolorRLE:
-                    data = genTruecolorRleData(pixels());
-                    break;
+            // this one shouldn't happen anyway, it can't be set
+            case IT::MappedAll:
+            case IT::MappedAllQuad:
+                throw std::logic_error("propreitary image type not supported");
+        }
 
-                case IT::MonoRLE:
-                    data = genMonoRleData(pixels());
-                    break;
+        return implSave(filename, width(), height(), data, {});
+    }
 
-                // this one shouldn't happen anyway, it can't be set
-                case IT::MappedAll:
-                case IT::MappedAllQuad:
-                    throw std::logic_error("propreitary image type not supported");
-            }
+    bool Targa::saveIndexed(const std::string &filename, const Indexed<uint8_t> &image) const
+        noexcept(false)
+    {
+        if (!T::inRange(image.width(), MinWidth, MaxWidth) ||
+          !T::inRange(image.height(), MinHeight, MaxHeight))
+            return false;
 
-            // header
-            tmp8.u = _image_id.size();
-            ofile.put(tmp8.c1);
-            tmp8.u = _colormap_type;
-            ofile.put(tmp8.c1);
-            tmp8.u = T::valueOf(_image_type);
-            ofile.put(tmp8.c1);
-            tmp16.u = _colormap_offset;
-            ofile.put(tmp16.c1).put(tmp16.c2);
-            tmp16.u = _colormap_length;
-            ofile.put(tmp16.c1).put(tmp16.c2);
-            tmp8.u = _colormap_entry_size;
-            ofile.put(tmp8.c1);
-            tmp16.u = _x_origin;
-            ofile.put(tmp16.c1).put(tmp16.c2);
-            tmp16.u = _y_origin;
-            ofile.put(tmp16.c1).put(tmp16.c2);
-            tmp16.u = width();
-            ofile.put(tmp16.c1).put(tmp16.c2);
-            tmp16.u = height();
-            ofile.put(tmp16.c1).put(tmp16.c2);
-            tmp8.u = _depth;
-            ofile.put(tmp8.c1);
-            tmp8.u = _image_descriptor;
-            ofile.put(tmp8.c1);
-            if (!_image_id.empty())
-            {
-                ofile.write(_image_id.c_str(), _image_id.size());
-                ofile.put('\0');
-            }
+        if (image.palette().empty() && !image.indices().empty())
+            return false;
 
-            // image palette
-            if (_colormap_type && (_colormap_length == palette.size()))
-            {
-                std::string palette_data;
+        if ((_image_type != IT::Mapped) && (_image_type != IT::MappedRLE))
+        {
+            // the pixels are shared, the copy only gets the settings of a mapped type
+            Targa mapped(*this);
 
-                switch (_colormap_entry_size)
-                {
-                    case 15:
-                    case 16:
-                    {
-                        const bool alpha_bit = _image_descriptor & 0x01;
-                        C::UnionRGBA5551 tmp;
+            mapped.setImageType(IT::Mapped);
 
-                        palette_data.reserve(_colormap_length * 2);
-                        for (const auto &pixel : palette)
-                        {
-                            // this is weird, the colors in the palette are different from the
-                            // format used in pure pixel data
-                            tmp.u = 0;
-                            tmp.u |= (pixel.rh >> 3) << 10;
-                            tmp.u |= (pixel.gh >> 3) << 5;
-                            tmp.u |= (pixel.bh >> 3);
-                            tmp.u |= (alpha_bit && static_cast<bool>(pixel.a)) << 15;
-                            palette_data += tmp.c2;
-                            palette_data += tmp.c1;
-                        }
+            return mapped.saveIndexed(filename, image);
+        }
 
-                        break;
-                    }
+        const std::string data = _image_type == IT::Mapped ? genMappedData(image) :
+                                                             genMappedRleData(image);
 
-                    case 24:
-                    {
-                        palette_data.reserve(_colormap_length * 3);
-                        for (const auto &pixel : palette)
-                        {
-                            palette_data += pixel.c5;
-                            palette_data += pixel.c3;
-                            palette_data += pixel.c1;
-                        }
+        return implSave(filename, image.width(), image.height(), data, image.palette());
+    }
 
-                        break;
-                    }
+    bool Targa::load(const std::string &filename) noexcept(false)
+    {
+        Pixels pixels(memoryResource());
+        Header header;
 
-                    case 32:
-                    {
-                        palette_data.reserve(_colormap_length * 4);
-                        for (const auto &pixel : palette)
-                        {
-                            palette_data += pixel.c5;
-                            palette_data += pixel.c3;
-                            palette_data += pixel.c1;
-                            palette_data += pixel.c7;
-                        }
+        if (!implLoad(filename, pixels, header))
+            return false;
 
-                        break;
-                    }
-                }
-                ofile.write(palette_data.c_str(), palette_data.size());
-            }
+        implReplace(std::move(pixels), header.width, header.height);
 
-            // image data
-            ofile.write(data.c_str(), data.size());
+        return true;
+    }
 
-            // footer
-            if (_version2)
-                ofile.write(Signature.c_str(), Signature.size());
+    bool Targa::loadCompact(const std::string &filename, Compact &image) noexcept(false)
+    {
+        Compact::Pixels pixels(image.memoryResource());
+        Header header;
 
-            ofile.close();
+        if (!implLoad(filename, pixels, header))
+            return false;
 
-            return true;
-        }
+        image = Compact(std::move(pixels), header.width, header.height);
 
-        return false;
+        return true;
     }
 
-    bool Targa::load(const std::string &filename) noexcept(false)
+    bool Targa::loadIndexed(const std::string &filename, Indexed<uint8_t> &image)
+        noexcept(false)
     {
         if (std::ifstream ifile(filename); ifile.is_open() && ifile.good())
         {
-            const uint64_t size = ifile.seekg(0, std::ios::end).tellg();
-            Pixels pixels;
-            std::string id;
-            std::string palette;
             Header header;
-            Footer footer;
+            std::string id;
             bool version2;
 
-            if (size < sizeof (header))
-            {
-                ifile.close();
+            if (!implReadHeader(ifile, header, id, version2))
                 return false;
-            }
-
-            ifile.seekg(size - sizeof (footer), std::ios::beg);
-            ifile.read(reinterpret_cast<char *>(&footer), sizeof (footer));
-            ifile.seekg(0, std::ios::beg);
-            ifile.read(reinterpret_cast<char *>(&header), sizeof (header));
-
-            if (header.id)
-            {
-                id.resize(header.id, '\0');
-                ifile.read(id.data(), id.size());
-            }
-
-            if (std::string(footer.signature).substr(0, Signature.size()) == Signature)
-                version2 = true;
-            else
-                version2 = false;
-
-            switch (header.image_type)
-            {
-                // nothing to do here
-                case IT::NoData:
-                    break;
-
-                case IT::Mapped:
-                    pixels = loadMappedData(ifile, header);
-                    break;
-
-                case IT::Truecolor:
-                    pixels = loadTruecolorData(ifile, header);
-                    break;
-
-                case IT::Mono:
-                    pixels = loadMonoData(ifile, header);
-                    break;
 
-                case IT::MappedRLE:
-                    pixels = loadMappedRleData(ifile, header);
-                    break;
-
-                case IT::TruecolorRLE:
-                    pixels = loadTruecolorRleData(ifile, header);
-                    break;
+            // only the mapped types have indices to keep
+            if ((header.image_type != IT::Mapped) && (header.image_type != IT::MappedRLE))
+                return false;
 
-                case IT::MonoRLE:
-                    pixels = loadMonoRleData(ifile, header);
-                    break;
+            const Indexed<uint8_t>::Palette palette = loadColormap<RGBA>(ifile, header);
+            Indexed<uint8_t>::Indices indices = loadIndices(ifile, header, image.memoryResource());
 
-                case IT::MappedAll:
-                case IT::MappedAllQuad:
-                    throw std::logic_error("propreitary features are not supported");
-            }
             ifile.close();
 
-            if (pixels.size() != (header.width * header.height))
+            if (palette.empty() || (static_cast<int64_t>(palette.size()) > MaxMappedColors))
+                return false;
+            if (indices.size() != static_cast<uint64_t>(header.width * header.height))
+                return false;
+            if (std::any_of(indices.begin(), indices.end(), [&](const uint8_t index)
+                {
+                    return index >= palette.size();
+                }))
                 return false;
 
-            implReplace(pixels, header.width, header.height);
-            _colormap_type = header.colormap_type;
-            _image_type = header.image_type;
-            _colormap_offset = header.colormap_offset;
-            _colormap_length = header.colormap_length;
-            _colormap_entry_size = header.colormap_entry_size;
-            _x_origin = header.x_origin;
-            _y_origin = header.y_origin;
-            _depth = header.depth;
-            _image_descriptor = header.image_descriptor;
-            _image_id = id;
-            _version2 = version2;
+            implApplyHeader(header, id, version2);
+            image = Indexed<uint8_t>(std::move(indices), header.width, header.height, palette);
 
             return true;
         }
@@ -653,32 +568,11 @@ namespace Image
 
     //--- protected methods ---
 
-    std::string Targa::genMappedData(Pixels &palette, const Pixels &pixels) const noexcept(false)
+    std::string Targa::genMappedData(const Indexed<uint8_t> &image) const noexcept(false)
     {
-        // max palette size is 8192 bytes, so it could be 2048 32bit colors or 4096 15/16bit colors
-        // but I never came across a Targa with more the 256 mapped colors
-        const uint64_t MaxColor = 256;
-        Pixels out;
-        std::string data;
-
-        if (Q::middleCut(width(), height(), MaxColor, pixels, out, palette))
-        {
-            std::map<uint64_t,uint64_t> mapping;
-
-            if (pixels.size() != out.size())
-                return data;
-            if (palette.size() != MaxColor)
-                return data;
+        const Indexed<uint8_t>::Indices &indices = image.indices();
 
-            for (uint64_t i = 0; i < palette.size(); ++i)
-                mapping[palette[i].value] = i;
-
-            data.reserve(out.size());
-            for (const auto &pixel : out)
-                data += static_cast<char>(mapping[pixel.value]);
-        }
-
-        return data;
+        return std::string(indices.begin(), indices.end());
     }
 
     std::string Targa::genTruecolorData(const Pixels &pixels) const noexcept(false)
@@ -763,76 +657,27 @@ namespace Image
         return data;
     }
 
-    std::string Targa::genMappedRleData(Pixels &palette, const Pixels &pixels) const noexcept(false)
+    std::string Targa::genMappedRleData(const Indexed<uint8_t> &image) const noexcept(false)
     {
-        const uint64_t MaxColors = 256;
-        Pixels out;
+        const Indexed<uint8_t>::Indices &indices = image.indices();
+        const uint64_t size = indices.size();
+        const std::string tmp(indices.begin(), indices.end());
+        std::vector<uint8_t> buffer;
         std::string data;
+        size_t count = 0;
 
-        if (Color::Quantize::middleCut(width(), height(), MaxColors, pixels, out, palette))
+        if (_version2)
         {
-            const uint64_t size = out.size();
-            std::map<uint64_t,uint64_t> mapping;
-            std::string tmp(size, '\0');
-            std::vector<uint8_t> buffer;
-            size_t count = 0;
-
-            if (pixels.size() != out.size())
-                return data;
-            if (palette.size() != MaxColors)
-                return data;
-
-            for (uint64_t i = 0; i < palette.size(); ++i)
-                mapping[palette[i].value] = i;
-            for (uint64_t i = 0; i < out.size(); ++i)
-                tmp[i] = static_cast<char>(mapping[out[i].value]);
-
-            if (_version2)
+            for (int64_t l = 0; l < image.height(); ++l)
             {
-                for (int64_t l = 0; l < height(); ++l)
-                {
-                    const uint64_t lsize = width();
-                    const uint64_t ppos = l * lsize;
-                    const std::string pline(tmp.begin() + ppos, tmp.begin() + ppos + lsize);
-
-                    for (uint64_t i = 0; i < lsize; ++i)
-                    {
-                        count = 1;
-                        while ((i < (lsize - 1)) && (count < 128) && (pline[i] == pline[i + 1]))
-                        {
-                            ++count;
-                            ++i;
-                        }
-
-                        if ((count > 1) || (buffer.size() >= 128))
-                        {
-                            if (!buffer.empty())
-                            {
-                                data.push_back(static_cast<uint8_t>(buffer.size() - 1));
-                                data.insert(data.end(), buffer.begin(), buffer.end());
-                                buffer.clear();
-                            }
-                            data.push_back(static_cast<uint8_t>((count - 1) | 128));
-                            data += pline[i];
-                        }
-                        else
-                            buffer.push_back(pline[i]);
-                    }
+                const uint64_t lsize = image.width();
+                const uint64_t ppos = l * lsize;
+                const std::string pline(tmp.begin() + ppos, tmp.begin() + ppos + lsize);
 
-                    if (!buffer.empty())
-                    {
-                        data.push_back(static_cast<uint8_t>(buffer.size() - 1));
-                        data.insert(data.end(), buffer.begin(), buffer.end());
-                        buffer.clear();
-                    }
-                }
-            }
-            else
-            {
-                for (uint64_t i = 0; i < size; ++i)
+                for (uint64_t i = 0; i < lsize; ++i)
                 {
                     count = 1;
-                    while ((i < (size - 1)) && (count < 128) && (tmp[i] == tmp[i + 1]))
+                    while ((i < (lsize - 1)) && (count < 128) && (pline[i] == pline[i + 1]))
                     {
                         ++count;
                         ++i;
@@ -847,35 +692,68 @@ namespace Image
                             buffer.clear();
                         }
                         data.push_back(static_cast<uint8_t>((count - 1) | 128));
-                        data += tmp[i];
+                        data += pline[i];
                     }
                     else
-                        buffer.push_back(tmp[i]);
+                        buffer.push_back(pline[i]);
                 }
 
                 if (!buffer.empty())
                 {
                     data.push_back(static_cast<uint8_t>(buffer.size() - 1));
                     data.insert(data.end(), buffer.begin(), buffer.end());
+                    buffer.clear();
                 }
             }
         }
-
-        return data;
-    }
-
-    std::string Targa::genTruecolorRleData(const Pixels &pixels) const noexcept(false)
-    {
-        const uint64_t size = pixels.size();
-        const uint64_t psize = (_depth + 1) / 8;
-        std::vector<uint8_t> buffer;
-        std::string data;
-        uint64_t count = 0;
-
-        switch (_depth)
+        else
         {
-            case 15:
-            case 16:
+            for (uint64_t i = 0; i < size; ++i)
+            {
+                count = 1;
+                while ((i < (size - 1)) && (count < 128) && (tmp[i] == tmp[i + 1]))
+                {
+                    ++count;
+                    ++i;
+                }
+
+                if ((count > 1) || (buffer.size() >= 128))
+                {
+                    if (!buffer.empty())
+                    {
+                        data.push_back(static_cast<uint8_t>(buffer.size() - 1));
+                        data.insert(data.end(), buffer.begin(), buffer.end());
+                        buffer.clear();
+                    }
+                    data.push_back(static_cast<uint8_t>((count - 1) | 128));
+                    data += tmp[i];
+                }
+                else
+                    buffer.push_back(tmp[i]);
+            }
+
+            if (!buffer.empty())
+            {
+                data.push_back(static_cast<uint8_t>(buffer.size() - 1));
+                data.insert(data.end(), buffer.begin(), buffer.end());
+            }
+        }
+
+        return data;
+    }
+
+    std::string Targa::genTruecolorRleData(const Pixels &pixels) const noexcept(false)
+    {
+        const uint64_t size = pixels.size();
+        const uint64_t psize = (_depth + 1) / 8;
+        std::vector<uint8_t> buffer;
+        std::string data;
+        uint64_t count = 0;
+
+        switch (_depth)
+        {
+            case 15:
+            case 16:
             {
                 const bool alpha_bit = _image_descriptor & 0x01;
                 auto pushBytes = [&](auto &container, const auto &pixel)
@@ -1245,97 +1123,264 @@ namespace Image
         return data;
     }
 
-    Targa::Pixels Targa::loadMappedData(std::istream &is, const Header header) const noexcept(false)
+    bool Targa::implSave(const std::string &filename, const int64_t width, const int64_t height,
+                         const std::string &data, const std::vector<RGBA> &palette) const
+        noexcept(false)
     {
-        const uint64_t mapsize = header.colormap_length;
-        Pixels colormap(mapsize, RGBA::Black);
-        Pixels pixels(header.width * header.height);
-        E::Union8 tmp;
+        if (std::ofstream ofile(filename); ofile.is_open() && ofile.good())
+        {
+            E::Union16 tmp16;
+            E::Union8 tmp8;
 
-        if (header.colormap_offset)
-            is.seekg(header.colormap_offset, std::ios::cur);
+            // header
+            tmp8.u = _image_id.size();
+            ofile.put(tmp8.c1);
+            tmp8.u = _colormap_type;
+            ofile.put(tmp8.c1);
+            tmp8.u = T::valueOf(_image_type);
+            ofile.put(tmp8.c1);
+            tmp16.u = _colormap_offset;
+            ofile.put(tmp16.c1).put(tmp16.c2);
+            tmp16.u = _colormap_type ? palette.size() : _colormap_length;
+            ofile.put(tmp16.c1).put(tmp16.c2);
+            tmp8.u = _colormap_entry_size;
+            ofile.put(tmp8.c1);
+            tmp16.u = _x_origin;
+            ofile.put(tmp16.c1).put(tmp16.c2);
+            tmp16.u = _y_origin;
+            ofile.put(tmp16.c1).put(tmp16.c2);
+            tmp16.u = width;
+            ofile.put(tmp16.c1).put(tmp16.c2);
+            tmp16.u = height;
+            ofile.put(tmp16.c1).put(tmp16.c2);
+            tmp8.u = _depth;
+            ofile.put(tmp8.c1);
+            tmp8.u = _image_descriptor;
+            ofile.put(tmp8.c1);
+            if (!_image_id.empty())
+            {
+                ofile.write(_image_id.c_str(), _image_id.size());
+                ofile.put('\0');
+            }
 
-        switch (header.colormap_entry_size)
-        {
-            case 15:
-            case 16:
+            // image palette
+            if (_colormap_type && !palette.empty())
             {
-                const bool alpha_bit = header.image_descriptor & 0x01;
-                E::Union16 tmp_color;
+                std::string palette_data;
 
-                for (uint64_t i = 0; i < mapsize; ++i)
+                switch (_colormap_entry_size)
                 {
-                    is.get(tmp_color.c1).get(tmp_color.c2);
-                    colormap[i].r = (tmp_color.u & 0b0111110000000000) << 1;
-                    colormap[i].g = (tmp_color.u & 0b0000001111100000) << 6;
-                    colormap[i].b = (tmp_color.u & 0b0000000000011111) << 11;
-                    colormap[i].a = (alpha_bit & (tmp_color.u >> 15)) ? MaxU16 : 0;
-                }
+                    case 15:
+                    case 16:
+                    {
+                        const bool alpha_bit = _image_descriptor & 0x01;
+                        C::UnionRGBA5551 tmp;
 
-                break;
-            }
+                        palette_data.reserve(palette.size() * 2);
+                        for (const auto &pixel : palette)
+                        {
+                            // this is weird, the colors in the palette are different from the
+                            // format used in pure pixel data
+                            tmp.u = 0;
+                            tmp.u |= (pixel.rh >> 3) << 10;
+                            tmp.u |= (pixel.gh >> 3) << 5;
+                            tmp.u |= (pixel.bh >> 3);
+                            tmp.u |= (alpha_bit && static_cast<bool>(pixel.a)) << 15;
+                            palette_data += tmp.c2;
+                            palette_data += tmp.c1;
+                        }
 
-            case 24:
-            {
-                for (uint64_t i = 0; i < mapsize; ++i)
-                {
-                    colormap[i].b = is.get() << 8;
-                    colormap[i].g = is.get() << 8;
-                    colormap[i].r = is.get() << 8;
-                    colormap[i].a = MaxU16;
-                }
+                        break;
+                    }
 
-                break;
+                    case 24:
+                    {
+                        palette_data.reserve(palette.size() * 3);
+                        for (const auto &pixel : palette)
+                        {
+                            palette_data += pixel.c5;
+                            palette_data += pixel.c3;
+                            palette_data += pixel.c1;
+                        }
+
+                        break;
+                    }
+
+                    case 32:
+                    {
+                        palette_data.reserve(palette.size() * 4);
+                        for (const auto &pixel : palette)
+                        {
+                            palette_data += pixel.c5;
+                            palette_data += pixel.c3;
+                            palette_data += pixel.c1;
+                            palette_data += pixel.c7;
+                        }
+
+                        break;
+                    }
+                }
+                ofile.write(palette_data.c_str(), palette_data.size());
             }
 
-            case 32:
+            // image data
+            ofile.write(data.c_str(), data.size());
+
+            // footer
+            if (_version2)
+                ofile.write(Signature.c_str(), Signature.size());
+            ofile.close();
+
+            return true;
+        }
+
+        return false;
+    }
+
+    template <typename Pixel>
+    bool Targa::implLoad(const std::string &filename, PixelsOf<Pixel> &pixels, Header &header)
+        noexcept(false)
+    {
+        if (std::ifstream ifile(filename); ifile.is_open() && ifile.good())
+        {
+            std::pmr::memory_resource *resource = pixels.get_allocator().resource();
+            std::string id;
+            bool version2;
+
+            if (!implReadHeader(ifile, header, id, version2))
+                return false;
+
+            switch (header.image_type)
             {
-                for (uint64_t i = 0; i < mapsize; ++i)
-                {
-                    colormap[i].b = is.get() << 8;
-                    colormap[i].g = is.get() << 8;
-                    colormap[i].r = is.get() << 8;
-                    colormap[i].a = is.get() << 8;
-                }
+                // nothing to do here
+                case IT::NoData:
+                    break;
 
-                break;
+                case IT::Mapped:
+                case IT::MappedRLE:
+                    pixels = loadMappedData<Pixel>(ifile, header, resource);
+                    break;
+
+                case IT::Truecolor:
+                    pixels = loadTruecolorData<Pixel>(ifile, header, resource);
+                    break;
+
+                case IT::Mono:
+                    pixels = loadMonoData<Pixel>(ifile, header, resource);
+                    break;
+
+                case IT::TruecolorRLE:
+                    pixels = loadTruecolorRleData<Pixel>(ifile, header, resource);
+                    break;
+
+                case IT::MonoRLE:
+                    pixels = loadMonoRleData<Pixel>(ifile, header, resource);
+                    break;
+
+                case IT::MappedAll:
+                case IT::MappedAllQuad:
+                    throw std::logic_error("propreitary features are not supported");
             }
+            ifile.close();
 
-            default:
-                throw std::logic_error("out of spec mapped colors depth (" +
-                                       std::to_string(header.colormap_entry_size) + ")");
+            if (pixels.size() != (header.width * header.height))
+                return false;
+
+            implApplyHeader(header, id, version2);
+
+            return true;
         }
 
-        for (auto &pixel : pixels)
+        return false;
+    }
+
+    bool Targa::implReadHeader(std::istream &is, Header &header, std::string &id,
+                               bool &version2) const noexcept(false)
+    {
+        const uint64_t size = is.seekg(0, std::ios::end).tellg();
+        Footer footer;
+
+        if (size < sizeof (header))
+            return false;
+
+        is.seekg(size - sizeof (footer), std::ios::beg);
+        is.read(reinterpret_cast<char *>(&footer), sizeof (footer));
+        is.seekg(0, std::ios::beg);
+        is.read(reinterpret_cast<char *>(&header), sizeof (header));
+
+        id.clear();
+        if (header.id)
         {
-            is.get(tmp.c1);
-            pixel = colormap[tmp.u];
+            id.resize(header.id, '\0');
+            is.read(id.data(), id.size());
         }
 
+        if (std::string(footer.signature).substr(0, Signature.size()) == Signature)
+            version2 = true;
+        else
+            version2 = false;
+
+        return true;
+    }
+
+    void Targa::implApplyHeader(const Header &header, const std::string &id, const bool version2)
+        noexcept(false)
+    {
+        _colormap_type = header.colormap_type;
+        _image_type = header.image_type;
+        _colormap_offset = header.colormap_offset;
+        _colormap_length = header.colormap_length;
+        _colormap_entry_size = header.colormap_entry_size;
+        _x_origin = header.x_origin;
+        _y_origin = header.y_origin;
+        _depth = header.depth;
+        _image_descriptor = header.image_descriptor;
+        _image_id = id;
+        _version2 = version2;
+    }
+
+    template <typename Pixel>
+    Targa::PixelsOf<Pixel> Targa::loadMappedData(std::istream &is, const Header header,
+                                                 std::pmr::memory_resource *resource) const
+        noexcept(false)
+    {
+        const std::vector<Pixel> colormap = loadColormap<Pixel>(is, header);
+        const std::pmr::vector<uint8_t> indices = loadIndices(is, header, resource);
+        PixelsOf<Pixel> pixels(indices.size(), Pixel(Pixel::Black), resource);
+
+        // an index without a color stays black
+        for (uint64_t i = 0; i < indices.size(); ++i)
+            if (indices[i] < colormap.size())
+                pixels[i] = colormap[indices[i]];
+
         return pixels;
     }
 
-    Targa::Pixels Targa::loadTruecolorData(std::istream &is, const Header header) const
+    template <typename Pixel>
+    std::vector<Pixel> Targa::loadColormap(std::istream &is, const Header header) const
         noexcept(false)
     {
-        Pixels pixels(header.width * header.height);
+        const uint64_t mapsize = header.colormap_length;
+        std::vector<Pixel> colormap(mapsize, Pixel(Pixel::Black));
 
-        switch (header.depth)
+        if (header.colormap_offset)
+            is.seekg(header.colormap_offset, std::ios::cur);
+
+        switch (header.colormap_entry_size)
         {
             case 15:
             case 16:
             {
                 const bool alpha_bit = header.image_descriptor & 0x01;
-                E::Union16 tmp;
+                E::Union16 tmp_color;
 
-                for (auto &pixel : pixels)
+                for (uint64_t i = 0; i < mapsize; ++i)
                 {
-                    // XXX: 16bit color data looks weird, needs a check on a big endian machine
-                    is.get(tmp.c1).get(tmp.c2);
-                    pixel.r = (tmp.u & 0b0111110000000000) << 1;
-                    pixel.g = (tmp.u & 0b0000001111100000) << 6;
-                    pixel.b = (tmp.u & 0b0000000000011111) << 11;
-                    pixel.a = (alpha_bit & (tmp.u >> 15)) * MaxU16;
+                    is.get(tmp_color.c1).get(tmp_color.c2);
+                    colormap[i].r = D::channel<Pixel>((tmp_color.u & 0b0111110000000000) << 1);
+                    colormap[i].g = D::channel<Pixel>((tmp_color.u & 0b0000001111100000) << 6);
+                    colormap[i].b = D::channel<Pixel>((tmp_color.u & 0b0000000000011111) << 11);
+                    colormap[i].a = D::channel<Pixel>((alpha_bit & (tmp_color.u >> 15)) * MaxU16);
                 }
 
                 break;
@@ -1343,12 +1388,12 @@ namespace Image
 
             case 24:
             {
-                for (auto &pixel : pixels)
+                for (uint64_t i = 0; i < mapsize; ++i)
                 {
-                    pixel.b = is.get() << 8;
-                    pixel.g = is.get() << 8;
-                    pixel.r = is.get() << 8;
-                    pixel.a = MaxU16;
+                    colormap[i].b = D::channel<Pixel>(is.get() << 8);
+                    colormap[i].g = D::channel<Pixel>(is.get() << 8);
+                    colormap[i].r = D::channel<Pixel>(is.get() << 8);
+                    colormap[i].a = D::channel<Pixel>(MaxU16);
                 }
 
                 break;
@@ -1356,12 +1401,12 @@ namespace Image
 
             case 32:
             {
-                for (auto &pixel : pixels)
+                for (uint64_t i = 0; i < mapsize; ++i)
                 {
-                    pixel.b = is.get() << 8;
-                    pixel.g = is.get() << 8;
-                    pixel.r = is.get() << 8;
-                    pixel.a = is.get() << 8;
+                    colormap[i].b = D::channel<Pixel>(is.get() << 8);
+                    colormap[i].g = D::channel<Pixel>(is.get() << 8);
+                    colormap[i].r = D::channel<Pixel>(is.get() << 8);
+                    colormap[i].a = D::channel<Pixel>(is.get() << 8);
                 }
 
                 break;
@@ -1369,56 +1414,76 @@ namespace Image
 
             default:
                 throw std::logic_error("out of spec mapped colors depth (" +
-                                       std::to_string(header.depth) + ")");
+                                       std::to_string(header.colormap_entry_size) + ")");
         }
 
-        return pixels;
+        return colormap;
     }
 
-    Targa::Pixels Targa::loadMonoData(std::istream &is, const Header header) const noexcept(false)
+    std::pmr::vector<uint8_t> Targa::loadIndices(std::istream &is, const Header header,
+                                                 std::pmr::memory_resource *resource) const
+        noexcept(false)
     {
-        Pixels pixels(header.width * header.height);
+        const uint64_t size = header.width * header.height;
+        std::pmr::vector<uint8_t> indices(resource);
+        uint64_t count = 0;
+        E::Union8 rle;
         E::Union8 tmp;
 
-        for (auto &pixel : pixels)
+        if (header.image_type != IT::MappedRLE)
         {
-            is.read(&tmp.c1, sizeof (tmp.c1));
-            pixel = {tmp.u, tmp.u, tmp.u, 255};
-            pixel = pixel << 8;
+            indices.resize(size);
+            is.read(reinterpret_cast<char *>(indices.data()), size);
+
+            return indices;
         }
 
-        return pixels;
+        while ((indices.size() < size) && !is.eof())
+        {
+            is.get(rle.c1);
+            count = (rle.u & 128) ? ((rle.u & ~128) + 1) : (rle.u + 1);
+
+            if (rle.u & 128)
+            {
+                is.get(tmp.c1);
+                indices.insert(indices.end(), count, tmp.u);
+            }
+            else
+            {
+                for (uint64_t i = 0; i < count; ++i)
+                {
+                    is.get(tmp.c1);
+                    indices.push_back(tmp.u);
+                }
+            }
+        }
+
+        return indices;
     }
 
-    Targa::Pixels Targa::loadMappedRleData(std::istream &is, const Header header) const
+    template <typename Pixel>
+    Targa::PixelsOf<Pixel> Targa::loadTruecolorData(std::istream &is, const Header header,
+                                                    std::pmr::memory_resource *resource) const
         noexcept(false)
     {
-        const uint64_t size = header.width * header.height;
-        const uint64_t mapsize = header.colormap_length;
-        Pixels colormap(mapsize, RGBA::Black);
-        Pixels pixels;
-        uint64_t count = 0;
-        E::Union8 rle;
-        E::Union8 tmp;
+        PixelsOf<Pixel> pixels(header.width * header.height, resource);
 
-        if (header.colormap_offset)
-            is.seekg(header.colormap_offset, std::ios::cur);
-
-        switch (header.colormap_entry_size)
+        switch (header.depth)
         {
             case 15:
             case 16:
             {
                 const bool alpha_bit = header.image_descriptor & 0x01;
-                E::Union16 tmp_color;
+                E::Union16 tmp;
 
-                for (uint64_t i = 0; i < mapsize; ++i)
+                for (auto &pixel : pixels)
                 {
-                    is.get(tmp_color.c1).get(tmp_color.c2);
-                    colormap[i].r = (tmp_color.u & 0b0111110000000000) << 1;
-                    colormap[i].g = (tmp_color.u & 0b0000001111100000) << 6;
-                    colormap[i].b = (tmp_color.u & 0b0000000000011111) << 11;
-                    colormap[i].a = (alpha_bit & (tmp_color.u >> 15)) ? MaxU16 : 0;
+                    // XXX: 16bit color data looks weird, needs a check on a big endian machine
+                    is.get(tmp.c1).get(tmp.c2);
+                    pixel.r = D::channel<Pixel>((tmp.u & 0b0111110000000000) << 1);
+                    pixel.g = D::channel<Pixel>((tmp.u & 0b0000001111100000) << 6);
+                    pixel.b = D::channel<Pixel>((tmp.u & 0b0000000000011111) << 11);
+                    pixel.a = D::channel<Pixel>((alpha_bit & (tmp.u >> 15)) * MaxU16);
                 }
 
                 break;
@@ -1426,12 +1491,12 @@ namespace Image
 
             case 24:
             {
-                for (uint64_t i = 0; i < mapsize; ++i)
+                for (auto &pixel : pixels)
                 {
-                    colormap[i].b = is.get() << 8;
-                    colormap[i].g = is.get() << 8;
-                    colormap[i].r = is.get() << 8;
-                    colormap[i].a = MaxU16;
+                    pixel.b = D::channel<Pixel>(is.get() << 8);
+                    pixel.g = D::channel<Pixel>(is.get() << 8);
+                    pixel.r = D::channel<Pixel>(is.get() << 8);
+                    pixel.a = D::channel<Pixel>(MaxU16);
                 }
 
                 break;
@@ -1439,12 +1504,12 @@ namespace Image
 
             case 32:
             {
-                for (uint64_t i = 0; i < mapsize; ++i)
+                for (auto &pixel : pixels)
                 {
-                    colormap[i].b = is.get() << 8;
-                    colormap[i].g = is.get() << 8;
-                    colormap[i].r = is.get() << 8;
-                    colormap[i].a = is.get() << 8;
+                    pixel.b = D::channel<Pixel>(is.get() << 8);
+                    pixel.g = D::channel<Pixel>(is.get() << 8);
+                    pixel.r = D::channel<Pixel>(is.get() << 8);
+                    pixel.a = D::channel<Pixel>(is.get() << 8);
                 }
 
                 break;
@@ -1455,36 +1520,34 @@ namespace Image
                                        std::to_string(header.depth) + ")");
         }
 
-        while ((pixels.size() < size) && !is.eof())
-        {
-            is.get(rle.c1);
-            count = (rle.u & 128) ? ((rle.u & ~128) + 1) : (rle.u + 1);
+        return pixels;
+    }
 
-            if (rle.u & 128)
-            {
-                is.get(tmp.c1);
-                for (uint64_t i = 0; i < count; ++i)
-                    pixels.push_back(colormap[tmp.u]);
-            }
-            else
-            {
-                for (uint64_t i = 0; i < count; ++i)
-                {
-                    is.get(tmp.c1);
-                    pixels.push_back(colormap[tmp.u]);
-                }
-            }
+    template <typename Pixel>
+    Targa::PixelsOf<Pixel> Targa::loadMonoData(std::istream &is, const Header header,
+                                               std::pmr::memory_resource *resource) const
+        noexcept(false)
+    {
+        PixelsOf<Pixel> pixels(header.width * header.height, resource);
+        E::Union8 tmp;
+
+        for (auto &pixel : pixels)
+        {
+            is.read(&tmp.c1, sizeof (tmp.c1));
+            pixel = D::grey<Pixel>(tmp.u);
         }
 
         return pixels;
     }
 
-    Targa::Pixels Targa::loadTruecolorRleData(std::istream &is, const Header header) const
+    template <typename Pixel>
+    Targa::PixelsOf<Pixel> Targa::loadTruecolorRleData(std::istream &is, const Header header,
+                                                       std::pmr::memory_resource *resource) const
         noexcept(false)
     {
         const uint64_t size = header.width * header.height;
-        Pixels pixels;
-        RGBA pixel;
+        PixelsOf<Pixel> pixels(resource);
+        Pixel pixel;
         uint64_t count = 0;
         E::Union8 rle;
 
@@ -1504,10 +1567,10 @@ namespace Image
                     if (rle.u & 128)
                     {
                         is.get(tmp_color.c1).get(tmp_color.c2);
-                        pixel.r = (tmp_color.u & 0b0111110000000000) << 1;
-                        pixel.g = (tmp_color.u & 0b0000001111100000) << 6;
-                        pixel.b = (tmp_color.u & 0b0000000000011111) << 11;
-                        pixel.a = (alpha_bit & (tmp_color.u >> 15)) * MaxU16;
+                        pixel.r = D::channel<Pixel>((tmp_color.u & 0b0111110000000000) << 1);
+                        pixel.g = D::channel<Pixel>((tmp_color.u & 0b0000001111100000) << 6);
+                        pixel.b = D::channel<Pixel>((tmp_color.u & 0b0000000000011111) << 11);
+                        pixel.a = D::channel<Pixel>((alpha_bit & (tmp_color.u >> 15)) * MaxU16);
                         for (uint64_t i = 0; i < count; ++i)
                             pixels.push_back(pixel);
                     }
@@ -1516,10 +1579,10 @@ namespace Image
                         for (uint64_t i = 0; i < count; ++i)
                         {
                             is.get(tmp_color.c1).get(tmp_color.c2);
-                            pixel.r = (tmp_color.u & 0b0111110000000000) << 1;
-                            pixel.g = (tmp_color.u & 0b0000001111100000) << 6;
-                            pixel.b = (tmp_color.u & 0b0000000000011111) << 11;
-                            pixel.a = (alpha_bit & (tmp_color.u >> 15)) * MaxU16;
+                            pixel.r = D::channel<Pixel>((tmp_color.u & 0b0111110000000000) << 1);
+                            pixel.g = D::channel<Pixel>((tmp_color.u & 0b0000001111100000) << 6);
+                            pixel.b = D::channel<Pixel>((tmp_color.u & 0b0000000000011111) << 11);
+                            pixel.a = D::channel<Pixel>((alpha_bit & (tmp_color.u >> 15)) * MaxU16);
                             pixels.push_back(pixel);
                         }
                     }
@@ -1537,10 +1600,10 @@ namespace Image
 
                     if (rle.u & 128)
                     {
-                        pixel.b = is.get() << 8;
-                        pixel.g = is.get() << 8;
-                        pixel.r = is.get() << 8;
-                        pixel.a = MaxU16;
+                        pixel.b = D::channel<Pixel>(is.get() << 8);
+                        pixel.g = D::channel<Pixel>(is.get() << 8);
+                        pixel.r = D::channel<Pixel>(is.get() << 8);
+                        pixel.a = D::channel<Pixel>(MaxU16);
                         for (uint64_t i = 0; i < count; ++i)
                             pixels.push_back(pixel);
                     }
@@ -1548,10 +1611,10 @@ namespace Image
                     {
                         for (uint64_t i = 0; i < count; ++i)
                         {
-                            pixel.b = is.get() << 8;
-                            pixel.g = is.get() << 8;
-                            pixel.r = is.get() << 8;
-                            pixel.a = MaxU16;
+                            pixel.b = D::channel<Pixel>(is.get() << 8);
+                            pixel.g = D::channel<Pixel>(is.get() << 8);
+                            pixel.r = D::channel<Pixel>(is.get() << 8);
+                            pixel.a = D::channel<Pixel>(MaxU16);
                             pixels.push_back(pixel);
                         }
                     }
@@ -1569,10 +1632,10 @@ namespace Image
 
                     if (rle.u & 128)
                     {
-                        pixel.b = is.get() << 8;
-                        pixel.g = is.get() << 8;
-                        pixel.r = is.get() << 8;
-                        pixel.a = is.get() << 8;
+                        pixel.b = D::channel<Pixel>(is.get() << 8);
+                        pixel.g = D::channel<Pixel>(is.get() << 8);
+                        pixel.r = D::channel<Pixel>(is.get() << 8);
+                        pixel.a = D::channel<Pixel>(is.get() << 8);
                         for (uint64_t i = 0; i < count; ++i)
                             pixels.push_back(pixel);
                     }
@@ -1580,10 +1643,10 @@ namespace Image
                     {
                         for (uint64_t i = 0; i < count; ++i)
                         {
-                            pixel.b = is.get() << 8;
-                            pixel.g = is.get() << 8;
-                            pixel.r = is.get() << 8;
-                            pixel.a = is.get() << 8;
+                            pixel.b = D::channel<Pixel>(is.get() << 8);
+                            pixel.g = D::channel<Pixel>(is.get() << 8);
+                            pixel.r = D::channel<Pixel>(is.get() << 8);
+                            pixel.a = D::channel<Pixel>(is.get() << 8);
                             pixels.push_back(pixel);
                         }
                     }
@@ -1600,12 +1663,14 @@ namespace Image
         return pixels;
     }
 
-    Targa::Pixels Targa::loadMonoRleData(std::istream &is, const Header header) const
+    template <typename Pixel>
+    Targa::PixelsOf<Pixel> Targa::loadMonoRleData(std::istream &is, const Header header,
+                                                  std::pmr::memory_resource *resource) const
         noexcept(false)
     {
         const uint64_t size = header.width * header.height;
-        Pixels pixels;
-        RGBA pixel;
+        PixelsOf<Pixel> pixels(resource);
+        Pixel pixel;
         uint64_t count = 0;
         E::Union8 rle;
         E::Union8 tmp;
@@ -1618,8 +1683,7 @@ namespace Image
             if (rle.u & 128)
             {
                 is.get(tmp.c1);
-                pixel = {tmp.u, tmp.u, tmp.u, 255};
-                pixel = pixel << 8;
+                pixel = D::grey<Pixel>(tmp.u);
                 for (uint64_t i = 0; i < count; ++i)
                     pixels.push_back(pixel);
             }
@@ -1628,8 +1692,7 @@ namespace Image
                 for (uint64_t i = 0; i < count; ++i)
                 {
                     is.get(tmp.c1);
-                    pixel = {tmp.u, tmp.u, tmp.u, 255};
-                    pixel = pixel << 8;
+                    pixel = D::grey<Pixel>(tmp.u);
                     pixels.push_back(pixel);
                 }
             }
@@ -2,11 +2,20 @@
 
 #include <iosfwd>
 #include <limits>
+#include <memory_resource>
 #include <string>
+#include <vector>
 #include "Base.hxx"
 
 namespace Image
 {
+    //--- base types and constants ---
+    // defined in Compact.hxx
+    class Compact;
+    // defined in Indexed.hxx
+    template <typename Index>
+    class Indexed;
+
     //
     // Targa - the good old image format well suited for textures
     //
@@ -18,6 +27,10 @@ namespace Image
     //   (how Targa RLE works was tested in the Simple01 image format, I'm going to use this here)
     // - there are two propreitary pixel encodings I can not support, because I'm not able to find
     //   a spec descriping these
+    // - loadCompact() reads the file into an image with 8 bit channels, which is all a Targa ever
+    //   holds, so nothing is widened to 16 bit on the way
+    // - the mapped types are written from the indices of an Indexed image, save() quantizes into
+    //   one first, loadIndexed() keeps the indices and the colormap of a mapped file as they are
     //
     class Targa : public Base {
     public:
@@ -72,6 +85,7 @@ namespace Image
         Targa(const int64_t width, const int64_t height, const RGBA color = RGBA::Black)
             noexcept(false);
         Targa(const Pixels &pixels, const int64_t width, const int64_t height) noexcept(false);
+        explicit Targa(const Base &image) noexcept(false);
         Targa(const Targa &rhs) noexcept(false);
         Targa(Targa &&rhs) noexcept;
         virtual ~Targa() noexcept;
@@ -103,24 +117,61 @@ namespace Image
             noexcept(false) override final;
         virtual bool save(const std::string &filename) const noexcept(false) override final;
         virtual bool load(const std::string &filename) noexcept(false) override final;
+        bool loadCompact(const std::string &filename, Compact &image) noexcept(false);
+        bool saveIndexed(const std::string &filename, const Indexed<uint8_t> &image) const
+            noexcept(false);
+        bool loadIndexed(const std::string &filename, Indexed<uint8_t> &image) noexcept(false);
 
         //--- static public methods ---
         static bool identify(const std::string &filename) noexcept(false);
 
     protected:
+        //--- protected types and constants ---
+        // the loaders fill 16 bit pixels for Base and 8 bit ones for Compact
+        template <typename Pixel>
+        using PixelsOf = std::pmr::vector<Pixel>;
+
         //--- protected methods ---
-        std::string genMappedData(Pixels &palette, const Pixels &pixels) const noexcept(false);
+        std::string genMappedData(const Indexed<uint8_t> &image) const noexcept(false);
         std::string genTruecolorData(const Pixels &pixels) const noexcept(false);
         std::string genMonoData(const Pixels &pixels) const noexcept(false);
-        std::string genMappedRleData(Pixels &palette, const Pixels &pixels) const noexcept(false);
+        std::string genMappedRleData(const Indexed<uint8_t> &image) const noexcept(false);
         std::string genTruecolorRleData(const Pixels &pixels) const noexcept(false);
         std::string genMonoRleData(const Pixels &pixels) const noexcept(false);
-        Pixels loadMappedData(std::istream &is, const Header header) const noexcept(false);
-        Pixels loadTruecolorData(std::istream &is, const Header header) const noexcept(false);
-        Pixels loadMonoData(std::istream &is, const Header header) const noexcept(false);
-        Pixels loadMappedRleData(std::istream &is, const Header header) const noexcept(false);
-        Pixels loadTruecolorRleData(std::istream &is, const Header header) const noexcept(false);
-        Pixels loadMonoRleData(std::istream &is, const Header header) const noexcept(false);
+        bool implSave(const std::string &filename, const int64_t width, const int64_t height,
+                      const std::string &data, const std::vector<RGBA> &palette) const
+            noexcept(false);
+        template <typename Pixel>
+        bool implLoad(const std::string &filename, PixelsOf<Pixel> &pixels, Header &header)
+            noexcept(false);
+        bool implReadHeader(std::istream &is, Header &header, std::string &id, bool &version2)
+            const noexcept(false);
+        void implApplyHeader(const Header &header, const std::string &id, const bool version2)
+            noexcept(false);
+        template <typename Pixel>
+        PixelsOf<Pixel> loadMappedData(std::istream &is, const Header header,
+                                       std::pmr::memory_resource *resource) const noexcept(false);
+        template <typename Pixel>
+        std::vector<Pixel> loadColormap(std::istream &is, const Header header) const
+            noexcept(false);
+        std::pmr::vector<uint8_t> loadIndices(std::istream &is, const Header header,
+                                              std::pmr::memory_resource *resource) const
+            noexcept(false);
+        template <typename Pixel>
+        PixelsOf<Pixel> loadTruecolorData(std::istream &is, const Header header,
+                                          std::pmr::memory_resource *resource) const
+            noexcept(false);
+        template <typename Pixel>
+        PixelsOf<Pixel> loadMonoData(std::istream &is, const Header header,
+                                     std::pmr::memory_resource *resource) const noexcept(false);
+        template <typename Pixel>
+        PixelsOf<Pixel> loadTruecolorRleData(std::istream &is, const Header header,
+                                             std::pmr::memory_resource *resource) const
+            noexcept(false);
+        template <typename Pixel>
+        PixelsOf<Pixel> loadMonoRleData(std::istream &is, const Header header,
+                                        std::pmr::memory_resource *resource) const
+            noexcept(false);
 
     private:
         //--- private properties ---
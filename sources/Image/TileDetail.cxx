@@ -0,0 +1,66 @@
+#include <algorithm>
+#include "Common/ThreadPool.hxx"
+#include "TileDetail.hxx"
+
+namespace Image::Detail
+{
+    //--- internal stuff ---
+
+    // runs over all tile rows of the tiles in the given band of tile rows, hands out the offset of
+    // the row in the linear and in the tiled layout and its width
+    template <typename F>
+    static inline void tileRows(const int64_t width, const int64_t height, const int64_t begin,
+                                const int64_t end, F func) noexcept
+    {
+        constexpr int64_t size = Base::TileSize;
+
+        for (int64_t top = begin * size, last = std::min(end * size, height); top < last;
+             top += size)
+        {
+            const int64_t tile_height = std::min(size, height - top);
+
+            for (int64_t left = 0; left < width; left += size)
+            {
+                const int64_t tile_width = std::min(size, width - left);
+                const int64_t tile = top * width + left * tile_height;
+
+                for (int64_t y = 0; y < tile_height; ++y)
+                    func((top + y) * width + left, tile + y * tile_width, tile_width);
+            }
+        }
+    }
+
+    //--- public functions ---
+
+    void toTiles(const RGBA *linear, RGBA *tiled, const int64_t width, const int64_t height,
+                 const int64_t threads) noexcept(false)
+    {
+        const int64_t tile_rows = (height + Base::TileSize - 1) / Base::TileSize;
+
+        Common::ThreadPool::global().runBands(tile_rows, threads,
+        [&](const int64_t begin, const int64_t end)
+        {
+            tileRows(width, height, begin, end, [&](const int64_t from, const int64_t to,
+                                                    const int64_t count)
+            {
+                std::copy_n(linear + from, count, tiled + to);
+            });
+        });
+    }
+
+    void fromTiles(const RGBA *tiled, RGBA *linear, const int64_t width, const int64_t height,
+                   const int64_t threads) noexcept(false)
+    {
+        const int64_t tile_rows = (height + Base::TileSize - 1) / Base::TileSize;
+
+        Common::ThreadPool::global().runBands(tile_rows, threads,
+        [&](const int64_t begin, const int64_t end)
+        {
+            tileRows(width, height, begin, end, [&](const int64_t to, const int64_t from,
+                                                    const int64_t count)
+            {
+                std::copy_n(tiled + from, count, linear + to);
+            });
+        });
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include "Base.hxx"
+
+namespace Image::Detail
+{
+    using RGBA = Base::RGBA;
+
+    // position of a pixel in the tiled layout, the tiles are stored row by row with their own rows
+    // inside and the tiles at the right and the bottom are cut down to the image, so there is no
+    // padding and a tile row takes exactly as much room as the same rows in the linear layout
+    inline int64_t tileIndex(const int64_t x, const int64_t y, const int64_t width,
+                             const int64_t height) noexcept
+    {
+        constexpr int64_t size = Base::TileSize;
+        const int64_t left = x & ~(size - 1);
+        const int64_t top = y & ~(size - 1);
+        const int64_t tile_width = std::min(size, width - left);
+        const int64_t tile_height = std::min(size, height - top);
+
+        return top * width + left * tile_height + (y - top) * tile_width + (x - left);
+    }
+
+    // copies the pixels of a linear image into the tiled layout and back, one band of tile rows
+    // per thread
+    void toTiles(const RGBA *linear, RGBA *tiled, const int64_t width, const int64_t height,
+                 const int64_t threads) noexcept(false);
+    void fromTiles(const RGBA *tiled, RGBA *linear, const int64_t width, const int64_t height,
+                   const int64_t threads) noexcept(false);
+}
@@ -1,14 +1,19 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include "TestCases.hxx"
 
 namespace TestCase
 {
-    bool applyToImageCase00(Image::Base &pic)
+    //--- internal stuff ---
+
+    // the same drawing goes straight into an image or into a display list
+    template <typename Canvas>
+    bool case00(Canvas &pic, const int64_t w, const int64_t h)
     {
-        if ((pic.width() >= DefaultMinWidth) && (pic.height() >= DefaultMinHeight))
+        if ((w >= DefaultMinWidth) && (h >= DefaultMinHeight))
         {
             using Color = Image::Base::RGBA;
-            const int64_t w = pic.width();
-            const int64_t h = pic.height();
             const int64_t hw = w >> 1;
             const int64_t hh = h >> 1;
             const int64_t tw = (w >> 2) * 3;
@@ -53,4 +58,114 @@ namespace TestCase
 
         return false;
     }
+
+    //--- public functions ---
+
+    bool applyToImageCase00(Image::Base &pic)
+    {
+        return case00(pic, pic.width(), pic.height());
+    }
+
+    bool recordCase00(Image::DisplayList &list, const int64_t width, const int64_t height)
+    {
+        return case00(list, width, height);
+    }
+
+    Image::Picture pattern(const int64_t width, const int64_t height)
+    {
+        using Color = Image::Base::RGBA;
+
+        Image::Picture image(width, height);
+
+        // odd factors keep the red and green values apart up to 65536 columns and rows
+        for (int64_t y = 0; y < height; ++y)
+            for (int64_t x = 0; x < width; ++x)
+                image.setPixel(x, y, Color(x * 1031 & 0xFFFF, y * 977 & 0xFFFF,
+                                           (x + y) & 0xFFFF, (x * 3 + y * 5 + 1) & 0xFFFF));
+
+        return image;
+    }
+
+    Image::Picture gradient(const int64_t width, const int64_t height, const bool narrow,
+                            const uint16_t alpha)
+    {
+        using Color = Image::Base::RGBA;
+
+        Image::Picture image(width, height);
+
+        for (int64_t y = 0; y < height; ++y)
+        {
+            for (int64_t x = 0; x < width; ++x)
+            {
+                if (narrow)
+                    image.setPixel(x, y, Color((x * 255 / width) << 8, (y * 255 / height) << 8,
+                                               ((x + y) * 127 / (width + height)) << 8, alpha));
+                else
+                    image.setPixel(x, y, Color(x * 0xFFFF / width, y * 0xFFFF / height,
+                                               (x + y) * 0x7FFF / (width + height), alpha));
+            }
+        }
+
+        return image;
+    }
+
+    bool savesTiled(Image::Base &image, const std::string &filename)
+    {
+        const std::string tiled = filename + ".tiled";
+        auto contents = [](const std::string &name)
+        {
+            std::ifstream file(name, std::ios::binary);
+
+            return std::string(std::istreambuf_iterator<char>(file), {});
+        };
+
+        image.setLayout(Image::Layout::Tiled);
+
+        const bool ok = image.valid() && image.save(tiled) &&
+                        (contents(tiled) == contents(filename));
+
+        image.setLayout(Image::Layout::Linear);
+        std::remove(tiled.c_str());
+
+        return ok;
+    }
+
+    Image::Base::RGBA color(const size_t i)
+    {
+        return Image::Base::RGBA((i * 97 & 0xFF) << 8, (i * 31 & 0xFF) << 8, (i * 7 & 0xFF) << 8,
+                                 0xFFFF);
+    }
+
+    Image::Compact::RGBA compactColor(const size_t i)
+    {
+        return Image::Compact::RGBA(i * 97 & 0xFF, i * 31 & 0xFF, i * 7 & 0xFF, 0xFF);
+    }
+
+    Canvases::Canvases(const int64_t width, const int64_t height) :
+        _width(width), _height(height), _image(width, height), _tiled(width, height),
+        _compact(width, height), _framed(width + 2, height + 2),
+        _view(_framed.mutableView(1, 1, width, height))
+    {
+        _tiled.setLayout(Image::Layout::Tiled);
+    }
+
+    bool Canvases::matches(const Image::Picture &expected)
+    {
+        using Color = Image::Base::RGBA;
+
+        const Color black(Color::Black);
+
+        _tiled.setLayout(Image::Layout::Linear);
+
+        bool ok = (_image == expected) && (_tiled == expected) &&
+                  (_compact == Image::Compact(expected)) &&
+                  (Image::Picture(_view.pixels(), _width, _height) == expected);
+
+        for (int64_t x = 0; x < _width + 2; ++x)
+            ok &= (_framed.pixel(x, 0) == black) && (_framed.pixel(x, _height + 1) == black);
+        for (int64_t y = 0; y < _height + 2; ++y)
+            ok &= (_framed.pixel(0, y) == black) && (_framed.pixel(_width + 1, y) == black);
+
+        return ok;
+    }
 }
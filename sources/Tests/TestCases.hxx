@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <string>
+#include "Image/Compact.hxx"
 #include "Image/Image.hxx"
 
 namespace TestCase
@@ -9,5 +12,70 @@ namespace TestCase
     static constexpr int64_t DefaultWidth = 1280;
     static constexpr int64_t DefaultHeight = 720;
 
+    // the seconds one call of func takes, averaged over rounds calls
+    template <typename Func>
+    double seconds(Func func, const int64_t rounds = 1)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int64_t i = 0; i < rounds; ++i)
+            func();
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() /
+               rounds;
+    }
+
     bool applyToImageCase00(Image::Base &pic);
+    bool recordCase00(Image::DisplayList &list, const int64_t width, const int64_t height);
+
+    // every pixel differs from all others and every channel follows a pattern of its own, so a
+    // pixel in the wrong place, a swapped channel or a sample taken next to the right one is found
+    Image::Picture pattern(const int64_t width, const int64_t height);
+
+    // a smooth gradient in every color channel, narrow keeps the colors to the 8 bits most formats
+    // store, as they are shifted up when such a file is loaded
+    Image::Picture gradient(const int64_t width, const int64_t height, const bool narrow = false,
+                            const uint16_t alpha = 0xFFFF);
+
+    // the image switched to the tiled layout is still valid and saves the same file as it did
+    // into filename, it is switched back to the linear layout afterwards
+    bool savesTiled(Image::Base &image, const std::string &filename);
+
+    // a color of its own for every shape, with 8 bit channels so a compact image gets it too
+    Image::Base::RGBA color(const size_t i);
+    Image::Compact::RGBA compactColor(const size_t i);
+
+    //
+    // the images every drawing method has to work on alike, a picture, a tiled one, a compact
+    // image and a view framed by one pixel on every side, the frame has to stay black
+    //
+    class Canvases
+    {
+    public:
+        Canvases(const int64_t width, const int64_t height);
+        Canvases(const Canvases &) = delete;
+
+        Canvases &operator=(const Canvases &) = delete;
+
+        // draw(canvas, color) is called for each of them with the color of shape i
+        template <typename Draw>
+        void draw(const size_t i, Draw draw)
+        {
+            draw(_image, color(i));
+            draw(_tiled, color(i));
+            draw(_compact, compactColor(i));
+            draw(_view, color(i));
+        }
+
+        bool matches(const Image::Picture &expected);
+
+    private:
+        int64_t _width;
+        int64_t _height;
+        Image::Picture _image;
+        Image::Picture _tiled;
+        Image::Compact _compact;
+        Image::Picture _framed;
+        Image::MutableImageView _view;
+    };
 }
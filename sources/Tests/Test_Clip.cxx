@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 1920;
+static const int64_t DefHeight = 1080;
+static const int64_t DefLines = 20000;
+
+// the image the shapes are drawn on and how far they may reach outside of it
+static const int64_t Width = 100;
+static const int64_t Height = 80;
+static const int64_t Margin = 150;
+
+struct Shape {
+    int64_t kind, x1, y1, x2, y2, x3, y3;
+    bool fill;
+};
+
+// any of the drawing methods, moved by an offset
+template <typename Canvas, typename Color>
+auto draw(Canvas &canvas, const Shape &s, const int64_t offset, const Color color)
+{
+    switch (s.kind)
+    {
+        case 0:
+            return canvas.setLine(s.x1 + offset, s.y1 + offset, s.x2 + offset, s.y2 + offset,
+                                  color);
+
+        case 1:
+            return canvas.setTriangle(s.x1 + offset, s.y1 + offset, s.x2 + offset, s.y2 + offset,
+                                      s.x3 + offset, s.y3 + offset, color, s.fill);
+
+        case 2:
+            return canvas.setRectangle(s.x1 + offset, s.y1 + offset, s.x2 + offset,
+                                       s.y2 + offset, color, s.fill);
+
+        default:
+            return canvas.setEllipse(s.x1 + offset, s.y1 + offset, std::abs(s.x2 - s.x1) / 2,
+                                     std::abs(s.y2 - s.y1) / 2, color, s.fill);
+    }
+}
+
+// the line the way it was drawn before, stepping from one end to the other
+void bresenham(Image::Base &image, int64_t x1, int64_t y1, const int64_t x2, const int64_t y2,
+               const RGBA color)
+{
+    const int64_t delta_x = std::abs(x2 - x1);
+    const int64_t delta_y = -std::abs(y2 - y1);
+    const int64_t switch_x = x1 < x2 ? 1 : -1;
+    const int64_t switch_y = y1 < y2 ? 1 : -1;
+    int64_t error = delta_x + delta_y;
+
+    while (true)
+    {
+        image.setPixel(x1, y1, color);
+        if ((x1 == x2) && (y1 == y2))
+            break;
+
+        const int64_t error2 = 2 * error;
+
+        if (error2 > delta_y)
+        {
+            error += delta_y;
+            x1 += switch_x;
+        }
+        if (error2 < delta_x)
+        {
+            error += delta_x;
+            y1 += switch_y;
+        }
+    }
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // shapes of every kind all over the image and the margin around it
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int64_t> dist_x(-Margin, Width + Margin - 1);
+    std::uniform_int_distribution<int64_t> dist_y(-Margin, Height + Margin - 1);
+    std::vector<Shape> shapes;
+
+    for (int64_t i = 0; i < 400; ++i)
+        shapes.push_back({i % 4, dist_x(random), dist_y(random), dist_x(random), dist_y(random),
+                          dist_x(random), dist_y(random), i % 3 != 0});
+
+    // the lines are the same Bresenham lines as before, clipped or not
+    bool ok = true;
+
+    for (const Shape &s : shapes)
+    {
+        Image::Picture expected(Width + 2 * Margin, Height + 2 * Margin);
+        Image::Picture image(Width + 2 * Margin, Height + 2 * Margin);
+        Image::Picture clipped(Width, Height);
+
+        bresenham(expected, s.x1 + Margin, s.y1 + Margin, s.x2 + Margin, s.y2 + Margin,
+                  RGBA(RGBA::White));
+        image.setLine(s.x1 + Margin, s.y1 + Margin, s.x2 + Margin, s.y2 + Margin,
+                      RGBA(RGBA::White));
+        clipped.setLine(s.x1, s.y1, s.x2, s.y2, RGBA(RGBA::White));
+        ok &= (image == expected) &&
+              (clipped.view() == expected.view(Margin, Margin, Width, Height));
+    }
+    std::cout << "lines: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // every shape on the image is the part of it that would be drawn on a big enough one, and
+    // only what is inside of the clip rectangle
+    Image::Picture big(Width + 2 * Margin, Height + 2 * Margin);
+    Image::Picture listed(Width, Height);
+    Image::Picture partly(Width, Height);
+    TestCase::Canvases canvases(Width, Height);
+    Image::DisplayList list;
+
+    partly.setClip(-10, 20, 70, 1000);
+    ok = true;
+    for (size_t i = 0; i < shapes.size(); ++i)
+    {
+        const Shape &s = shapes[i];
+
+        // only refused when it misses the image entirely
+        const int64_t x3 = s.kind == 1 ? s.x3 : s.x2;
+        const int64_t y3 = s.kind == 1 ? s.y3 : s.y2;
+        const bool missed = (s.kind == 3) || (std::max({s.x1, s.x2, x3}) < 0) ||
+                            (std::max({s.y1, s.y2, y3}) < 0) ||
+                            (std::min({s.x1, s.x2, x3}) >= Width) ||
+                            (std::min({s.y1, s.y2, y3}) >= Height);
+
+        canvases.draw(i, [&](auto &canvas, const auto color)
+        {
+            ok &= draw(canvas, s, 0, color) || missed;
+        });
+        draw(big, s, Margin, TestCase::color(i));
+        draw(partly, s, 0, TestCase::color(i));
+        draw(list, s, 0, TestCase::color(i));
+    }
+    listed.draw(list);
+
+    const Image::Picture expected(big.view(Margin, Margin, Width, Height).pixels(), Width,
+                                  Height);
+
+    ok &= canvases.matches(expected) && (listed == expected);
+    for (int64_t y = 0; y < Height; ++y)
+        for (int64_t x = 0; x < Width; ++x)
+            ok &= partly.pixel(x, y) == ((x < 60) && (y >= 20) ? expected.pixel(x, y) :
+                                                                  RGBA(RGBA::Black));
+    std::cout << "shapes: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // the clip rectangle itself, a display list keeps to it as well
+    Image::Picture small(40, 30);
+    Image::Picture small_listed(40, 30);
+    Image::DisplayList fill;
+    const Image::Base::Rect whole = small.clip();
+
+    fill.setRectangle(-5, -5, 50, 50, RGBA(RGBA::Red), true);
+    small.setClip(5, 6, 10, 7);
+    small_listed.setClip(5, 6, 10, 7);
+    small_listed.draw(fill);
+
+    const Image::Base::Rect rect = small.clip();
+
+    ok = (whole.x == 0) && (whole.y == 0) && (whole.width == 40) && (whole.height == 30) &&
+         (rect.x == 5) && (rect.y == 6) && (rect.width == 10) && (rect.height == 7) &&
+         small.setRectangle(-5, -5, 50, 50, RGBA(RGBA::Red), true) && (small == small_listed) &&
+         (small.pixel(5, 6) == RGBA(RGBA::Red)) && (small.pixel(14, 12) == RGBA(RGBA::Red)) &&
+         (small.pixel(4, 6) == RGBA(RGBA::Black)) && (small.pixel(15, 12) == RGBA(RGBA::Black)) &&
+         (small.pixel(5, 13) == RGBA(RGBA::Black)) && !small.setPixel(4, 6, RGBA(RGBA::Red)) &&
+         !small.setLine(0, 0, 40, 5, RGBA(RGBA::Red)) && !small.setClip(0, 0, -1, 5);
+    small.resetClip();
+    ok &= (small.clip().width == 40) && small.setPixel(4, 6, RGBA(RGBA::Red)) &&
+          !small.setLine(0, 0, int64_t(1) << 40, 5, RGBA(RGBA::Red)) &&
+          !small.setTriangle(-1000, 0, -900, 5, -950, 50, RGBA(RGBA::Red), true);
+    std::cout << "clip rectangle: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // long lines through a big image, most of them only pass a corner of it, clipped pixel by
+    // pixel while stepping the whole line and by the built in clipping
+    std::uniform_int_distribution<int64_t> far_x(-5 * DefWidth, 6 * DefWidth);
+    std::uniform_int_distribution<int64_t> far_y(-5 * DefHeight, 6 * DefHeight);
+    std::vector<Shape> lines;
+    Image::Picture before(DefWidth, DefHeight);
+    Image::Picture after(DefWidth, DefHeight);
+
+    for (int64_t i = 0; i < DefLines; ++i)
+        lines.push_back({0, far_x(random), far_y(random), far_x(random), far_y(random), 0, 0,
+                         false});
+
+    const double before_time = TestCase::seconds([&]()
+    {
+        for (size_t i = 0; i < lines.size(); ++i)
+            bresenham(before, lines[i].x1, lines[i].y1, lines[i].x2, lines[i].y2,
+                      TestCase::color(i));
+    });
+    const double time = TestCase::seconds([&]()
+    {
+        for (size_t i = 0; i < lines.size(); ++i)
+            after.setLine(lines[i].x1, lines[i].y1, lines[i].x2, lines[i].y2, TestCase::color(i));
+    });
+
+    ok = after == before;
+    std::cout << DefLines << " long lines: per pixel " << before_time << "s, clipped " << time
+              << "s (" << before_time / time << "x): " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Image/Farbfeld.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 320;
+static const int64_t DefHeight = 200;
+
+int32_t main(int32_t argc, char **argv)
+{
+    const Image::Picture original = TestCase::gradient(DefWidth, DefHeight);
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // name, file, options and whether the pixels have to come back unchanged
+    const std::vector<std::tuple<std::string,std::string,Image::CodecOptions,bool>> cases = {
+        {"farbfeld", "codec_test.ff", {}, true},
+        {"ppm", "codec_test.ppm", {{"wide", "yes"}, {"binary", "yes"}}, true},
+        {"ppm", "codec_test.ppm", {{"binary", "no"}, {"comment", "codec test"}}, false},
+        {"simple00", "codec_test.sp0", {}, false},
+        {"simple01", "codec_test.sp1", {}, false},
+        {"simple02", "codec_test.sp2", {}, false},
+        {"targa", "codec_test.tga", {{"type", "truecolor-rle"}}, false},
+        {"targa", "codec_test.TGA", {{"type", "mapped"}}, false}
+    };
+
+    for (auto &[name, filename, options, exact] : cases)
+    {
+        Image::Picture out(original);
+        Image::Picture in;
+
+        out.setOptions(options);
+
+        const auto codec = Image::Codecs::byExtension(filename);
+        const bool saved = out.save(filename);
+        const auto found = Image::Codecs::byContent(filename);
+        const bool ok = codec && (codec->name == name) && saved && found &&
+                        (found->name == name) && in.load(filename) &&
+                        (in.width() == DefWidth) && (in.height() == DefHeight) &&
+                        (!exact || (in == original));
+
+        std::cout << name << " as " << filename << ": " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+        std::remove(filename.c_str());
+    }
+
+    // neither loading nor handing a picture to a format copies the pixels
+    Image::Picture picture(original);
+    const Image::Farbfeld farbfeld(picture);
+    bool ok = (picture.pixels().data() == original.pixels().data()) &&
+              (farbfeld.pixels().data() == original.pixels().data());
+
+    std::cout << "shared pixels: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // options the encoder does not know are ignored, values it does not know are not
+    ok = false;
+    picture.setOptions({{"type", "sepia"}, {"unknown", "whatever"}});
+    try
+    {
+        picture.save("codec_test.tga");
+    }
+    catch (const std::invalid_argument &)
+    {
+        ok = true;
+    }
+    std::remove("codec_test.tga");
+    ok &= !picture.save("codec_test.unknown");
+
+    std::cout << "invalid options: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // codecs added at runtime are found like the built in ones
+    Image::Codecs::add({"null", {".null"}, nullptr, nullptr,
+        [](const Image::Base &image, const std::string &, const Image::CodecOptions &)
+        {
+            return image.width() > 0;
+        }, nullptr, nullptr, nullptr
+    });
+    ok = picture.save("codec_test.null") && Image::Codecs::byName("null");
+
+    std::cout << "added codec: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Image/Compact.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+using RGBA8 = Image::Compact::RGBA;
+
+static const int64_t DefWidth = 320;
+static const int64_t DefHeight = 200;
+
+int32_t main(int32_t argc, char **argv)
+{
+    // 8 bit data in 16 bit pixels, the alpha channel included, as a compact image promotes it
+    const Image::Picture original = TestCase::gradient(DefWidth, DefHeight, true, 0xFF00);
+    const Image::Compact compact(original);
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // the 8 bit loaders and the 16 bit ones followed by a demotion agree on every pixel
+    const std::vector<std::tuple<std::string,Image::CodecOptions>> files = {
+        {"compact_test.tga", {{"type", "truecolor"}}},
+        {"compact_test.tga", {{"type", "truecolor-rle"}}},
+        {"compact_test.tga", {{"type", "mono"}}},
+        {"compact_test.ppm", {{"binary", "yes"}}},
+        {"compact_test.ppm", {{"binary", "no"}}},
+        {"compact_test.ff", {}}
+    };
+
+    for (auto &[filename, options] : files)
+    {
+        Image::Picture picture(original);
+
+        picture.setOptions(options);
+        picture.save(filename);
+
+        const Image::Picture wide(filename);
+        const Image::Compact narrow(filename);
+        const bool ok = (narrow.width() == DefWidth) && (narrow.height() == DefHeight) &&
+                        (narrow == Image::Compact(wide)) &&
+                        (Image::Compact(narrow.promote()) == narrow);
+
+        std::cout << "loading " << filename << " (" << (options.empty() ? "" :
+                     options.begin()->second) << "): " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+        std::remove(filename.c_str());
+    }
+
+    bool ok = (compact.promote() == original) &&
+              ((compact.pixels().size() * sizeof (RGBA8) * 2) ==
+               (original.pixels().size() * sizeof (RGBA)));
+
+    std::cout << "promotion: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // what runs on 8 bit pixels has to give what the 16 bit image gives
+    const std::vector<std::tuple<std::string,std::function<void (Image::Compact &)>,
+                                 std::function<void (Image::Base &)>>> operations = {
+        {"lines", [](auto &image) { image.setLine(1, 2, 300, 150, RGBA8(RGBA8::Red)); },
+                  [](auto &image) { image.setLine(1, 2, 300, 150, RGBA::Red); }},
+        {"triangle", [](auto &image)
+            {
+                image.setTriangle(5, 5, 200, 40, 80, 190, RGBA8(RGBA8::Green), true);
+            },
+            [](auto &image) { image.setTriangle(5, 5, 200, 40, 80, 190, RGBA::Green, true); }},
+        {"circle", [](auto &image) { image.setCircle(100, 100, 50, RGBA8(RGBA8::Blue), true); },
+                   [](auto &image) { image.setCircle(100, 100, 50, RGBA::Blue, true); }},
+        {"flips", [](auto &image) { image.flipVertical(); image.flipHorizontal(); },
+                  [](auto &image) { image.flipVertical(); image.flipHorizontal(); }},
+        {"nearest", [](auto &image) { image.resize(97, 211, Image::Scaler::Nearest); },
+                    [](auto &image) { image.resize(97, 211, Image::Scaler::Nearest); }},
+        {"keep", [](auto &image) { image.resize(400, 100, Image::Scaler::Keep); },
+                 [](auto &image) { image.resize(400, 100, Image::Scaler::Keep); }}
+    };
+
+    for (auto &[name, narrow_operation, wide_operation] : operations)
+    {
+        Image::Compact narrow(compact);
+        Image::Picture wide(original);
+
+        narrow_operation(narrow);
+        wide_operation(wide);
+
+        ok = (narrow == Image::Compact(wide)) && (compact.promote() == original);
+
+        std::cout << name << ": " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+    }
+
+    return failed ? 1 : 0;
+}
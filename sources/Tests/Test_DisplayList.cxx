@@ -0,0 +1,174 @@
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include "Common/ThreadPool.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 3840;
+static const int64_t DefHeight = 2160;
+static const int64_t DefCommands = 200000;
+
+// overlapping primitives of every kind, a few of them reach outside of the image and are clipped
+void overlay(Image::DisplayList &list, const int64_t width, const int64_t height,
+             const int64_t count, const int64_t size, const uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int64_t> dist_x(-size / 8, width - 1);
+    std::uniform_int_distribution<int64_t> dist_y(-size / 8, height - 1);
+    std::uniform_int_distribution<int64_t> dist_offset(-size, size);
+    std::uniform_int_distribution<uint16_t> dist_color;
+
+    for (int64_t i = 0; i < count; ++i)
+    {
+        const int64_t x = dist_x(random);
+        const int64_t y = dist_y(random);
+        const int64_t x2 = std::min(x + dist_offset(random), width - 1);
+        const int64_t y2 = std::min(y + dist_offset(random), height - 1);
+        const int64_t x3 = std::min(x + dist_offset(random), width - 1);
+        const int64_t y3 = std::min(y + dist_offset(random), height - 1);
+        const int64_t radius = std::abs(dist_offset(random)) / 2;
+        const RGBA color(dist_color(random), dist_color(random), dist_color(random), 65535);
+
+        switch (i % 10)
+        {
+            case 0:
+                list.setPixel(x, y, color);
+                break;
+
+            case 1:
+            case 2:
+                list.setLine(x, y, x2, y2, color);
+                break;
+
+            case 3:
+            case 4:
+                list.setTriangle(x, y, x2, y2, x3, y3, color, i % 2);
+                break;
+
+            case 5:
+            case 6:
+                list.setRectangle(x, y, x2, y2, color, i % 2);
+                break;
+
+            case 7:
+            case 8:
+                list.setCircle(x, y, radius, color, i % 2);
+                break;
+
+            default:
+                list.setEllipse(x, y, radius, std::abs(y2 - y), color, i % 4 > 1);
+                break;
+        }
+    }
+}
+
+// what drawing the commands one after the other gives
+void immediate(Image::Base &image, const Image::DisplayList &list)
+{
+    using Primitive = Image::DisplayList::Primitive;
+
+    for (auto &c : list.commands())
+    {
+        switch (c.primitive)
+        {
+            case Primitive::Pixel:
+                image.setPixel(c.x1, c.y1, c.color);
+                break;
+
+            case Primitive::Line:
+                image.setLine(c.x1, c.y1, c.x2, c.y2, c.color);
+                break;
+
+            case Primitive::Triangle:
+                image.setTriangle(c.x1, c.y1, c.x2, c.y2, c.x3, c.y3, c.color, c.fill);
+                break;
+
+            case Primitive::Rectangle:
+                image.setRectangle(c.x1, c.y1, c.x2, c.y2, c.color, c.fill);
+                break;
+
+            case Primitive::Circle:
+                image.setCircle(c.x1, c.y1, c.x2, c.color, c.fill);
+                break;
+
+            case Primitive::Ellipse:
+                image.setEllipse(c.x1, c.y1, c.x2, c.y2, c.color, c.fill);
+                break;
+        }
+    }
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    const int64_t threads = Common::ThreadPool::hardwareThreads();
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // the test case drawn directly and from a display list, linear and tiled
+    Image::DisplayList list;
+    Image::Picture expected(TestCase::DefaultWidth, TestCase::DefaultHeight);
+    Image::Picture image(TestCase::DefaultWidth, TestCase::DefaultHeight);
+    Image::Picture tiled(TestCase::DefaultWidth, TestCase::DefaultHeight);
+
+    TestCase::applyToImageCase00(expected);
+    TestCase::recordCase00(list, TestCase::DefaultWidth, TestCase::DefaultHeight);
+    image.setThreads(threads);
+    image.draw(list);
+    tiled.setThreads(threads);
+    tiled.setLayout(Image::Layout::Tiled);
+    tiled.draw(list);
+    tiled.setLayout(Image::Layout::Linear);
+
+    bool ok = (image == expected) && (tiled == expected);
+
+    std::cout << "case 00: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // random primitives overlap a lot, so the order within the tiles matters
+    list.clear();
+    overlay(list, 300, 200, 3000, 120, 42);
+    expected = Image::Picture(300, 200);
+    image = Image::Picture(300, 200);
+    immediate(expected, list);
+    image.setThreads(threads);
+    image.draw(list);
+
+    // a copy sharing the pixels keeps them, the first draw makes its own
+    Image::Picture shared(image);
+
+    image.draw(list);
+    ok = (image == expected) && (shared == expected) && (list.size() > 2500);
+    std::cout << "overlay: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // at scale, the test case at 4K and a big overlay on top of it
+    Image::Picture direct(DefWidth, DefHeight);
+    Image::Picture single(DefWidth, DefHeight);
+    Image::Picture parallel(DefWidth, DefHeight);
+
+    list.clear();
+    TestCase::recordCase00(list, DefWidth, DefHeight);
+    overlay(list, DefWidth, DefHeight, DefCommands, 200, 7);
+    parallel.setThreads(threads);
+
+    const double direct_time = TestCase::seconds([&]() { immediate(direct, list); });
+    const double single_time = TestCase::seconds([&]() { single.draw(list); });
+    const double parallel_time = TestCase::seconds([&]() { parallel.draw(list); });
+
+    ok = (single == direct) && (parallel == direct);
+    std::cout << list.size() << " commands: direct " << direct_time << "s, display list "
+              << single_time << "s, " << threads << " threads " << parallel_time << "s ("
+              << direct_time / parallel_time << "x): " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
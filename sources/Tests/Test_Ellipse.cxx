@@ -0,0 +1,228 @@
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Image/DrawDetail.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 1920;
+static const int64_t DefHeight = 1080;
+static const int64_t DefDiscs = 300000;
+
+struct Ellipse {
+    int64_t x, y, radius_x, radius_y;
+    bool fill;
+};
+
+// the rule spelled out for a single pixel, its center is inside of the ellipse grown by half a
+// pixel, on the outline the pixel further out in the next row or the one next to it is not
+bool inside(const Ellipse &e, const int64_t dx, const int64_t dy)
+{
+    const int64_t width2 = (2 * e.radius_x + 1) * (2 * e.radius_x + 1);
+    const int64_t height2 = (2 * e.radius_y + 1) * (2 * e.radius_y + 1);
+
+    return (std::abs(dx) <= e.radius_x) &&
+           (4 * dx * dx * height2 + 4 * dy * dy * width2 <= width2 * height2);
+}
+
+bool covered(const Ellipse &e, const int64_t x, const int64_t y)
+{
+    const int64_t dx = x - e.x;
+    const int64_t dy = y - e.y;
+
+    if (e.fill)
+        return inside(e, dx, dy);
+
+    return inside(e, dx, dy) && (!inside(e, dx, dy + (dy < 0 ? -1 : 1)) ||
+                                 !inside(e, dx + (dx < 0 ? -1 : 1), dy));
+}
+
+Image::Picture reference(const int64_t width, const int64_t height,
+                         const std::vector<Ellipse> &ellipses)
+{
+    Image::Picture image(width, height);
+
+    for (size_t i = 0; i < ellipses.size(); ++i)
+        for (int64_t y = 0; y < height; ++y)
+            for (int64_t x = 0; x < width; ++x)
+                if (covered(ellipses[i], x, y))
+                    image.setPixel(x, y, TestCase::color(i));
+
+    return image;
+}
+
+// the way filled circles were drawn before, a line for each of the rows of every octant step
+void midpointDisc(Image::Base &image, const int64_t x, const int64_t y, const int64_t radius,
+                  const RGBA color)
+{
+    int64_t f = 1 - radius;
+    int64_t delta_x = 0;
+    int64_t delta_y = -2 * radius;
+    int64_t xx = 0;
+    int64_t yy = radius;
+
+    image.setLine(x - radius, y, x + radius, y, color);
+    while (xx < yy)
+    {
+        if (f >= 0)
+        {
+            --yy;
+            delta_y += 2;
+            f += delta_y;
+        }
+        ++xx;
+        delta_x += 2;
+        f += delta_x + 1;
+
+        image.setLine(x - xx, y + yy, x + xx, y + yy, color);
+        image.setLine(x - xx, y - yy, x + xx, y - yy, color);
+        image.setLine(x - yy, y + xx, x + yy, y + xx, color);
+        image.setLine(x - yy, y - xx, x + yy, y - xx, color);
+    }
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // ellipses of all proportions, filled and outlined, many of them reach over the borders
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int64_t> dist_x(-30, 130);
+    std::uniform_int_distribution<int64_t> dist_y(-30, 110);
+    std::uniform_int_distribution<int64_t> dist_radius(0, 40);
+    std::vector<Ellipse> ellipses;
+
+    for (int64_t i = 0; i < 200; ++i)
+        ellipses.push_back({dist_x(random), dist_y(random), dist_radius(random),
+                            dist_radius(random), i % 3 != 0});
+
+    const Image::Picture expected = reference(100, 80, ellipses);
+    TestCase::Canvases canvases(100, 80);
+    bool ok = true;
+
+    for (size_t i = 0; i < ellipses.size(); ++i)
+    {
+        const Ellipse &e = ellipses[i];
+        const bool visible = (e.x + e.radius_x >= 0) && (e.x - e.radius_x < 100) &&
+                             (e.y + e.radius_y >= 0) && (e.y - e.radius_y < 80);
+
+        canvases.draw(i, [&](auto &canvas, const auto color)
+        {
+            ok &= canvas.setEllipse(e.x, e.y, e.radius_x, e.radius_y, color, e.fill) == visible;
+        });
+    }
+    ok &= canvases.matches(expected);
+
+    std::cout << "ellipses: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // circles are ellipses with two equal radii, too big ones are refused
+    Image::Picture circles(100, 80);
+    Image::Picture same(100, 80);
+
+    circles.setCircle(50, 40, 30, RGBA(RGBA::Red), true);
+    circles.setCircle(0, 79, 25, RGBA(RGBA::Green), false);
+    same.setEllipse(50, 40, 30, 30, RGBA(RGBA::Red), true);
+    same.setEllipse(0, 79, 25, 25, RGBA(RGBA::Green), false);
+    ok = (circles == same) && !circles.setCircle(50, 40, Image::Detail::MaxRadius + 1,
+                                                 RGBA(RGBA::Red), true);
+    std::cout << "circles: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // centers far outside of the guard band and the most negative radii are refused without
+    // computing a bounding box that would overflow, the same when they come in a display list
+    constexpr int64_t Far = std::numeric_limits<int64_t>::max();
+    Image::Picture unchanged(100, 80);
+    Image::DisplayList far;
+    TestCase::Canvases refused(100, 80);
+
+    ok = true;
+    for (const auto &[x, y, radius] : {std::tuple<int64_t,int64_t,int64_t>{Far, 40, 10},
+                                       {-Far - 1, 40, 10}, {50, Far, 10}, {50, -Far - 1, 10},
+                                       {50, 40, -Far - 1}})
+    {
+        refused.draw(0, [&](auto &canvas, const auto color)
+        {
+            ok &= !canvas.setEllipse(x, y, radius, radius, color, true);
+        });
+        far.setEllipse(x, y, radius, radius, RGBA(RGBA::Red), true);
+    }
+    unchanged.draw(far);
+    ok &= refused.matches(Image::Picture(100, 80)) && (unchanged == Image::Picture(100, 80));
+    std::cout << "far out: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // every row gets one span when filled and at most two for the outline, nothing overlaps
+    ok = true;
+    for (const bool fill : {true, false})
+    {
+        for (int64_t radius_x = 0; radius_x < 50; ++radius_x)
+        {
+            for (int64_t radius_y = 0; radius_y < 50; radius_y += 7)
+            {
+                std::vector<int64_t> spans(2 * radius_y + 1, 0);
+                std::vector<int64_t> pixels(2 * radius_y + 1, 0);
+                std::vector<int64_t> widths(2 * radius_y + 1, 0);
+
+                Image::Detail::drawEllipse(0, 0, radius_x, radius_y, fill,
+                                           [&](const int64_t x1, const int64_t x2, const int64_t y)
+                {
+                    ++spans[y + radius_y];
+                    pixels[y + radius_y] += x2 - x1 + 1;
+                });
+                for (int64_t dy = -radius_y; dy <= radius_y; ++dy)
+                    for (int64_t dx = -radius_x; dx <= radius_x; ++dx)
+                        widths[dy + radius_y] += covered({0, 0, radius_x, radius_y, fill}, dx,
+                                                         dy);
+                for (int64_t i = 0; i <= 2 * radius_y; ++i)
+                    ok &= (spans[i] >= 1) && (spans[i] <= (fill ? 1 : 2)) &&
+                          (pixels[i] == widths[i]);
+            }
+        }
+    }
+    std::cout << "spans: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // a heatmap overlay of small discs, inside of the image as the lines are not clipped
+    std::uniform_int_distribution<int64_t> disc_x(12, DefWidth - 13);
+    std::uniform_int_distribution<int64_t> disc_y(12, DefHeight - 13);
+    std::uniform_int_distribution<int64_t> disc_radius(2, 12);
+    std::vector<Ellipse> discs;
+    Image::Picture heatmap(DefWidth, DefHeight);
+    Image::Picture before(DefWidth, DefHeight);
+
+    for (int64_t i = 0; i < DefDiscs; ++i)
+    {
+        const int64_t radius = disc_radius(random);
+
+        discs.push_back({disc_x(random), disc_y(random), radius, radius, true});
+    }
+
+    const double time = TestCase::seconds([&]()
+    {
+        for (size_t i = 0; i < discs.size(); ++i)
+            heatmap.setCircle(discs[i].x, discs[i].y, discs[i].radius_x, TestCase::color(i), true);
+    });
+    const double before_time = TestCase::seconds([&]()
+    {
+        for (size_t i = 0; i < discs.size(); ++i)
+            midpointDisc(before, discs[i].x, discs[i].y, discs[i].radius_x, TestCase::color(i));
+    });
+
+    std::cout << DefDiscs << " discs of up to 12 pixels radius: lines " << before_time
+              << "s, spans " << time << "s (" << before_time / time << "x)" << std::endl;
+
+    return failed ? 1 : 0;
+}
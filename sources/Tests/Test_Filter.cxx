@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "Image/Farbfeld.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 3840;
+static const int64_t DefHeight = 2160;
+static const int64_t DefThreads = 1;
+
+void showHelp(const char *name)
+{
+    std::cout << "usage: " << name << " [options]\n"
+              << "options:\n"
+              << "  --help               this help screen\n"
+              << "  --width=<width>      uses this width instead of the default '" << DefWidth
+                << "'\n"
+              << "  --height=<height>    uses this height instead of the default '" << DefHeight
+                << "'\n"
+              << "  --threads=<num>      amount of threads to filter with (default: " << DefThreads
+                << ", 0 uses all cores)\n"
+              << std::endl;
+}
+
+// the original float implementation of Base::implFilter, every filter has to match it exactly
+Image::Base::Pixels reference(const Image::Base::Pixels &pixels, const int64_t width,
+                              const int64_t height, const std::vector<float> &kernel)
+{
+    Image::Base::Pixels result(width * height, RGBA::Black);
+    const std::vector<int64_t> indices = {-(width + 1), -width, -(width - 1), -1 , 0, 1,
+                                          width - 1, width, width + 1};
+    float factor = .0;
+
+    for (auto k : kernel)
+        factor += k;
+    if (factor == .0)
+        factor = 1.0;
+
+    for (int64_t y = 1; y < (height - 1); ++y)
+    {
+        for (int64_t x = 1; x < (width - 1); ++x)
+        {
+            const int64_t pos = y * width + x;
+            float red = .0;
+            float green = .0;
+            float blue = .0;
+
+            for (size_t k = 0; k < kernel.size(); ++k)
+            {
+                const RGBA pixel = pixels[pos + indices[k]];
+
+                red += pixel.r * kernel[k];
+                green += pixel.g * kernel[k];
+                blue += pixel.b * kernel[k];
+            }
+
+            result[pos].r = std::clamp<int64_t>(red / factor, 0, 0xFFFF);
+            result[pos].g = std::clamp<int64_t>(green / factor, 0, 0xFFFF);
+            result[pos].b = std::clamp<int64_t>(blue / factor, 0, 0xFFFF);
+            result[pos].a = pixels[pos].a;
+        }
+    }
+
+    return result;
+}
+
+int64_t borderIndex(int64_t pos, const int64_t size, const Image::Border border)
+{
+    while ((pos < 0) || (pos >= size))
+    {
+        if (border == Image::Border::Wrap)
+            pos = ((pos % size) + size) % size;
+        else if ((border == Image::Border::Mirror) && (size > 1))
+            pos = pos < 0 ? -pos : 2 * (size - 1) - pos;
+        else
+            pos = std::clamp<int64_t>(pos, 0, size - 1);
+    }
+
+    return pos;
+}
+
+// brute force convolution, the optimized one may only differ by rounding
+Image::Base::Pixels reference(const Image::Base::Pixels &pixels, const int64_t width,
+                              const int64_t height, const Image::Kernel &kernel,
+                              const Image::Border border)
+{
+    Image::Base::Pixels result(width * height);
+    const int64_t radius = kernel.radius();
+
+    for (int64_t y = 0; y < height; ++y)
+    {
+        for (int64_t x = 0; x < width; ++x)
+        {
+            double sum[4] = {0, 0, 0, 0};
+
+            for (int64_t ky = 0; ky < kernel.size(); ++ky)
+            {
+                for (int64_t kx = 0; kx < kernel.size(); ++kx)
+                {
+                    const RGBA pixel = pixels[borderIndex(y + ky - radius, height, border) * width +
+                                              borderIndex(x + kx - radius, width, border)];
+                    const double weight = kernel.weight(kx, ky);
+
+                    sum[0] += pixel.r * weight;
+                    sum[1] += pixel.g * weight;
+                    sum[2] += pixel.b * weight;
+                    sum[3] += pixel.a * weight;
+                }
+            }
+
+            for (auto &val : sum)
+                val = std::clamp(val, .0, 65535.0) + .5;
+            result[y * width + x].set(static_cast<uint16_t>(sum[0]), static_cast<uint16_t>(sum[1]),
+                                      static_cast<uint16_t>(sum[2]), static_cast<uint16_t>(sum[3]));
+        }
+    }
+
+    return result;
+}
+
+bool similar(const Image::Base::Pixels &pixels1, const Image::Base::Pixels &pixels2)
+{
+    auto diff = [](const uint16_t c1, const uint16_t c2){ return std::abs(c1 - c2) > 1; };
+
+    for (size_t i = 0; i < pixels1.size(); ++i)
+    {
+        const RGBA &p1 = pixels1[i];
+        const RGBA &p2 = pixels2[i];
+
+        if (diff(p1.r, p2.r) || diff(p1.g, p2.g) || diff(p1.b, p2.b) || diff(p1.a, p2.a))
+            return false;
+    }
+
+    return pixels1.size() == pixels2.size();
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    const std::vector<std::tuple<std::string,Image::Filter,std::vector<float>>> filters = {
+        {"smooth", Image::Filter::Smooth, {1, 1, 1, 1, 2, 1, 1, 1, 1}},
+        {"sharpen", Image::Filter::Sharpen, {-1, -1, -1, -1, 9, -1, -1, -1, -1}},
+        {"edge", Image::Filter::Edge, {-1, -1, -1, -1, 8, -1, -1, -1, -1}},
+        {"blur", Image::Filter::Blur, {0, 0, 1, 0, 0, 0, 1, 0, 0}},
+        {"raised", Image::Filter::Raised, {0, 0, -2, 0, 2, 0, 1, 0, 0}}
+    };
+    int64_t width = DefWidth;
+    int64_t height = DefHeight;
+    int64_t threads = DefThreads;
+    bool failed = false;
+
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+
+        try
+        {
+            if (arg == "--help")
+            {
+                showHelp(argv[0]);
+                return 0;
+            }
+
+            if (arg.substr(0, 8) == "--width=")
+                width = std::max(std::stoll(arg.substr(8, std::string::npos)), 3ll);
+
+            if (arg.substr(0, 9) == "--height=")
+                height = std::max(std::stoll(arg.substr(9, std::string::npos)), 3ll);
+
+            if (arg.substr(0, 10) == "--threads=")
+                threads = std::stoll(arg.substr(10, std::string::npos));
+        }
+        catch (...)
+        {
+            std::cerr << "ERROR: unable to parse '" << arg << "', using the default" << std::endl;
+        }
+    }
+
+    std::mt19937_64 random(width * height);
+    Image::Base::Pixels pixels(width * height);
+
+    for (auto &pixel : pixels)
+        pixel.value = random();
+
+    for (auto &[name, filter, kernel] : filters)
+    {
+        Image::Farbfeld image(pixels, width, height);
+
+        image.setThreads(threads);
+
+        const double time = 1000.0 * TestCase::seconds([&]() { image.filter(filter); });
+        const bool match = image.pixels() == reference(pixels, width, height, kernel);
+
+        std::cout << name << ": " << (match ? "ok" : "MISMATCH") << ", " << time
+                  << " ms, " << (width * height / time / 1000.0) << " Mpixels/s"
+                  << std::endl;
+        failed |= !match;
+
+        // the tiled layout has to give the very same image
+        Image::Farbfeld tiled(pixels, width, height);
+
+        tiled.setThreads(threads);
+        tiled.setLayout(Image::Layout::Tiled);
+
+        const double tiled_time = 1000.0 * TestCase::seconds([&]() { tiled.filter(filter); });
+        const bool tiled_match = tiled == image;
+
+        std::cout << name << " (tiled): " << (tiled_match ? "ok" : "MISMATCH") << ", "
+                  << tiled_time << " ms, "
+                  << (width * height / tiled_time / 1000.0) << " Mpixels/s" << std::endl;
+        failed |= !tiled_match;
+    }
+
+    {
+        // drawing, blurring and resizing work on tiled images as well
+        Image::Farbfeld linear(pixels, width, height);
+        Image::Farbfeld tiled(pixels, width, height);
+
+        tiled.setLayout(Image::Layout::Tiled);
+        for (auto image : {&linear, &tiled})
+        {
+            image->setRectangle(1, 1, width - 2, height - 2, RGBA::Black, false);
+            image->setRectangle(width / 5, height / 5, width / 2, height / 2, RGBA::Black, true);
+            image->setLine(0, height - 1, width - 1, 0, RGBA::Black);
+            image->setCircle(width / 2, height / 2, std::min(width, height) / 3, RGBA::Black,
+                             false);
+            image->setPixel(width - 1, height - 1, RGBA::Black);
+            image->filter(Image::Filter::GaussianBlur, 5);
+            image->resize(width * 2 / 3, height * 2 / 3, Image::Scaler::Bilinear);
+        }
+
+        const bool match = (tiled.layout() == Image::Layout::Tiled) && (tiled == linear);
+
+        tiled.setLayout(Image::Layout::Linear);
+
+        const bool pixels_match = tiled.pixels() == linear.pixels();
+
+        std::cout << "tiled drawing: " << (match && pixels_match ? "ok" : "MISMATCH") << std::endl;
+        failed |= !match || !pixels_match;
+    }
+
+    const std::vector<std::tuple<std::string,Image::Border>> borders = {
+        {"clamp", Image::Border::Clamp},
+        {"wrap", Image::Border::Wrap},
+        {"mirror", Image::Border::Mirror}
+    };
+    const std::vector<std::tuple<std::string,Image::Kernel>> kernels = {
+        {"gaussian 7x7", Image::Kernel::gaussian(3)},
+        {"laplace 5x5", Image::Kernel({0, 0, -1, 0, 0, 0, -1, -2, -1, 0, -1, -2, 17, -2, -1,
+                                       0, -1, -2, -1, 0, 0, 0, -1, 0, 0})}
+    };
+    const int64_t small_width = std::min<int64_t>(width, 203);
+    const int64_t small_height = std::min<int64_t>(height, 97);
+    Image::Base::Pixels small_pixels(small_width * small_height);
+
+    for (auto &pixel : small_pixels)
+        pixel.value = random();
+
+    for (auto &[kname, kernel] : kernels)
+    {
+        for (auto &[bname, border] : borders)
+        {
+            Image::Farbfeld image(small_pixels, small_width, small_height);
+
+            image.setThreads(threads);
+            image.convolve(kernel, border);
+
+            const bool match = similar(image.pixels(), reference(small_pixels, small_width,
+                                       small_height, kernel, border));
+
+            std::cout << kname << (kernel.separable() ? " (separable) " : " ") << bname << ": "
+                      << (match ? "ok" : "MISMATCH") << std::endl;
+            failed |= !match;
+        }
+    }
+
+    for (int64_t radius : {1, 4, 11, 150})
+    {
+        Image::Farbfeld image1(small_pixels, small_width, small_height);
+        Image::Farbfeld image2(small_pixels, small_width, small_height);
+
+        image1.setThreads(threads);
+        image1.filter(Image::Filter::BoxBlur, radius);
+        image2.convolve(Image::Kernel::box(radius), Image::Border::Clamp);
+
+        const bool match = similar(image1.pixels(), image2.pixels());
+
+        std::cout << "box blur " << radius << ": " << (match ? "ok" : "MISMATCH") << std::endl;
+        failed |= !match;
+    }
+
+    // a constant image stays the same however large the window, one far larger than the image
+    // costs no more than any other
+    for (int64_t radius : {32768, 40000, 1000000, 100000000})
+    {
+        bool match = true;
+
+        for (const RGBA &color : {RGBA(RGBA::White), RGBA(12345, 54321, 1, 65534)})
+        {
+            Image::Farbfeld image(Image::Base::Pixels(64 * 64, color), 64, 64);
+
+            image.setThreads(threads);
+            image.filter(Image::Filter::BoxBlur, radius);
+            match &= image.pixels() == Image::Base::Pixels(64 * 64, color);
+        }
+
+        std::cout << "constant box blur " << radius << ": " << (match ? "ok" : "MISMATCH")
+                  << std::endl;
+        failed |= !match;
+    }
+
+    for (int64_t radius : {2, 20, 200})
+    {
+        Image::Farbfeld image(pixels, width, height);
+
+        image.setThreads(threads);
+
+        const double time = 1000.0 * TestCase::seconds([&]()
+        {
+            image.filter(Image::Filter::GaussianBlur, radius);
+        });
+
+        std::cout << "gaussian blur " << radius << ": " << time << " ms, "
+                  << (width * height / time / 1000.0) << " Mpixels/s" << std::endl;
+    }
+
+    {
+        // the box passes have to beat the 15x15 kernel they stand in for at the same radius
+        Image::Farbfeld image1(pixels, width, height);
+        Image::Farbfeld image2(pixels, width, height);
+
+        image1.setThreads(threads);
+        image2.setThreads(threads);
+
+        const double time1 = 1000.0 * TestCase::seconds([&]()
+        {
+            image1.filter(Image::Filter::GaussianBlur, 7);
+        });
+        const double time2 = 1000.0 * TestCase::seconds([&]()
+        {
+            image2.convolve(Image::Kernel::gaussian(7), Image::Border::Mirror);
+        });
+        const bool faster = time1 < time2;
+
+        std::cout << "gaussian 15x15: " << time2 << " ms, "
+                  << (width * height / time2 / 1000.0) << " Mpixels/s" << std::endl;
+        std::cout << "gaussian blur 7 vs 15x15: " << time1 << " ms, "
+                  << (time2 / time1) << "x: " << (faster ? "ok" : "SLOWER") << std::endl;
+        failed |= !faster;
+    }
+
+    return failed ? 1 : 0;
+}
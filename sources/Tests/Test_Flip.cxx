@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Common/ThreadPool.hxx"
+#include "Image/Compact.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 4000;
+static const int64_t DefHeight = 3000;
+static const int64_t Rounds = 10;
+
+// the pixels of the rectangle go upside down or get mirrored, the plain way
+Image::Picture reference(const Image::Base &image, const bool vertical, const int64_t x0 = 0,
+                         const int64_t y0 = 0, int64_t width = -1, int64_t height = -1)
+{
+    Image::Picture result(image);
+
+    width = width < 0 ? image.width() : width;
+    height = height < 0 ? image.height() : height;
+    for (int64_t y = 0; y < height; ++y)
+        for (int64_t x = 0; x < width; ++x)
+            result.setPixel(x0 + x, y0 + y, vertical ? image.pixel(x0 + x, y0 + height - 1 - y) :
+                                                       image.pixel(x0 + width - 1 - x, y0 + y));
+
+    return result;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    const int64_t threads = Common::ThreadPool::hardwareThreads();
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // sizes that are no multiple of the registers, a single row and a single column
+    const std::vector<std::tuple<int64_t,int64_t>> sizes = {
+        {37, 21}, {16, 16}, {1, 19}, {23, 1}, {2, 2}, {1200, 7}
+    };
+
+    for (const bool vertical : {true, false})
+    {
+        bool ok = true;
+
+        for (auto &[width, height] : sizes)
+        {
+            const Image::Picture original = TestCase::pattern(width, height);
+            const Image::Picture expected = reference(original, vertical);
+            Image::Picture image(original);
+            Image::Picture tiled(original);
+            Image::Compact compact(original);
+
+            image.setThreads(threads);
+            tiled.setLayout(Image::Layout::Tiled);
+            if (vertical)
+            {
+                image.flipVertical();
+                tiled.flipVertical();
+                compact.flipVertical(threads);
+            }
+            else
+            {
+                image.flipHorizontal();
+                tiled.flipHorizontal();
+                compact.flipHorizontal(threads);
+            }
+            tiled.setLayout(Image::Layout::Linear);
+
+            ok &= (image == expected) && (tiled == expected) &&
+                  (compact == Image::Compact(expected)) &&
+                  (original == TestCase::pattern(width, height));
+
+            // a view only flips its rectangle, the pixels around it stay
+            if ((width > 2) && (height > 2))
+            {
+                Image::Picture part(original);
+                const Image::MutableImageView view = part.mutableView(1, 1, width - 2,
+                                                                      height - 2);
+
+                if (vertical)
+                    view.flipVertical(threads);
+                else
+                    view.flipHorizontal(threads);
+                ok &= part == reference(original, vertical, 1, 1, width - 2, height - 2);
+            }
+        }
+
+        std::cout << (vertical ? "flip vertical: " : "flip horizontal: ")
+                  << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+    }
+
+    //
+    // a flip reads and writes every byte of the image once in place, the ceiling for that is
+    // memmove() moving the pixels in place by one, a copy into another buffer is no measure as it
+    // has to fetch the cache lines it writes and fault in the pages of the new buffer, the loops
+    // the flips replaced are timed along
+    //
+    Image::Picture image = TestCase::pattern(DefWidth, DefHeight);
+    const double bytes = DefWidth * DefHeight * sizeof (RGBA) * 2.0;
+    RGBA *pixels = image.mutableView().data();
+    const RGBA first = pixels[0];
+    bool back = false;
+
+    // the rounds move the pixels back and forth, only the first one is lost on the way
+    const double move_time = TestCase::seconds([&]()
+    {
+        void *target = back ? pixels + 1 : pixels;
+        void *source = back ? pixels : pixels + 1;
+
+        std::memmove(target, source, (DefWidth * DefHeight - 1) * sizeof (RGBA));
+        back = !back;
+    }, Rounds);
+
+    pixels[0] = first;
+    const double reverse_time = TestCase::seconds([&]()
+    {
+        for (int64_t y = 0; y < DefHeight; ++y)
+            std::reverse(pixels + y * DefWidth, pixels + (y + 1) * DefWidth);
+    }, Rounds);
+    const double swap_time = TestCase::seconds([&]()
+    {
+        for (int64_t y = 0; y < DefHeight / 2; ++y)
+            std::swap_ranges(pixels + y * DefWidth, pixels + (y + 1) * DefWidth,
+                             pixels + (DefHeight - 1 - y) * DefWidth);
+    }, Rounds);
+    const double vertical_time = TestCase::seconds([&]() { image.flipVertical(); }, Rounds);
+    const double horizontal_time = TestCase::seconds([&]() { image.flipHorizontal(); }, Rounds);
+
+    image.setThreads(threads);
+    const double vertical_threads = TestCase::seconds([&]() { image.flipVertical(); }, Rounds);
+    const double horizontal_threads = TestCase::seconds([&]() { image.flipHorizontal(); }, Rounds);
+
+    // every flip ran an even number of times
+    bool ok = image == TestCase::pattern(DefWidth, DefHeight);
+
+    std::cout << "memmove " << bytes / move_time / 1e9 << " GB/s" << std::endl;
+    std::cout << "vertical: row swaps " << bytes / swap_time / 1e9 << " GB/s, flip "
+              << bytes / vertical_time / 1e9 << " GB/s (" << move_time / vertical_time
+              << " of the move), " << threads << " threads " << bytes / vertical_threads / 1e9
+              << " GB/s" << std::endl;
+    std::cout << "horizontal: reverse " << bytes / reverse_time / 1e9 << " GB/s, flip "
+              << bytes / horizontal_time / 1e9 << " GB/s (" << move_time / horizontal_time
+              << " of the move), " << threads << " threads " << bytes / horizontal_threads / 1e9
+              << " GB/s" << std::endl;
+    std::cout << "round trip: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
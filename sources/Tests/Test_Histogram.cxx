@@ -0,0 +1,118 @@
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include "Color/Histogram.hxx"
+#include "Common/ThreadPool.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 4000;
+static const int64_t DefHeight = 3000;
+
+// a gradient with noise has plenty of colors and only short runs of one color
+Image::Picture noise(const int64_t width, const int64_t height)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<uint16_t> dist(0, 255);
+    Image::Picture image(width, height);
+
+    for (int64_t y = 0; y < height; ++y)
+        for (int64_t x = 0; x < width; ++x)
+            image.setPixel(x, y, RGBA(x * 16 + dist(random), y * 16 + dist(random),
+                                      (x + y) * 8, 65535));
+
+    return image;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    Image::Picture image = noise(DefWidth, DefHeight);
+    const RGBA *pixels = image.pixels().data();
+    const int64_t threads = Common::ThreadPool::hardwareThreads();
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // the ordered map every counter used before
+    std::map<uint64_t,uint64_t> reference;
+    const double map_time = TestCase::seconds([&]()
+    {
+        for (auto &pixel : image.pixels())
+            ++reference[pixel.value];
+    });
+
+    int64_t single = 0;
+    int64_t parallel = 0;
+    const double single_time = TestCase::seconds([&]()
+    {
+        single = Color::Histogram::countColors(pixels, DefWidth, DefHeight, DefWidth);
+    });
+    const double parallel_time = TestCase::seconds([&]()
+    {
+        image.setThreads(threads);
+        parallel = image.usedColors();
+    });
+
+    bool ok = (single == static_cast<int64_t>(reference.size())) && (parallel == single);
+
+    std::cout << "used colors " << single << ", map " << map_time << "s, table " << single_time
+              << "s (" << map_time / single_time << "x), " << threads << " threads "
+              << parallel_time << "s (" << map_time / parallel_time << "x): "
+              << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // the counts and their order are the ones of the map
+    const auto counts = Color::Histogram::colors(pixels, DefWidth, DefHeight, DefWidth, threads);
+
+    ok = std::equal(counts.begin(), counts.end(), reference.begin(), reference.end(),
+                    [](const auto &count, const auto &pair)
+    {
+        return (count.first == pair.first) && (count.second == pair.second);
+    });
+    std::cout << "color counts: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // every channel histogram counts every pixel once
+    const auto channels = Color::Histogram::channels(pixels, DefWidth, DefHeight, DefWidth,
+                                                     threads);
+
+    ok = channels[3][65535] == static_cast<uint64_t>(DefWidth * DefHeight);
+    for (auto &channel : channels)
+        ok &= std::accumulate(channel.begin(), channel.end(), uint64_t(0)) ==
+              static_cast<uint64_t>(DefWidth * DefHeight);
+    std::cout << "channels: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // a view of a part of the image only counts that part
+    const Image::ImageView view = image.view(10, 20, 30, 40);
+    std::map<uint64_t,uint64_t> part;
+
+    for (int64_t y = 0; y < view.height(); ++y)
+        for (int64_t x = 0; x < view.width(); ++x)
+            ++part[view.row(y)[x].value];
+
+    ok = Color::Histogram::countColors(view.data(), view.width(), view.height(), view.stride(),
+                                       threads) == static_cast<int64_t>(part.size()) &&
+         (Image::Picture(8, 8, RGBA(RGBA::Red)).usedColors() == 1) &&
+         (Image::Picture().usedColors() == 0);
+    std::cout << "views: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // the tiles hold the same pixels, only in another order
+    Image::Picture tiled(image);
+
+    tiled.setLayout(Image::Layout::Tiled);
+    ok = tiled.usedColors() == single;
+    std::cout << "tiles: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
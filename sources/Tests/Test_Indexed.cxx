@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Image/Indexed.hxx"
+#include "Image/Picture.hxx"
+#include "Image/Targa.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 320;
+static const int64_t DefHeight = 200;
+
+int32_t main(int32_t argc, char **argv)
+{
+    const Image::Picture original = TestCase::gradient(DefWidth, DefHeight, true);
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // the quantizer hands out the indices of the colors reduceColors() sets
+    Image::Indexed8 indexed;
+    const double time = TestCase::seconds([&]() { indexed = Image::Indexed8(original.view(), 256); });
+    Image::Picture reduced(original);
+
+    reduced.reduceColors(256, Image::Quantizer::MiddleCut);
+
+    bool ok = (indexed.width() == DefWidth) && (indexed.height() == DefHeight) &&
+              (indexed.palette().size() == 256) && (indexed.promote() == reduced);
+
+    std::cout << "quantize (" << time << "s): " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // an image with few colors keeps exactly these
+    Image::Picture few(16, 16, RGBA(RGBA::Red));
+
+    few.setRectangle(2, 2, 10, 10, RGBA(RGBA::Blue), true);
+    const Image::Indexed16 exact(few.view(), 256);
+
+    ok = (exact.palette().size() == 2) && (exact.promote() == few);
+    std::cout << "exact palette: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // blitting into a part of a bigger image only touches that part
+    Image::Picture target(DefWidth + 20, DefHeight + 20, RGBA(RGBA::White));
+
+    ok = indexed.blit(target, 10, 10) && !indexed.blit(target, 30, 30) &&
+         (target.pixel(5, 5) == RGBA(RGBA::White)) &&
+         (Image::Picture(target.view(10, 10, DefWidth, DefHeight).pixels(), DefWidth,
+                         DefHeight) == reduced);
+    std::cout << "blit: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // indices outside of the palette are refused
+    Image::Indexed8 copy(indexed);
+
+    ok = copy.setIndex(3, 4, 7) && (copy.index(3, 4) == 7) && (indexed != copy) &&
+         (copy.pixel(3, 4) == copy.palette()[7]) && !copy.setPalette({RGBA(RGBA::Black)}) &&
+         Image::Indexed8(16, 16, {RGBA(RGBA::Black)}).setPalette({RGBA(RGBA::Red)});
+    std::cout << "indices: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // the mapped Targa types write the indices and read them back as they are
+    for (const std::string type : {"mapped", "mapped-rle"})
+    {
+        const std::string filename = "indexed_test.tga";
+
+        indexed.save(filename, {{"type", type}});
+
+        const Image::Indexed8 loaded(filename);
+        const Image::Picture expanded(filename);
+
+        ok = (loaded == indexed) && (expanded == reduced);
+        std::cout << "targa " << type << ": " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+        std::remove(filename.c_str());
+    }
+
+    // saving a mapped Targa quantizes once, just like the indexed image does
+    Image::Targa targa(original);
+
+    targa.setImageType(Image::Targa::ImageType::Mapped);
+    targa.save("indexed_test.tga");
+    ok = Image::Indexed8("indexed_test.tga") == indexed;
+    std::cout << "targa save: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+    std::remove("indexed_test.tga");
+
+    // formats without indices get the expanded pixels
+    indexed.save("indexed_test.ff");
+    ok = Image::Picture("indexed_test.ff") == reduced;
+    std::cout << "farbfeld: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+    std::remove("indexed_test.ff");
+
+    return failed ? 1 : 0;
+}
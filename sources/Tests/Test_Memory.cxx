@@ -0,0 +1,146 @@
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "Common/BufferPool.hxx"
+#include "Image/Farbfeld.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 1920;
+static const int64_t DefHeight = 1080;
+static const int64_t DefFrames = 100;
+
+void showHelp(const char *name)
+{
+    std::cout << "usage: " << name << " [options]\n"
+              << "options:\n"
+              << "  --help               this help screen\n"
+              << "  --frames=<num>       amount of frames to push through (default: " << DefFrames
+                << ")\n"
+              << std::endl;
+}
+
+// what a batch server does with every frame, each step needs a buffer of the frame size
+void frames(const int64_t count, std::pmr::memory_resource *resource)
+{
+    for (int64_t i = 0; i < count; ++i)
+    {
+        Image::Farbfeld frame;
+
+        frame.setMemoryResource(resource);
+        frame.resize(DefWidth, DefHeight, Image::Scaler::Clear);
+        frame.setPixel(i % DefWidth, 0, RGBA::White);
+
+        Image::Farbfeld copy(frame);
+
+        copy.setPixel(0, 0, RGBA::Red);
+        copy.setLayout(Image::Layout::Tiled);
+    }
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    int64_t count = DefFrames;
+    bool failed = false;
+
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+
+        if (arg == "--help")
+        {
+            showHelp(argv[0]);
+            return 0;
+        }
+
+        if (arg.substr(0, 9) == "--frames=")
+            count = std::max<int64_t>(std::stoll(arg.substr(9, std::string::npos)), 1);
+    }
+
+    // freed blocks come back for the next request of the same size, small ones are never kept
+    for (const bool huge : {false, true})
+    {
+        Common::BufferPool pool(Common::BufferPool::DefaultLimit, huge);
+        const size_t big = 3 * Common::BufferPool::HugePageSize + 4096;
+        void *first = pool.allocate(big);
+        void *small = pool.allocate(256);
+
+        pool.deallocate(first, big);
+        pool.deallocate(small, 256);
+
+        void *second = pool.allocate(big);
+        const bool ok = (first == second) && (pool.cached() == 0) &&
+                        !(reinterpret_cast<uintptr_t>(second) % Common::BufferPool::Alignment) &&
+                        (!huge || !(reinterpret_cast<uintptr_t>(second) %
+                                    Common::BufferPool::HugePageSize));
+
+        static_cast<char *>(second)[big - 1] = 1;
+        pool.deallocate(second, big);
+
+        std::cout << "recycling" << (huge ? " with huge pages: " : ": ") << (ok ? "ok" : "FAILED")
+                  << std::endl;
+        failed |= !ok;
+    }
+
+    // nothing above the limit is kept
+    {
+        Common::BufferPool pool(Common::BufferPool::MinSize * 2);
+        void *first = pool.allocate(Common::BufferPool::MinSize * 2);
+        void *second = pool.allocate(Common::BufferPool::MinSize * 2);
+
+        pool.deallocate(first, Common::BufferPool::MinSize * 2);
+        pool.deallocate(second, Common::BufferPool::MinSize * 2);
+
+        bool ok = pool.cached() == Common::BufferPool::MinSize * 2;
+
+        pool.release();
+        ok &= pool.cached() == 0;
+
+        std::cout << "limit: " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+    }
+
+    // images keep to their resource through copies, resizes, layouts and loading
+    {
+        Common::BufferPool pool;
+        Image::Picture image(64, 64, RGBA::Blue);
+        Image::Picture loaded;
+
+        image.setMemoryResource(&pool);
+        image.setPixel(1, 1, RGBA::Red);
+        image.resize(128, 128, Image::Scaler::Nearest);
+        image.save("memory_test.ff");
+        loaded.setMemoryResource(&pool);
+        loaded.load("memory_test.ff");
+        std::remove("memory_test.ff");
+
+        Image::Picture copy(image);
+
+        copy.setPixel(2, 2, RGBA::Green);
+
+        const bool ok = (image.pixels().get_allocator().resource() == &pool) &&
+                        (loaded.pixels().get_allocator().resource() == &pool) &&
+                        (copy.pixels().get_allocator().resource() == &pool) && (loaded == image);
+
+        std::cout << "image buffers: " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+    }
+
+    const double standard = 1000.0 * TestCase::seconds([&]()
+    {
+        frames(count, std::pmr::get_default_resource());
+    });
+    const double pooled = 1000.0 * TestCase::seconds([&]()
+    {
+        frames(count, &Common::BufferPool::global());
+    });
+
+    std::cout << count << " frames of " << DefWidth << "x" << DefHeight << ": " << standard
+              << " ms with the default resource, " << pooled << " ms with the buffer pool"
+              << std::endl;
+
+    return failed ? 1 : 0;
+}
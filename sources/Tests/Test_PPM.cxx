@@ -182,6 +182,12 @@ int32_t main(int32_t argc, char **argv)
             ppm.setWideMode(wide);
             ppm.setBinaryMode(binary);
             ppm.save(filename);
+
+            const bool ok = TestCase::savesTiled(ppm, filename);
+
+            std::cout << "tiled: " << (ok ? "ok" : "FAILED") << std::endl;
+            if (!ok)
+                return 1;
         }
         else
         {
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <vector>
+#include "Image/Farbfeld.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 3840;
+static const int64_t DefHeight = 2160;
+static const int64_t DefThreads = 1;
+
+void showHelp(const char *name)
+{
+    std::cout << "usage: " << name << " [options]\n"
+              << "options:\n"
+              << "  --help               this help screen\n"
+              << "  --width=<width>      image width instead of the default '" << DefWidth << "'\n"
+              << "  --height=<height>    image height instead of the default '" << DefHeight
+                << "'\n"
+              << "  --threads=<num>      amount of threads to convert with (default: " << DefThreads
+                << ", 0 uses all cores)\n"
+              << std::endl;
+}
+
+// the planes have to hold the channels of the image and start aligned
+bool check(const Image::Planar &planar, const Image::Base &image)
+{
+    for (auto channel : {Image::Channel::Red, Image::Channel::Green, Image::Channel::Blue,
+                         Image::Channel::Alpha})
+        if (reinterpret_cast<uintptr_t>(planar.plane(channel)) % Image::Planar::Alignment)
+            return false;
+
+    if ((planar.width() != image.width()) || (planar.height() != image.height()))
+        return false;
+
+    for (int64_t y = 0; y < image.height(); ++y)
+    {
+        for (int64_t x = 0; x < image.width(); ++x)
+        {
+            const RGBA pixel = image.pixel(x, y);
+            const int64_t index = y * image.width() + x;
+
+            if ((planar.plane(Image::Channel::Red)[index] != pixel.r) ||
+                (planar.plane(Image::Channel::Green)[index] != pixel.g) ||
+                (planar.plane(Image::Channel::Blue)[index] != pixel.b) ||
+                (planar.plane(Image::Channel::Alpha)[index] != pixel.a) ||
+                (planar.pixel(x, y) != pixel))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    int64_t width = DefWidth;
+    int64_t height = DefHeight;
+    int64_t threads = DefThreads;
+    bool failed = false;
+
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+
+        try
+        {
+            if (arg == "--help")
+            {
+                showHelp(argv[0]);
+                return 0;
+            }
+
+            if (arg.substr(0, 8) == "--width=")
+                width = std::max(std::stoll(arg.substr(8, std::string::npos)), 1ll);
+
+            if (arg.substr(0, 9) == "--height=")
+                height = std::max(std::stoll(arg.substr(9, std::string::npos)), 1ll);
+
+            if (arg.substr(0, 10) == "--threads=")
+                threads = std::stoll(arg.substr(10, std::string::npos));
+        }
+        catch (...)
+        {
+            std::cerr << "ERROR: unable to parse '" << arg << "', using the default" << std::endl;
+        }
+    }
+
+    for (auto layout : {Image::Layout::Linear, Image::Layout::Tiled})
+    {
+        Image::Farbfeld image(TestCase::pattern(width, height));
+
+        image.setThreads(threads);
+        image.setLayout(layout);
+
+        Image::Planar planar;
+        const double split = 1000.0 * TestCase::seconds([&]() { planar = image.toPlanar(); });
+        bool ok = check(planar, image);
+
+        Image::Farbfeld copy(1, 1);
+        bool merged = false;
+
+        copy.setThreads(threads);
+        copy.setLayout(layout);
+        const double merge = 1000.0 * TestCase::seconds([&]()
+        {
+            merged = copy.fromPlanar(planar);
+        });
+        ok &= merged && (copy == image) && (copy.layout() == layout);
+
+        std::cout << (layout == Image::Layout::Linear ? "linear " : "tiled ") << width << "x"
+                  << height << ": " << (ok ? "ok" : "FAILED") << ", split " << split
+                  << " ms, merge " << merge << " ms" << std::endl;
+        failed |= !ok;
+    }
+
+    Image::Planar planar(3, 2);
+    const bool ok = planar.setPixel(2, 1, RGBA(1, 2, 3, 4)) && !planar.setPixel(3, 1, RGBA()) &&
+                    (planar.pixel(2, 1) == RGBA(1, 2, 3, 4)) && (planar.pixel(0, 0) == RGBA::Black);
+
+    std::cout << "pixel access: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
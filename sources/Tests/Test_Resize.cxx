@@ -0,0 +1,304 @@
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "Image/Farbfeld.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 3840;
+static const int64_t DefHeight = 2160;
+static const int64_t DefThreads = 1;
+
+void showHelp(const char *name)
+{
+    std::cout << "usage: " << name << " [options]\n"
+              << "options:\n"
+              << "  --help               this help screen\n"
+              << "  --width=<width>      source width instead of the default '" << DefWidth << "'\n"
+              << "  --height=<height>    source height instead of the default '" << DefHeight
+                << "'\n"
+              << "  --threads=<num>      amount of threads to scale with (default: " << DefThreads
+                << ", 0 uses all cores)\n"
+              << std::endl;
+}
+
+// a horizontal ramp in red, a vertical one in green and constant blue and alpha
+Image::Farbfeld ramp(const int64_t width, const int64_t height)
+{
+    Image::Farbfeld image(width, height);
+
+    for (int64_t y = 0; y < height; ++y)
+        for (int64_t x = 0; x < width; ++x)
+            image.setPixel(x, y, RGBA(x * 0xFFFF / (width - 1), y * 0xFFFF / (height - 1), 0x8000,
+                                      0xFFFF));
+
+    return image;
+}
+
+// constant channels have to stay constant and ramps must not jump by more than the scaled step
+bool check(const Image::Base &image, const int64_t src_width, const int64_t src_height)
+{
+    const int64_t max_step_x = 0xFFFF / (src_width - 1) * (src_width / image.width() + 2) + 2;
+    const int64_t max_step_y = 0xFFFF / (src_height - 1) * (src_height / image.height() + 2) + 2;
+
+    for (int64_t y = 0; y < image.height(); ++y)
+    {
+        for (int64_t x = 0; x < image.width(); ++x)
+        {
+            const RGBA pixel = image.pixel(x, y);
+
+            if ((std::abs(pixel.b - 0x8000) > 1) || (pixel.a < 0xFFFE))
+                return false;
+            if ((x > 0) && (std::abs(pixel.r - image.pixel(x - 1, y).r) > max_step_x))
+                return false;
+            if ((y > 0) && (std::abs(pixel.g - image.pixel(x, y - 1).g) > max_step_y))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// the filters the resamplers are built on, written out again from their definitions
+double bicubic(const double x)
+{
+    const double ax = std::abs(x);
+
+    if (ax < 1)
+        return 1.5 * ax * ax * ax - 2.5 * ax * ax + 1;
+    if (ax < 2)
+        return -0.5 * ax * ax * ax + 2.5 * ax * ax - 4 * ax + 2;
+
+    return 0;
+}
+
+double lanczos3(const double x)
+{
+    const double px = std::numbers::pi * x;
+
+    if (x == 0)
+        return 1;
+
+    return std::abs(x) < 3 ? std::sin(px) / px * std::sin(px / 3) / (px / 3) : 0;
+}
+
+//
+// the normalized filter weights of every source pixel for one output position, pixels beyond
+// the edges count as the edge pixel, a reduction stretches the filter over the source
+//
+std::vector<double> weights(const int64_t src_size, const int64_t dst_size, const int64_t i,
+                            double (*filter)(const double), const double support)
+{
+    const double scale = static_cast<double>(dst_size) / src_size;
+    const double stretch = std::min(scale, 1.0);
+    const double center = (i + .5) / scale;
+    std::vector<double> result(src_size, 0);
+    double sum = 0;
+
+    for (int64_t j = std::floor(center - support / stretch);
+         j <= std::ceil(center + support / stretch); ++j)
+    {
+        const double weight = filter((j + .5 - center) * stretch);
+
+        result[std::clamp<int64_t>(j, 0, src_size - 1)] += weight;
+        sum += weight;
+    }
+
+    for (auto &weight : result)
+        weight /= sum;
+
+    return result;
+}
+
+// a resampled image has to match the separable filter evaluated in double precision
+bool check(const Image::Base &image, const Image::Base &source, double (*filter)(const double),
+           const double support)
+{
+    std::vector<std::vector<double>> wx, wy;
+
+    for (int64_t x = 0; x < image.width(); ++x)
+        wx.push_back(weights(source.width(), image.width(), x, filter, support));
+    for (int64_t y = 0; y < image.height(); ++y)
+        wy.push_back(weights(source.height(), image.height(), y, filter, support));
+
+    for (int64_t y = 0; y < image.height(); ++y)
+    {
+        for (int64_t x = 0; x < image.width(); ++x)
+        {
+            double sums[4] = {0, 0, 0, 0};
+
+            for (int64_t sy = 0; sy < source.height(); ++sy)
+            {
+                for (int64_t sx = 0; sx < source.width(); ++sx)
+                {
+                    const RGBA pixel = source.pixel(sx, sy);
+                    const double weight = wx[x][sx] * wy[y][sy];
+
+                    sums[0] += pixel.r * weight;
+                    sums[1] += pixel.g * weight;
+                    sums[2] += pixel.b * weight;
+                    sums[3] += pixel.a * weight;
+                }
+            }
+
+            const RGBA pixel = image.pixel(x, y);
+            const int64_t channels[4] = {pixel.r, pixel.g, pixel.b, pixel.a};
+
+            for (int32_t c = 0; c < 4; ++c)
+                if (std::abs(channels[c] - std::clamp(std::round(sums[c]), .0, 65535.0)) > 1)
+                    return false;
+        }
+    }
+
+    return true;
+}
+
+// every level has to be the rounded 2x2 box of the one above, single pixel sides are repeated
+bool check(const Image::Pyramid &pyramid)
+{
+    for (int64_t level = 1; level < pyramid.levels(); ++level)
+    {
+        const int64_t src_width = pyramid.width(level - 1);
+        const int64_t src_height = pyramid.height(level - 1);
+
+        for (int64_t y = 0; y < pyramid.height(level); ++y)
+        {
+            for (int64_t x = 0; x < pyramid.width(level); ++x)
+            {
+                const RGBA p1 = pyramid.pixel(level - 1, x * 2, y * 2);
+                const RGBA p2 = pyramid.pixel(level - 1, std::min(x * 2 + 1, src_width - 1), y * 2);
+                const RGBA p3 = pyramid.pixel(level - 1, x * 2, std::min(y * 2 + 1, src_height - 1));
+                const RGBA p4 = pyramid.pixel(level - 1, std::min(x * 2 + 1, src_width - 1),
+                                              std::min(y * 2 + 1, src_height - 1));
+                const RGBA expected((p1.r + p2.r + p3.r + p4.r + 2) >> 2,
+                                    (p1.g + p2.g + p3.g + p4.g + 2) >> 2,
+                                    (p1.b + p2.b + p3.b + p4.b + 2) >> 2,
+                                    (p1.a + p2.a + p3.a + p4.a + 2) >> 2);
+
+                if (pyramid.pixel(level, x, y) != expected)
+                    return false;
+            }
+        }
+    }
+
+    return (pyramid.width(pyramid.levels() - 1) == 1) && (pyramid.height(pyramid.levels() - 1) == 1);
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    const std::vector<std::tuple<std::string,Image::Scaler>> scalers = {
+        {"nearest", Image::Scaler::Nearest},
+        {"fast billinear", Image::Scaler::FastBillinear},
+        {"bilinear", Image::Scaler::Bilinear},
+        {"bicubic", Image::Scaler::Bicubic},
+        {"lanczos3", Image::Scaler::Lanczos3},
+        {"area", Image::Scaler::Area}
+    };
+    int64_t width = DefWidth;
+    int64_t height = DefHeight;
+    int64_t threads = DefThreads;
+    bool failed = false;
+
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+
+        try
+        {
+            if (arg == "--help")
+            {
+                showHelp(argv[0]);
+                return 0;
+            }
+
+            if (arg.substr(0, 8) == "--width=")
+                width = std::max(std::stoll(arg.substr(8, std::string::npos)), 16ll);
+
+            if (arg.substr(0, 9) == "--height=")
+                height = std::max(std::stoll(arg.substr(9, std::string::npos)), 16ll);
+
+            if (arg.substr(0, 10) == "--threads=")
+                threads = std::stoll(arg.substr(10, std::string::npos));
+        }
+        catch (...)
+        {
+            std::cerr << "ERROR: unable to parse '" << arg << "', using the default" << std::endl;
+        }
+    }
+
+    const Image::Farbfeld source = ramp(width, height);
+    const std::vector<std::tuple<int64_t,int64_t>> sizes = {
+        {width / 2, height / 2}, {width / 8, height / 8}, {width * 3 / 2, height * 3 / 2}
+    };
+
+    for (auto &[name, scaler] : scalers)
+    {
+        for (auto &[w, h] : sizes)
+        {
+            Image::Farbfeld image(source);
+
+            image.setThreads(threads);
+
+            const double time = 1000.0 * TestCase::seconds([&]() { image.resize(w, h, scaler); });
+            const bool ok = check(image, width, height);
+
+            std::cout << name << " " << width << "x" << height << " -> " << w << "x" << h << ": "
+                      << (ok ? "ok" : "FAILED") << ", " << time << " ms" << std::endl;
+            failed |= !ok;
+        }
+    }
+
+    // random pixels reduced on one axis and enlarged on the other, small enough for the edges
+    // to reach into every output pixel of the larger kernels
+    const std::vector<std::tuple<std::string,Image::Scaler,double (*)(const double),double>>
+        filters = {
+            {"bicubic", Image::Scaler::Bicubic, bicubic, 2},
+            {"lanczos3", Image::Scaler::Lanczos3, lanczos3, 3}
+        };
+    const std::vector<std::tuple<int64_t,int64_t,int64_t,int64_t>> shapes = {
+        {53, 11, 19, 29}, {7, 40, 23, 5}
+    };
+    std::mt19937_64 random(width * height);
+
+    for (auto &[name, scaler, filter, support] : filters)
+    {
+        for (auto &[src_width, src_height, dst_width, dst_height] : shapes)
+        {
+            Image::Farbfeld noise(src_width, src_height);
+
+            for (int64_t y = 0; y < src_height; ++y)
+                for (int64_t x = 0; x < src_width; ++x)
+                    noise.setPixel(x, y, RGBA(random()));
+
+            Image::Farbfeld image(noise);
+
+            image.setThreads(threads);
+            image.resize(dst_width, dst_height, scaler);
+
+            const bool ok = check(image, noise, filter, support);
+
+            std::cout << name << " " << src_width << "x" << src_height << " -> " << dst_width
+                      << "x" << dst_height << " reference: " << (ok ? "ok" : "FAILED")
+                      << std::endl;
+            failed |= !ok;
+        }
+    }
+
+    Image::Farbfeld image(source);
+
+    image.setThreads(threads);
+
+    Image::Pyramid pyramid;
+    const double time = 1000.0 * TestCase::seconds([&]() { pyramid = image.buildPyramid(); });
+    const bool ok = check(pyramid);
+
+    std::cout << "pyramid " << width << "x" << height << ", " << pyramid.levels() << " levels: "
+              << (ok ? "ok" : "FAILED") << ", " << time << " ms" << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
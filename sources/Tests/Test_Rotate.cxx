@@ -0,0 +1,126 @@
+#include <functional>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Common/ThreadPool.hxx"
+#include "Image/Compact.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 4000;
+static const int64_t DefHeight = 3000;
+
+// where the pixel (x, y) of the source ends up, the plain way
+Image::Picture reference(const Image::Base &image, const std::string &turn)
+{
+    const int64_t width = image.width();
+    const int64_t height = image.height();
+    const bool swapped = turn != "180";
+    Image::Picture result(swapped ? height : width, swapped ? width : height);
+
+    for (int64_t y = 0; y < height; ++y)
+    {
+        for (int64_t x = 0; x < width; ++x)
+        {
+            const RGBA pixel = image.pixel(x, y);
+
+            if (turn == "90")
+                result.setPixel(height - 1 - y, x, pixel);
+            else if (turn == "180")
+                result.setPixel(width - 1 - x, height - 1 - y, pixel);
+            else if (turn == "270")
+                result.setPixel(y, width - 1 - x, pixel);
+            else
+                result.setPixel(y, x, pixel);
+        }
+    }
+
+    return result;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    const int64_t threads = Common::ThreadPool::hardwareThreads();
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    const std::vector<std::tuple<std::string,std::function<void (Image::Base &)>,
+                                 std::function<void (Image::Compact &)>>> turns = {
+        {"90", [](auto &image) { image.rotate90(); }, [](auto &image) { image.rotate90(); }},
+        {"180", [](auto &image) { image.rotate180(); }, [](auto &image) { image.rotate180(); }},
+        {"270", [](auto &image) { image.rotate270(); }, [](auto &image) { image.rotate270(); }},
+        {"transpose", [](auto &image) { image.transpose(); },
+                      [](auto &image) { image.transpose(); }}
+    };
+
+    // sizes that are no multiple of the blocks and kernels, a single row and a single column
+    const std::vector<std::tuple<int64_t,int64_t>> sizes = {
+        {37, 21}, {16, 16}, {64, 48}, {1, 19}, {23, 1}, {35, 70}
+    };
+
+    for (auto &[name, turn, compact_turn] : turns)
+    {
+        bool ok = true;
+
+        for (auto &[width, height] : sizes)
+        {
+            const Image::Picture original = TestCase::pattern(width, height);
+            const Image::Picture expected = reference(original, name);
+            Image::Picture image(original);
+            Image::Picture tiled(original);
+            Image::Compact compact(original);
+
+            turn(image);
+            tiled.setLayout(Image::Layout::Tiled);
+            turn(tiled);
+            tiled.setLayout(Image::Layout::Linear);
+            compact_turn(compact);
+
+            ok &= (image == expected) && (tiled == expected) &&
+                  (compact == Image::Compact(expected)) &&
+                  (original == TestCase::pattern(width, height));
+        }
+
+        std::cout << "rotate " << name << ": " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+    }
+
+    // 90 + 180 + 270 degrees are half a turn, so half a turn more and the second transpose give
+    // back the original, on the way both flips have to match a half turn
+    Image::Picture image = TestCase::pattern(DefWidth, DefHeight);
+    const Image::Picture original(image);
+    Image::Picture flipped(image);
+    std::vector<std::tuple<std::string,double>> times;
+    bool ok = true;
+
+    image.setThreads(threads);
+    flipped.flipVertical();
+    flipped.flipHorizontal();
+
+    for (auto &[name, turn, compact_turn] : turns)
+    {
+        times.emplace_back(name, TestCase::seconds([&]() { turn(image); }));
+
+        if (name == "180")
+            ok &= image == reference(flipped, "90");
+    }
+    image.transpose();
+    image.rotate180();
+    ok &= image == original;
+
+    std::cout << "round trip (" << threads << " threads";
+    for (auto &[name, time] : times)
+        std::cout << ", " << name << " " << time << "s";
+    std::cout << "): " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
@@ -175,7 +175,13 @@ int32_t main(int32_t argc, char **argv)
         if (simple && TestCase::applyToImageCase00(*simple))
         {
             simple->save(filename);
+
+            const bool ok = TestCase::savesTiled(*simple, filename);
+
+            std::cout << "tiled: " << (ok ? "ok" : "FAILED") << std::endl;
             delete simple;
+            if (!ok)
+                return 1;
         }
         else
         {
@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "Image/DrawDetail.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+using V2d = Image::Affine::V2d;
+
+static const int64_t DefWidth = 1920;
+static const int64_t DefHeight = 1080;
+static const int64_t DefPolygons = 2000;
+
+// the image the shapes are drawn on and how far they may reach outside of it
+static const int64_t Width = 100;
+static const int64_t Height = 80;
+static const int64_t Margin = 50;
+
+// how much of a pixel white drawn on black covers
+double coverage(const Image::Base &image, const int64_t x, const int64_t y)
+{
+    return image.pixel(x, y).r / 65535.0;
+}
+
+// the largest difference of the channels of two images of the same size
+int64_t difference(const Image::ImageView &a, const Image::ImageView &b)
+{
+    int64_t result = 0;
+
+    for (int64_t y = 0; y < a.height(); ++y)
+    {
+        for (int64_t x = 0; x < a.width(); ++x)
+        {
+            const RGBA p = a.pixel(x, y);
+            const RGBA q = b.pixel(x, y);
+
+            result = std::max({result, std::abs(int64_t(p.r) - q.r), std::abs(int64_t(p.g) - q.g),
+                               std::abs(int64_t(p.b) - q.b), std::abs(int64_t(p.a) - q.a)});
+        }
+    }
+
+    return result;
+}
+
+// the non-zero rule for a single point
+int64_t winding(const std::vector<V2d> &points, const double x, const double y)
+{
+    int64_t result = 0;
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const V2d &a = points[i];
+        const V2d &b = points[(i + 1) % points.size()];
+        const double side = (b.x - a.x) * (y - a.y) - (x - a.x) * (b.y - a.y);
+
+        if ((a.y <= y) && (b.y > y) && (side > 0.0))
+            ++result;
+        else if ((a.y > y) && (b.y <= y) && (side < 0.0))
+            --result;
+    }
+
+    return result;
+}
+
+// the coverage of a pixel from 32 x 32 samples
+double reference(const std::vector<V2d> &points, const int64_t x, const int64_t y)
+{
+    int64_t inside = 0;
+
+    for (int64_t j = 0; j < 32; ++j)
+        for (int64_t i = 0; i < 32; ++i)
+            inside += winding(points, x + (i + 0.5) / 32.0, y + (j + 0.5) / 32.0) != 0;
+
+    return inside / 1024.0;
+}
+
+// a star through every second of its corners, it crosses itself
+std::vector<V2d> star(const double x, const double y, const double radius, const int64_t corners)
+{
+    std::vector<V2d> points;
+
+    for (int64_t i = 0; i < corners; ++i)
+    {
+        const double angle = 2.0 * M_PI * ((2 * i) % corners) / corners;
+
+        points.push_back(V2d(x + radius * std::cos(angle), y + radius * std::sin(angle)));
+    }
+
+    return points;
+}
+
+// a regular polygon with that many corners, for many of them a circle
+std::vector<V2d> circle(const double x, const double y, const double radius,
+                        const int64_t corners)
+{
+    std::vector<V2d> points;
+
+    for (int64_t i = 0; i < corners; ++i)
+    {
+        const double angle = 2.0 * M_PI * i / corners;
+
+        points.push_back(V2d(x + radius * std::cos(angle), y + radius * std::sin(angle)));
+    }
+
+    return points;
+}
+
+// random points, or points at random distances around the middle in the order of their
+// angles, less than half a turn apart so the edges do not cross each other
+std::vector<V2d> randomPolygon(std::mt19937 &random, const double low_x, const double high_x,
+                               const double low_y, const double high_y, const bool simple)
+{
+    std::uniform_real_distribution<double> dist_x(low_x, high_x);
+    std::uniform_real_distribution<double> dist_y(low_y, high_y);
+    std::uniform_real_distribution<double> dist_part(0.0, 1.0);
+    std::uniform_int_distribution<int64_t> dist_count(4, 9);
+    std::vector<V2d> points(dist_count(random));
+    const double middle_x = (low_x + high_x) / 2;
+    const double middle_y = (low_y + high_y) / 2;
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const double angle = 2.0 * M_PI * (i + dist_part(random)) / points.size();
+        const double radius = (0.1 + 0.9 * dist_part(random)) * (high_x - low_x) / 2;
+
+        points[i] = simple ? V2d(middle_x + radius * std::cos(angle),
+                                 middle_y + radius * std::sin(angle)) :
+                             V2d(dist_x(random), dist_y(random));
+    }
+
+    return points;
+}
+
+// a color of its own for every shape, half transparent now and then
+RGBA color(const size_t i)
+{
+    return RGBA((i * 9791) & 0xFFFF, (i * 3169) & 0xFFFF, (i * 701) & 0xFFFF,
+                i % 3 == 0 ? 32768 : 65535);
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // the integer blend, a color over a pixel by the alpha and layers of alpha
+    const RGBA black(RGBA::Black);
+    const RGBA white(RGBA::White);
+    const RGBA clear(0, 0, 0, 0);
+    const RGBA red(65535, 0, 0, 65535);
+    const RGBA half = Image::Detail::blend(black, white, 32768);
+    const RGBA layer = Image::Detail::blend(clear, red, 16384);
+
+    bool ok = (half == RGBA(32768, 32768, 32768, 65535)) && (layer.r == 16384) &&
+              (layer.a == 16384) && (Image::Detail::blend(black, white, 0) == black) &&
+              (Image::Detail::blend(black, red, Image::Detail::Opaque) == red) &&
+              (Image::Detail::blend(layer, red, 16384).a == 28672);
+
+    std::cout << "blend: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // a rectangle covers each pixel by the product of its overlaps in x and y
+    Image::Picture rectangle(40, 30);
+    const double left = 10.25;
+    const double top = 5.5;
+    const double right = 30.75;
+    const double bottom = 20.125;
+
+    ok = rectangle.setSmoothPolygon({V2d(left, top), V2d(right, top), V2d(right, bottom),
+                                     V2d(left, bottom)}, white);
+    for (int64_t y = 0; y < 30; ++y)
+    {
+        for (int64_t x = 0; x < 40; ++x)
+        {
+            const double overlap_x = std::max(std::min(x + 1.0, right) - std::max(x + 0.0, left),
+                                              0.0);
+            const double overlap_y = std::max(std::min(y + 1.0, bottom) - std::max(y + 0.0, top),
+                                              0.0);
+
+            ok &= std::abs(coverage(rectangle, x, y) - overlap_x * overlap_y) < 0.0001;
+        }
+    }
+    std::cout << "rectangle: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // a polygon covers a pixel like the samples say, and all of them together as much as the
+    // samples, where one crosses itself the areas add up within a pixel, so only the pixels
+    // entirely inside or outside are exact there
+    std::mt19937 random(42);
+    double worst = 0.0;
+    double area = 0.0;
+    double sampled = 0.0;
+
+    ok = true;
+    for (int64_t i = 0; i < 90; ++i)
+    {
+        const bool simple = i % 3 == 1;
+        const std::vector<V2d> points = i % 3 == 0 ?
+                                        star(20.3, 19.7, 4.0 + i / 6.0, 5 + i % 4) :
+                                        randomPolygon(random, 0.0, 40.0, 0.0, 40.0, simple);
+        Image::Picture image(40, 40);
+
+        ok &= image.setSmoothPolygon(points, white);
+        for (int64_t y = 0; y < 40; ++y)
+        {
+            for (int64_t x = 0; x < 40; ++x)
+            {
+                const double expected = reference(points, x, y);
+
+                if (!simple && (expected > 0.0) && (expected < 1.0))
+                    continue;
+
+                worst = std::max(worst, std::abs(coverage(image, x, y) - expected));
+                if (simple)
+                {
+                    area += coverage(image, x, y);
+                    sampled += expected;
+                }
+            }
+        }
+    }
+    ok &= (worst < 0.03) && (std::abs(area - sampled) < 0.001 * sampled);
+    std::cout << "polygons: largest difference " << worst << ": " << (ok ? "ok" : "FAILED")
+              << std::endl;
+    failed |= !ok;
+
+    // every step of a line away from its ends covers exactly one pixel in all, no matter from
+    // which end it is drawn
+    std::uniform_real_distribution<double> dist_x(2.0, 38.0);
+    std::uniform_real_distribution<double> dist_y(2.0, 38.0);
+
+    ok = true;
+    for (int64_t i = 0; i < 300; ++i)
+    {
+        const double x1 = dist_x(random);
+        const double y1 = dist_y(random);
+        const double x2 = dist_x(random);
+        const double y2 = dist_y(random);
+        const bool steep = std::abs(y2 - y1) > std::abs(x2 - x1);
+        Image::Picture image(40, 40);
+        Image::Picture reversed(40, 40);
+
+        image.setSmoothLine(x1, y1, x2, y2, white);
+        reversed.setSmoothLine(x2, y2, x1, y1, white);
+        ok &= difference(image.view(), reversed.view()) <= 1;
+
+        // the steps between the pixels of the ends
+        const double from = std::floor(steep ? std::min(y1, y2) : std::min(x1, x2)) + 1;
+        const double to = std::floor(steep ? std::max(y1, y2) : std::max(x1, x2)) - 1;
+
+        for (int64_t major = from; major <= to; ++major)
+        {
+            double sum = 0.0;
+
+            for (int64_t minor = 0; minor < 40; ++minor)
+                sum += steep ? coverage(image, minor, major) : coverage(image, major, minor);
+            ok &= std::abs(sum - 1.0) < 0.0001;
+        }
+    }
+
+    // a line along the pixel centers covers a single row, so does a thin rectangle
+    Image::Picture row(40, 40);
+    Image::Picture bar(40, 40);
+
+    row.setSmoothLine(5.5, 10.5, 30.5, 10.5, white);
+    bar.setSmoothPolygon({V2d(5.5, 10.0), V2d(30.5, 10.0), V2d(30.5, 11.0), V2d(5.5, 11.0)},
+                         white);
+    for (int64_t x = 6; x < 30; ++x)
+        ok &= (coverage(row, x, 10) == 1.0) && (coverage(row, x, 9) == 0.0) &&
+              (coverage(row, x, 11) == 0.0) && (row.pixel(x, 10) == bar.pixel(x, 10));
+    ok &= std::abs(coverage(row, 5, 10) - 0.5) < 0.0001 &&
+          std::abs(coverage(row, 30, 10) - 0.5) < 0.0001 && (row.pixel(5, 10) == bar.pixel(5, 10));
+    std::cout << "lines: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // shapes reaching outside of the image are the part of them a big enough image gets, on
+    // every layout, on a view and within a clip rectangle
+    std::uniform_real_distribution<double> far_x(-Margin, Width + Margin);
+    std::uniform_real_distribution<double> far_y(-Margin, Height + Margin);
+    Image::Picture big(Width + 2 * Margin, Height + 2 * Margin);
+    Image::Picture image(Width, Height);
+    Image::Picture tiled(Width, Height);
+    Image::Picture partly(Width, Height);
+    Image::Picture framed(Width + 2, Height + 2);
+    const Image::MutableImageView view = framed.mutableView(1, 1, Width, Height);
+
+    tiled.setLayout(Image::Layout::Tiled);
+    partly.setClip(-10, 20, 70, 1000);
+    for (int64_t i = 0; i < 300; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            std::vector<V2d> points = randomPolygon(random, -Margin, Width + Margin, -Margin,
+                                                    Height + Margin, i % 4 == 0);
+            std::vector<V2d> moved;
+
+            for (const V2d &point : points)
+                moved.push_back(V2d(point.x + Margin, point.y + Margin));
+            big.setSmoothPolygon(moved, color(i));
+            image.setSmoothPolygon(points, color(i));
+            tiled.setSmoothPolygon(points, color(i));
+            partly.setSmoothPolygon(points, color(i));
+            view.setSmoothPolygon(points, color(i));
+        }
+        else
+        {
+            const double x1 = far_x(random);
+            const double y1 = far_y(random);
+            const double x2 = far_x(random);
+            const double y2 = far_y(random);
+
+            big.setSmoothLine(x1 + Margin, y1 + Margin, x2 + Margin, y2 + Margin, color(i));
+            image.setSmoothLine(x1, y1, x2, y2, color(i));
+            tiled.setSmoothLine(x1, y1, x2, y2, color(i));
+            partly.setSmoothLine(x1, y1, x2, y2, color(i));
+            view.setSmoothLine(x1, y1, x2, y2, color(i));
+        }
+    }
+    tiled.setLayout(Image::Layout::Linear);
+
+    const int64_t clipped = difference(image.view(), big.view(Margin, Margin, Width, Height));
+
+    ok = (clipped <= 2) && (tiled == image) && (view == image.view());
+    for (int64_t y = 0; y < Height; ++y)
+        for (int64_t x = 0; x < Width; ++x)
+            ok &= partly.pixel(x, y) == ((x < 60) && (y >= 20) ? image.pixel(x, y) : black);
+    for (int64_t x = 0; x < Width + 2; ++x)
+        ok &= (framed.pixel(x, 0) == black) && (framed.pixel(x, Height + 1) == black);
+    for (int64_t y = 0; y < Height + 2; ++y)
+        ok &= (framed.pixel(0, y) == black) && (framed.pixel(Width + 1, y) == black);
+    std::cout << "clipped: largest difference " << clipped << ": " << (ok ? "ok" : "FAILED")
+              << std::endl;
+    failed |= !ok;
+
+    // what is refused
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    ok = !image.setSmoothLine(nan, 0.0, 10.0, 10.0, white) &&
+         !image.setSmoothLine(0.0, 0.0, 1e9, 10.0, white) &&
+         !image.setSmoothLine(-10.0, -10.0, -2.0, -5.0, white) &&
+         !image.setSmoothPolygon({V2d(0.0, 0.0), V2d(10.0, 10.0)}, white) &&
+         !image.setSmoothPolygon({V2d(-5.0, 0.0), V2d(-1.0, 10.0), V2d(-3.0, 20.0)}, white) &&
+         !view.setSmoothPolygon({V2d(0.0, 0.0), V2d(1e9, 10.0), V2d(0.0, 20.0)}, white) &&
+         image.setSmoothLine(-10.0, -10.0, 0.5, 0.5, white);
+    std::cout << "refused: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // an overlay of circles, a few edges each or many, the work follows the pixels they cover
+    // and not how many edges cross each row
+    std::uniform_real_distribution<double> center_x(0.0, DefWidth);
+    std::uniform_real_distribution<double> center_y(0.0, DefHeight);
+    std::uniform_real_distribution<double> dist_radius(5.0, 60.0);
+    std::vector<V2d> centers;
+    std::vector<double> radii;
+
+    for (int64_t i = 0; i < DefPolygons; ++i)
+    {
+        centers.push_back(V2d(center_x(random), center_y(random)));
+        radii.push_back(dist_radius(random));
+    }
+
+    std::vector<double> times;
+
+    for (const int64_t corners : {16, 1024})
+    {
+        Image::Picture overlay(DefWidth, DefHeight);
+        std::vector<std::vector<V2d>> polygons;
+
+        for (int64_t i = 0; i < DefPolygons; ++i)
+            polygons.push_back(circle(centers[i].x, centers[i].y, radii[i], corners));
+
+        times.push_back(TestCase::seconds([&]()
+        {
+            for (size_t i = 0; i < polygons.size(); ++i)
+                overlay.setSmoothPolygon(polygons[i], color(i));
+        }));
+    }
+
+    std::cout << DefPolygons << " circles: 16 edges " << times[0] << "s, 1024 edges " << times[1]
+              << "s (" << times[1] / times[0] << "x)" << std::endl;
+
+    return failed ? 1 : 0;
+}
@@ -256,6 +256,12 @@ int32_t main(int32_t argc, char **argv)
             }
             targa.setVersion2((version > 1) ? true : false);
             targa.save(filename);
+
+            const bool ok = TestCase::savesTiled(targa, filename);
+
+            std::cout << "tiled: " << (ok ? "ok" : "FAILED") << std::endl;
+            if (!ok)
+                return 1;
         }
         else
         {
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "Image/DrawDetail.hxx"
+#include "Image/Picture.hxx"
+#include "Math/Vector2.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+using V2d = Math::Vector2<double>;
+
+static const int64_t DefWidth = 1920;
+static const int64_t DefHeight = 1080;
+static const int64_t DefTriangles = 1000000;
+
+struct Triangle {
+    int64_t x1, y1, x2, y2, x3, y3;
+};
+
+// the rule spelled out for a single pixel, its center is inside or on a top or left edge
+bool inside(const Triangle &t, const int64_t x, const int64_t y)
+{
+    int64_t ax = t.x1, ay = t.y1, bx = t.x2, by = t.y2, cx = t.x3, cy = t.y3;
+    const int64_t area = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+
+    if (area == 0)
+        return false;
+    if (area < 0)
+    {
+        std::swap(bx, cx);
+        std::swap(by, cy);
+    }
+
+    auto edge = [&](const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2)
+    {
+        const int64_t value = (x2 - x1) * (2 * (y - y1) + 1) - (y2 - y1) * (2 * (x - x1) + 1);
+
+        return (value > 0) || ((value == 0) && ((y2 < y1) || ((y2 == y1) && (x2 > x1))));
+    };
+
+    return edge(ax, ay, bx, by) && edge(bx, by, cx, cy) && edge(cx, cy, ax, ay);
+}
+
+Image::Picture reference(const int64_t width, const int64_t height,
+                         const std::vector<Triangle> &triangles)
+{
+    Image::Picture image(width, height);
+
+    for (size_t i = 0; i < triangles.size(); ++i)
+        for (int64_t y = 0; y < height; ++y)
+            for (int64_t x = 0; x < width; ++x)
+                if (inside(triangles[i], x, y))
+                    image.setPixel(x, y, TestCase::color(i));
+
+    return image;
+}
+
+// the spans of a filled triangle, either row by row or in blocks of 8x8 pixels
+template <int64_t SpanLimit>
+std::vector<std::tuple<int64_t,int64_t,int64_t>> spans(const Triangle &t,
+                                                      const Image::Detail::Clip &clip)
+{
+    std::vector<std::tuple<int64_t,int64_t,int64_t>> result;
+
+    Image::Detail::fillTriangle<SpanLimit>(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3,
+                                           [&](const int64_t x1, const int64_t x2, const int64_t y)
+    {
+        result.emplace_back(x1, x2, y);
+    },
+    clip);
+
+    return result;
+}
+
+// the way triangles were filled before, two cross products and divisions per pixel of the box
+void boundingBoxFill(Image::Base &image, const Triangle &t, const RGBA color)
+{
+    const V2d p1(t.x1, t.y1);
+    const V2d p12(t.x2 - t.x1, t.y2 - t.y1);
+    const V2d p13(t.x3 - t.x1, t.y3 - t.y1);
+    const double cross = Math::crossProduct(p12, p13);
+
+    for (int64_t y = std::min({t.y1, t.y2, t.y3}); y <= std::max({t.y1, t.y2, t.y3}); ++y)
+    {
+        for (int64_t x = std::min({t.x1, t.x2, t.x3}); x <= std::max({t.x1, t.x2, t.x3}); ++x)
+        {
+            const V2d v(x - p1.x, y - p1.y);
+            const double s = Math::crossProduct(v, p13) / cross;
+            const double u = Math::crossProduct(p12, v) / cross;
+
+            if ((s >= 0) && (u >= 0) && ((s + u) <= 1))
+                image.setPixel(x, y, color);
+        }
+    }
+}
+
+std::vector<Triangle> random(const int64_t count, const int64_t width, const int64_t height,
+                             const int64_t size, const uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int64_t> dist_x(0, width - size);
+    std::uniform_int_distribution<int64_t> dist_y(0, height - size);
+    std::uniform_int_distribution<int64_t> dist_size(0, size - 1);
+    std::vector<Triangle> result;
+
+    for (int64_t i = 0; i < count; ++i)
+    {
+        const int64_t x = dist_x(random);
+        const int64_t y = dist_y(random);
+
+        result.push_back({x + dist_size(random), y + dist_size(random), x + dist_size(random),
+                          y + dist_size(random), x + dist_size(random), y + dist_size(random)});
+    }
+
+    return result;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // small and large triangles of both windings, thin ones and some without an area
+    const std::vector<Triangle> triangles = random(300, 100, 80, 80, 42);
+    const Image::Picture expected = reference(100, 80, triangles);
+    TestCase::Canvases canvases(100, 80);
+
+    for (size_t i = 0; i < triangles.size(); ++i)
+    {
+        const Triangle &t = triangles[i];
+
+        canvases.draw(i, [&](auto &canvas, const auto color)
+        {
+            canvas.setTriangle(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, color, true);
+        });
+    }
+
+    bool ok = canvases.matches(expected);
+
+    std::cout << "fill: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // the rows of small bounding boxes and the blocks agree on every span, also when clipped
+    const Image::Detail::Clip clip = {7, 5, 93, 71};
+    constexpr int64_t Rows = std::numeric_limits<int64_t>::max();
+
+    ok = true;
+    for (auto &t : random(1000, 100, 80, 24, 3))
+        ok &= (spans<0>(t, Image::Detail::NoClip) == spans<Rows>(t, Image::Detail::NoClip)) &&
+              (spans<0>(t, clip) == spans<Rows>(t, clip));
+    std::cout << "rows and blocks: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // a fan of triangles around an inner point covers its rectangle, every pixel exactly once
+    const std::vector<std::tuple<int64_t,int64_t>> rim = {
+        {0, 0}, {37, 0}, {100, 0}, {100, 23}, {100, 80}, {61, 80}, {0, 80}, {0, 51}, {0, 0}
+    };
+    std::vector<int64_t> coverage(100 * 80, 0);
+
+    for (size_t i = 0; i + 1 < rim.size(); ++i)
+    {
+        Image::Picture single(100, 80);
+        const auto [x1, y1] = rim[i];
+        const auto [x2, y2] = rim[i + 1];
+
+        single.setTriangle(43, 29, x1, y1, x2, y2, RGBA(RGBA::White), true);
+        for (int64_t y = 0; y < 80; ++y)
+            for (int64_t x = 0; x < 100; ++x)
+                coverage[y * 100 + x] += single.pixel(x, y) == RGBA(RGBA::White);
+    }
+
+    ok = std::all_of(coverage.begin(), coverage.end(), [](const int64_t count)
+    {
+        return count == 1;
+    });
+    std::cout << "shared edges: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // a mesh preview frame with plenty of small triangles and a few big ones that are mostly
+    // taken in whole blocks
+    Image::Picture frame(DefWidth, DefHeight);
+    Image::Picture before(DefWidth, DefHeight);
+    const RGBA green(RGBA::Green);
+
+    for (auto [count, size] : {std::tuple<int64_t,int64_t>(DefTriangles, 24), {10000, 400}})
+    {
+        const std::vector<Triangle> mesh = random(count, DefWidth, DefHeight, size, 7);
+
+        const double time = TestCase::seconds([&]()
+        {
+            for (auto &t : mesh)
+                frame.setTriangle(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, green, true);
+        });
+        const double before_time = TestCase::seconds([&]()
+        {
+            for (auto &t : mesh)
+                boundingBoxFill(before, t, green);
+        });
+
+        std::cout << count << " triangles of up to " << size << " pixels: bounding box "
+                  << before_time << "s, edge functions " << time << "s ("
+                  << before_time / time << "x)" << std::endl;
+    }
+
+    // the small triangles on their own, filled row by row as they are now and in blocks
+    const std::vector<Triangle> small = random(DefTriangles, DefWidth, DefHeight, 16, 11);
+    int64_t pixels[2] = {0, 0};
+    double times[2] = {0, 0};
+
+    for (int64_t i = 0; i < 2; ++i)
+    {
+        auto count = [&](const int64_t x1, const int64_t x2, const int64_t)
+        {
+            pixels[i] += x2 - x1 + 1;
+        };
+
+        times[i] = TestCase::seconds([&]()
+        {
+            for (auto &t : small)
+            {
+                if (i == 0)
+                    Image::Detail::fillTriangle(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, count);
+                else
+                    Image::Detail::fillTriangle<0>(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, count);
+            }
+        });
+    }
+
+    ok = (pixels[0] == pixels[1]) && (times[0] < times[1]);
+    std::cout << DefTriangles << " triangles of up to 16 pixels: blocks " << times[1]
+              << "s, rows " << times[0] << "s (" << times[1] / times[0] << "x): "
+              << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Image/Farbfeld.hxx"
+#include "Image/Targa.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+
+static const int64_t DefWidth = 1024;
+static const int64_t DefHeight = 768;
+static const int64_t DefThreads = 1;
+
+void showHelp(const char *name)
+{
+    std::cout << "usage: " << name << " [options]\n"
+              << "options:\n"
+              << "  --help               this help screen\n"
+              << "  --width=<width>      atlas width instead of the default '" << DefWidth << "'\n"
+              << "  --height=<height>    atlas height instead of the default '" << DefHeight
+                << "'\n"
+              << "  --threads=<num>      amount of threads to work with (default: " << DefThreads
+                << ", 0 uses all cores)\n"
+              << std::endl;
+}
+
+// some noise, so the filters and the quantizer have something to do
+Image::Farbfeld noise(const int64_t width, const int64_t height)
+{
+    Image::Farbfeld image(width, height);
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+
+    for (int64_t y = 0; y < height; ++y)
+    {
+        for (int64_t x = 0; x < width; ++x)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            image.setPixel(x, y, RGBA(seed >> 48, (seed >> 32) & 0xFFFF, (seed >> 16) & 0xFFFF,
+                                      0xFFFF));
+        }
+    }
+
+    return image;
+}
+
+// everything outside of the rectangle has to be untouched
+bool outsideKept(const Image::Base &image, const Image::Base &original, const int64_t left,
+                 const int64_t top, const int64_t width, const int64_t height)
+{
+    for (int64_t y = 0; y < image.height(); ++y)
+        for (int64_t x = 0; x < image.width(); ++x)
+            if (((x < left) || (x >= left + width) || (y < top) || (y >= top + height)) &&
+              (image.pixel(x, y) != original.pixel(x, y)))
+                return false;
+
+    return true;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    using Job = std::function<void (Image::MutableImageView, int64_t)>;
+
+    int64_t width = DefWidth;
+    int64_t height = DefHeight;
+    int64_t threads = DefThreads;
+    bool failed = false;
+
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+
+        try
+        {
+            if (arg == "--help")
+            {
+                showHelp(argv[0]);
+                return 0;
+            }
+
+            if (arg.substr(0, 8) == "--width=")
+                width = std::max(std::stoll(arg.substr(8, std::string::npos)), 64ll);
+
+            if (arg.substr(0, 9) == "--height=")
+                height = std::max(std::stoll(arg.substr(9, std::string::npos)), 64ll);
+
+            if (arg.substr(0, 10) == "--threads=")
+                threads = std::stoll(arg.substr(10, std::string::npos));
+        }
+        catch (...)
+        {
+            std::cerr << "ERROR: unable to parse '" << arg << "', using the default" << std::endl;
+        }
+    }
+
+    const Image::Farbfeld atlas = noise(width, height);
+    const int64_t left = width / 5;
+    const int64_t top = height / 7;
+    const int64_t w = width / 2 + 3;
+    const int64_t h = height / 3 + 1;
+    const std::vector<std::tuple<std::string,Job>> jobs = {
+        {"smooth", [](auto view, auto t) { view.filter(Image::Filter::Smooth, 1, t); }},
+        {"box blur 5", [](auto view, auto t) { view.filter(Image::Filter::BoxBlur, 5, t); }},
+        {"gaussian 5x5", [](auto view, auto t)
+            {
+                view.convolve(Image::Kernel::gaussian(2), Image::Border::Mirror, t);
+            }
+        },
+        {"drawing", [](auto view, auto)
+            {
+                view.setRectangle(1, 2, view.width() - 2, view.height() - 3, RGBA::Red, true);
+                view.setLine(0, 0, view.width() - 1, view.height() - 1, RGBA::Green);
+                view.setCircle(view.width() / 2, view.height() / 2, 10, RGBA::Blue, false);
+                view.setTriangle(3, 3, 20, 5, 9, 30, RGBA::White, true);
+            }
+        },
+        {"middle cut 16", [](auto view, auto)
+            {
+                view.reduceColors(16, Image::Quantizer::MiddleCut);
+            }
+        }
+    };
+
+    // every job on a view has to do the same as on a cropped copy and must not leave the view
+    for (auto &[name, job] : jobs)
+    {
+        Image::Farbfeld image(atlas);
+        Image::Farbfeld cropped(atlas.view(left, top, w, h).pixels(), w, h);
+
+        // the copy of the atlas gets its own pixels here and not in the timed part
+        const Image::MutableImageView view = image.mutableView(left, top, w, h);
+        const double time = 1000.0 * TestCase::seconds([&]() { job(view, threads); });
+
+        job(cropped.mutableView(), threads);
+
+        const bool ok = (image.view(left, top, w, h) == cropped.view()) &&
+                        outsideKept(image, atlas, left, top, w, h);
+
+        std::cout << name << " on " << w << "x" << h << " view: " << (ok ? "ok" : "FAILED")
+                  << ", " << time << " ms" << std::endl;
+        failed |= !ok;
+    }
+
+    // scaling a part of the atlas into a part of another image
+    const std::vector<std::tuple<std::string,Image::Scaler>> scalers = {
+        {"nearest", Image::Scaler::Nearest},
+        {"fast billinear", Image::Scaler::FastBillinear},
+        {"lanczos3", Image::Scaler::Lanczos3}
+    };
+
+    for (auto &[name, scaler] : scalers)
+    {
+        Image::Farbfeld image(atlas);
+        Image::Farbfeld cropped(atlas.view(left, top, w, h).pixels(), w, h);
+
+        image.mutableView(0, 0, w / 3, h / 3).resample(atlas.view(left, top, w, h), scaler,
+                                                       threads);
+        cropped.resize(w / 3, h / 3, scaler);
+
+        const bool ok = (image.view(0, 0, w / 3, h / 3) == cropped.view()) &&
+                        outsideKept(image, atlas, 0, 0, w / 3, h / 3);
+
+        std::cout << name << " into view: " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+    }
+
+    // copies share the pixels until one of them writes, whichever way that happens
+    const std::vector<std::tuple<std::string,std::function<void (Image::Base &)>>> writers = {
+        {"setPixel", [](auto &image) { image.setPixel(1, 1, RGBA::Red); }},
+        {"setRectangle", [](auto &image) { image.setRectangle(1, 1, 9, 9, RGBA::Red, true); }},
+        {"filter", [](auto &image) { image.filter(Image::Filter::Smooth); }},
+        {"mutableView", [](auto &image) { image.mutableView().setPixel(1, 1, RGBA::Red); }},
+        {"forEachTile", [](auto &image)
+            {
+                image.forEachTile([](const Image::Base::Tile &tile)
+                {
+                    tile.pixels[0] = RGBA::Red;
+                });
+            }
+        }
+    };
+
+    for (auto &[name, writer] : writers)
+    {
+        const Image::Targa original(atlas);
+        Image::Farbfeld copy(original);
+        const bool shared = copy.pixels().data() == original.pixels().data();
+
+        writer(copy);
+
+        const bool ok = shared && (copy.pixels().data() != original.pixels().data()) &&
+                        (original.view() == atlas.view()) && (copy.view() != atlas.view());
+
+        std::cout << "copy on write by " << name << ": " << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+    }
+
+    Image::Farbfeld tiled(atlas);
+    bool ok = false;
+
+    tiled.setLayout(Image::Layout::Tiled);
+    try
+    {
+        tiled.view();
+    }
+    catch (const std::logic_error &)
+    {
+        ok = true;
+    }
+    try
+    {
+        atlas.view(width - 1, 0, 2, 1);
+        ok = false;
+    }
+    catch (const std::out_of_range &)
+    {
+    }
+
+    std::cout << "invalid views: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include "Common/ThreadPool.hxx"
+#include "Image/Picture.hxx"
+#include "TestCases.hxx"
+
+using RGBA = Image::Base::RGBA;
+using V2d = Image::Affine::V2d;
+
+static const int64_t DefWidth = 4000;
+static const int64_t DefHeight = 3000;
+
+// the plain way, a matrix multiply per pixel in double precision
+Image::Picture reference(const Image::Base &image, const Image::Affine &affine,
+                         const int64_t width, const int64_t height, const bool interpolate)
+{
+    const Image::Affine inverse = affine.inverse();
+    Image::Picture result(width, height);
+
+    for (int64_t y = 0; y < height; ++y)
+    {
+        for (int64_t x = 0; x < width; ++x)
+        {
+            const V2d pos = inverse.map(V2d(x + .5, y + .5));
+            const int64_t px = std::floor(pos.x);
+            const int64_t py = std::floor(pos.y);
+
+            if ((px < 0) || (px >= image.width()) || (py < 0) || (py >= image.height()))
+                result.setPixel(x, y, RGBA(RGBA::Black));
+            else if (!interpolate)
+                result.setPixel(x, y, image.pixel(px, py));
+            else
+            {
+                const double fx = pos.x - .5 - std::floor(pos.x - .5);
+                const double fy = pos.y - .5 - std::floor(pos.y - .5);
+                const int64_t left = std::floor(pos.x - .5);
+                const int64_t top = std::floor(pos.y - .5);
+                auto at = [&](const int64_t xx, const int64_t yy)
+                {
+                    return image.pixel(std::clamp<int64_t>(xx, 0, image.width() - 1),
+                                       std::clamp<int64_t>(yy, 0, image.height() - 1));
+                };
+                auto blend = [&](auto channel)
+                {
+                    const double upper = channel(at(left, top)) * (1 - fx) +
+                                         channel(at(left + 1, top)) * fx;
+                    const double lower = channel(at(left, top + 1)) * (1 - fx) +
+                                         channel(at(left + 1, top + 1)) * fx;
+
+                    return static_cast<uint16_t>(std::lround(upper * (1 - fy) + lower * fy));
+                };
+
+                result.setPixel(x, y, RGBA(blend([](const RGBA p) { return p.r; }),
+                                           blend([](const RGBA p) { return p.g; }),
+                                           blend([](const RGBA p) { return p.b; }),
+                                           blend([](const RGBA p) { return p.a; })));
+            }
+        }
+    }
+
+    return result;
+}
+
+// the largest difference of a channel and the amount of pixels that differ at all
+std::tuple<int64_t,int64_t> difference(const Image::Base &lhs, const Image::Base &rhs)
+{
+    int64_t largest = 0;
+    int64_t pixels = 0;
+
+    for (int64_t y = 0; y < lhs.height(); ++y)
+    {
+        for (int64_t x = 0; x < lhs.width(); ++x)
+        {
+            const RGBA p1 = lhs.pixel(x, y);
+            const RGBA p2 = rhs.pixel(x, y);
+
+            largest = std::max<int64_t>({largest, std::abs(p1.r - p2.r), std::abs(p1.g - p2.g),
+                                         std::abs(p1.b - p2.b), std::abs(p1.a - p2.a)});
+            pixels += p1 != p2;
+        }
+    }
+
+    return {largest, pixels};
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    const int64_t threads = Common::ThreadPool::hardwareThreads();
+    bool failed = false;
+
+    if (argc > 1)
+    {
+        std::cout << "usage: " << argv[0] << "\n" << std::endl;
+        return 0;
+    }
+
+    // the matrices compose, invert and map like they should
+    const Image::Affine skew = Image::Affine::rotation(7.3, V2d(20, 15)) *
+                               Image::Affine::scale(1.1, 0.9) * Image::Affine::shear(0.2, -0.1);
+    const Image::Affine round_trip = skew * skew.inverse();
+    const V2d mapped = Image::Affine::rotation(90).map(V2d(1, 0));
+    bool ok = (std::abs(round_trip.matrix()[0] - 1) < 1e-12) &&
+              (std::abs(round_trip.matrix()[2]) < 1e-12) &&
+              (std::abs(round_trip.matrix()[4] - 1) < 1e-12) && (mapped == V2d(0, 1)) &&
+              !Image::Affine(1, 2, 0, 2, 4, 0).invertible();
+
+    std::cout << "matrices: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // quarter turns around the center of a square image are the exact rotations, with either
+    // sampling, and translations by whole pixels move them
+    const Image::Picture square = TestCase::pattern(33, 33);
+    ok = true;
+    for (const Image::Scaler scaler : {Image::Scaler::Nearest, Image::Scaler::Bilinear})
+    {
+        Image::Picture turned(square);
+        Image::Picture expected(square);
+        Image::Picture moved(square);
+
+        turned.rotate(90, scaler);
+        expected.rotate90();
+        ok &= turned == expected;
+
+        turned = square;
+        expected = square;
+        turned.rotate(-90, scaler);
+        expected.rotate270();
+        ok &= turned == expected;
+
+        moved.warp(Image::Affine::translation(V2d(3, -2)), 33, 33, scaler, RGBA(RGBA::White));
+        ok &= (moved.pixel(3, 0) == square.pixel(0, 2)) &&
+              (moved.pixel(32, 30) == square.pixel(29, 32)) &&
+              (moved.pixel(2, 10) == RGBA(RGBA::White)) &&
+              (moved.pixel(10, 31) == RGBA(RGBA::White));
+    }
+    std::cout << "quarter turns and translations: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // doubling the size with nearest sampling repeats every pixel twice in both directions
+    Image::Picture doubled(square);
+    ok = doubled.warp(Image::Affine::scale(2, 2), 66, 66, Image::Scaler::Nearest) &&
+         (doubled.width() == 66);
+    for (int64_t y = 0; ok && (y < 66); ++y)
+        for (int64_t x = 0; x < 66; ++x)
+            ok &= doubled.pixel(x, y) == square.pixel(x / 2, y / 2);
+    std::cout << "scale: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // any other transform against the per pixel matrix multiply, layouts and threads must not
+    // change the result
+    const Image::Picture source = TestCase::pattern(61, 47);
+    ok = true;
+    for (const Image::Scaler scaler : {Image::Scaler::Nearest, Image::Scaler::Bilinear})
+    {
+        const bool interpolate = scaler != Image::Scaler::Nearest;
+        const Image::Picture expected = reference(source, skew, 70, 50, interpolate);
+        Image::Picture image(source);
+        Image::Picture tiled(source);
+
+        image.setThreads(threads);
+        image.warp(skew, 70, 50, scaler);
+        tiled.setLayout(Image::Layout::Tiled);
+        tiled.warp(skew, 70, 50, scaler);
+        tiled.setLayout(Image::Layout::Linear);
+        // the fixed point fractions truncate a little
+        ok &= (std::get<0>(difference(image, expected)) <= (interpolate ? 2 : 0)) &&
+              (tiled == image);
+    }
+    std::cout << "skew: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // what can not be done is refused and leaves the image alone
+    Image::Picture refused(source);
+    ok = !refused.warp(Image::Affine(1, 2, 0, 2, 4, 0), 10, 10) &&
+         !refused.warp(skew, 10, 10, Image::Scaler::Lanczos3) && !refused.warp(skew, 0, 10) &&
+         (refused == source);
+    std::cout << "refused: " << (ok ? "ok" : "FAILED") << std::endl;
+    failed |= !ok;
+
+    // the deskew case, a small angle on a big scan, against the per pixel matrix multiply
+    Image::Picture scan = TestCase::pattern(DefWidth, DefHeight);
+    const Image::Affine deskew = Image::Affine::rotation(1.5, V2d(DefWidth / 2.0,
+                                                                  DefHeight / 2.0));
+
+    for (const Image::Scaler scaler : {Image::Scaler::Nearest, Image::Scaler::Bilinear})
+    {
+        const bool interpolate = scaler != Image::Scaler::Nearest;
+        Image::Picture expected;
+        const double reference_time = TestCase::seconds([&]()
+        {
+            expected = reference(scan, deskew, DefWidth, DefHeight, interpolate);
+        });
+        Image::Picture image(scan);
+
+        image.setThreads(threads);
+        const double time = TestCase::seconds([&]() { image.rotate(1.5, scaler); });
+
+        const auto [largest, pixels] = difference(image, expected);
+
+        // now and then a position is closer to the edge of a source pixel than the fixed point
+        // steps are precise, the nearest pixel may then be the one on the other side
+        ok = interpolate ? largest <= 2 : pixels * 100000 <= DefWidth * DefHeight;
+        std::cout << "deskew " << (interpolate ? "bilinear" : "nearest") << " (reference "
+                  << reference_time << "s, " << threads << " threads " << time << "s, "
+                  << DefWidth * DefHeight / time / 1e6 << " MPixel/s): "
+                  << (ok ? "ok" : "FAILED") << std::endl;
+        failed |= !ok;
+    }
+
+    return failed ? 1 : 0;
+}
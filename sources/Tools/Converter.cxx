@@ -1,15 +1,19 @@
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <memory>
+#include <stdexcept>
 #include <string>
-#include "Common/Tools.hxx"
 #include "Image/Image.hxx"
 
-namespace T = Common::Tools;
-
 void usage(const char *appname) noexcept
 {
     std::cout << "usage: " << appname << " --input=<image file> --output=<image file> [options]\n"
+              << "\n"
+              << "  --option=<key>=<value>  passed to the encoder, may be given more than once\n"
+              << "                          (ppm: binary, wide, comment, targa: type)\n"
+              << "  --rotate=<degrees>      turns the image clockwise, quarter turns exactly,\n"
+              << "                          other angles around its center keeping the size\n"
+              << "  --transpose             mirrors the image at its main diagonal\n"
               << std::endl;
 }
 
@@ -19,8 +23,10 @@ int32_t main(int32_t argc, char **argv) noexcept(false)
     {
         std::string ifilename;
         std::string ofilename;
-        std::shared_ptr<Image::Base> in_image;
-        std::shared_ptr<Image::Base> out_image;
+        Image::CodecOptions options;
+        Image::Picture image;
+        std::string rotation;
+        bool transpose = false;
 
         for (int32_t i = 1; i < argc; ++i)
         {
@@ -31,60 +37,61 @@ int32_t main(int32_t argc, char **argv) noexcept(false)
 
             if (arg.substr(0, 9) == "--output=")
                 ofilename = arg.substr(9, std::string::npos);
+
+            if (arg.substr(0, 9) == "--option=")
+            {
+                const std::string option = arg.substr(9, std::string::npos);
+                const size_t pos = option.find('=');
+
+                if (pos != std::string::npos)
+                    options[option.substr(0, pos)] = option.substr(pos + 1, std::string::npos);
+            }
+
+            if (arg.substr(0, 9) == "--rotate=")
+                rotation = arg.substr(9, std::string::npos);
+
+            if (arg == "--transpose")
+                transpose = true;
         }
 
-        if (std::ifstream(ifilename) && !ofilename.empty())
+        // targa files used to be written color mapped, keep that unless asked otherwise
+        options.try_emplace("type", "mapped");
+
+        if (std::ifstream(ifilename) && !ofilename.empty() && image.load(ifilename))
         {
-            const std::string ff1(".ff");
-            const std::string ff2(".farbfeld");
-            const std::string ppm(".ppm");
-            const std::string simple0(".sp0");
-            const std::string simple1(".sp1");
-            const std::string simple2(".simple00");
-            const std::string simple3(".simple01");
-            const std::string tga1(".tga");
-            const std::string tga2(".targa");
+            if (transpose)
+                image.transpose();
+            if (rotation == "90")
+                image.rotate90();
+            else if (rotation == "180")
+                image.rotate180();
+            else if (rotation == "270")
+                image.rotate270();
+            else if (!rotation.empty())
+            {
+                char *end = nullptr;
+                const double degrees = std::strtod(rotation.c_str(), &end);
+
+                if (*end || !image.rotate(degrees))
+                    std::cerr << "unable to rotate by " << rotation << " degrees" << std::endl;
+            }
 
-            if (Image::Farbfeld::identify(ifilename))
-                in_image = std::make_shared<Image::Farbfeld>(ifilename);
-            else if (Image::PPM::identify(ifilename))
-                in_image = std::make_shared<Image::PPM>(ifilename);
-            else if (Image::Simple00::identify(ifilename))
-                in_image = std::make_shared<Image::Simple00>(ifilename);
-            else if (Image::Simple01::identify(ifilename))
-                in_image = std::make_shared<Image::Simple01>(ifilename);
-            else if (Image::Targa::identify(ifilename))
-                in_image = std::make_shared<Image::Targa>(ifilename);
+            image.setOptions(options);
 
-            if (in_image)
+            // the encoders refuse option values they do not understand
+            try
             {
-                if (T::countSubSequences(ofilename, ff1) || T::countSubSequences(ofilename, ff2))
-                    out_image = std::make_shared<Image::Farbfeld>(in_image->pixels(),
-                                in_image->width(), in_image->height());
-                else if (T::countSubSequences(ofilename, ppm))
-                    out_image = std::make_shared<Image::PPM>(in_image->pixels(), in_image->width(),
-                                in_image->height());
-                else if (T::countSubSequences(ofilename, simple0) ||
-                  T::countSubSequences(ofilename, simple2))
-                    out_image = std::make_shared<Image::Simple00>(in_image->pixels(),
-                                in_image->width(), in_image->height());
-                else if (T::countSubSequences(ofilename, simple1) ||
-                  T::countSubSequences(ofilename, simple3))
-                    out_image = std::make_shared<Image::Simple01>(in_image->pixels(),
-                                in_image->width(), in_image->height());
-                else if (T::countSubSequences(ofilename, tga1) ||
-                  T::countSubSequences(ofilename, tga2))
-                {
-                    out_image = std::make_shared<Image::Targa>(in_image->pixels(),
-                                in_image->width(), in_image->height());
-                    std::dynamic_pointer_cast<Image::Targa>(out_image)->setImageType(Image::Targa::ImageType::Mapped);
-                }
+                if (!image.save(ofilename))
+                    std::cerr << "unable to save " << ofilename << std::endl;
+            }
+            catch (const std::invalid_argument &error)
+            {
+                std::cerr << "unable to save " << ofilename << ": " << error.what() << std::endl;
             }
         }
-
-        if (out_image)
-            out_image->save(ofilename);
     }
+    else
+        usage(argv[0]);
 
     return 0;
 }
@@ -58,8 +58,12 @@ void usage(const std::string &appname) noexcept
               << "  --flipv         flip vertical\n"
               << "  --scalew=<num>  scale width to <num> pixels\n"
               << "  --scaleh=<num>  scale height to <num> pixels\n"
+              << "  --zoom=<num>    scale both sides to <num> percent\n"
               << "  --colors=<num>  reduce amount of colors to <num>\n"
-              << "  --filter=<flt>  apply filter <flt> (smooth, sharpen, edge, blur, raised)\n"
+              << "  --filter=<flt>[,<rad>][:<num>]\n"
+              << "                  apply filter <flt> (smooth, sharpen, edge, blur, raised, box,\n"
+              << "                  gaussian) with the radius <rad> (box and gaussian only,\n"
+              << "                  default 1) using <num> threads (default 1, 0 uses all cores)\n"
               << std::endl;
 }
 
@@ -72,18 +76,8 @@ int32_t main(int32_t argc, char **argv) noexcept(false)
     {
         filename = argv[1];
 
-        if (I::Farbfeld::identify(filename))
-            image = new I::Farbfeld(filename);
-        else if (I::PPM::identify(filename))
-            image = new I::PPM(filename);
-        else if (I::Simple00::identify(filename))
-            image = new I::Simple00(filename);
-        else if (I::Simple01::identify(filename))
-            image = new I::Simple01(filename);
-        else if (I::Simple02::identify(filename))
-            image = new I::Simple02(filename);
-        else if (I::Targa::identify(filename))
-            image = new I::Targa(filename);
+        if (I::Codecs::byContent(filename))
+            image = new I::Picture(filename);
     }
     else
     {
@@ -123,6 +117,31 @@ int32_t main(int32_t argc, char **argv) noexcept(false)
                 image->resize(image->width(), scaleh, Image::Scaler::FastBillinear);
             }
 
+            if (arg.substr(0, 7) == "--zoom=")
+            {
+                const int64_t zoom = std::stoi(arg.substr(7, std::string::npos));
+                const int64_t width = std::max<int64_t>(image->width() * zoom / 100, 1);
+                const int64_t height = std::max<int64_t>(image->height() * zoom / 100, 1);
+
+                // zoomed out to half or less, so start from the closest pre-scaled level and not
+                // from the full resolution, the copy of that level becomes the image
+                if ((width * 2 <= image->width()) && (height * 2 <= image->height()))
+                {
+                    const I::Pyramid pyramid = image->buildPyramid();
+                    const int64_t level = pyramid.pick(width, height);
+                    I::Base *scaled = new I::Picture(pyramid.pixels(level), pyramid.width(level),
+                                                     pyramid.height(level));
+
+                    scaled->setThreads(image->threads());
+                    delete image;
+                    image = scaled;
+                }
+
+                if (!image->resize(width, height, Image::Scaler::FastBillinear))
+                    std::cerr << "ERROR: unable to zoom to " << width << "x" << height
+                              << ", both sides need at least 3 pixels" << std::endl;
+            }
+
             if (arg.substr(0, 9) == "--colors=")
             {
                 const int64_t to_colors = std::stoi(arg.substr(9, std::string::npos));
@@ -137,6 +156,20 @@ int32_t main(int32_t argc, char **argv) noexcept(false)
                 arg = arg.substr(9, std::string::npos);
                 std::transform(arg.begin(), arg.end(), arg.begin(), ::tolower);
 
+                if (const size_t pos = arg.find(':'); pos != std::string::npos)
+                {
+                    image->setThreads(std::stoi(arg.substr(pos + 1, std::string::npos)));
+                    arg = arg.substr(0, pos);
+                }
+
+                int64_t radius = 1;
+
+                if (const size_t pos = arg.find(','); pos != std::string::npos)
+                {
+                    radius = std::stoi(arg.substr(pos + 1, std::string::npos));
+                    arg = arg.substr(0, pos);
+                }
+
                 if (arg == "smooth")
                     image->filter(I::Filter::Smooth);
                 if (arg == "sharpen")
@@ -147,6 +180,10 @@ int32_t main(int32_t argc, char **argv) noexcept(false)
                     image->filter(I::Filter::Blur);
                 if (arg == "raised")
                     image->filter(I::Filter::Raised);
+                if (arg == "box")
+                    image->filter(I::Filter::BoxBlur, radius);
+                if (arg == "gaussian")
+                    image->filter(I::Filter::GaussianBlur, radius);
             }
         }
     }